@@ -6,6 +6,19 @@ list(APPEND CMAKE_MODULE_PATH "${CMAKE_CURRENT_LIST_DIR}/cmake")
 find_package(Boost 1.70.0 QUIET REQUIRED date_time log program_options system thread)
 find_package(OpenSSL REQUIRED)
 find_package(Protobuf REQUIRED)
+find_package(ZLIB REQUIRED)
+
+# brotli is optional, responses are negotiated down to gzip/deflate without it.
+find_path(BROTLI_INCLUDE_DIR brotli/decode.h)
+find_library(BROTLI_DEC_LIBRARY NAMES brotlidec)
+
+set(AIRMAP_COMPRESSION_LIBRARIES ZLIB::ZLIB)
+
+if (BROTLI_INCLUDE_DIR AND BROTLI_DEC_LIBRARY)
+  message(STATUS "Found brotli: ${BROTLI_DEC_LIBRARY}")
+  add_definitions(-DAIRMAP_ENABLE_BROTLI)
+  set(AIRMAP_COMPRESSION_LIBRARIES ${AIRMAP_COMPRESSION_LIBRARIES} ${BROTLI_DEC_LIBRARY})
+endif ()
 
 find_library(
   WE_NEED_BORINGSSLS_LIB_DECREPIT
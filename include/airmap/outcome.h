@@ -16,6 +16,7 @@
 #include <airmap/visibility.h>
 
 #include <type_traits>
+#include <utility>
 
 namespace airmap {
 
@@ -37,6 +38,11 @@ class AIRMAP_EXPORT Outcome {
     new (&data.value) Value{value};
   }
 
+  /// Outcome initializes a new instance with value, moving it in.
+  explicit Outcome(Value&& value) : type{Type::value} {
+    new (&data.value) Value{std::move(value)};
+  }
+
   /// Outcome initializes a new instance with error.
   explicit Outcome(const Error& error) : type{Type::error} {
     new (&data.error) Error{error};
@@ -58,10 +64,10 @@ class AIRMAP_EXPORT Outcome {
   Outcome(Outcome&& other) : type{other.type} {
     switch (type) {
       case Type::error:
-        new (&data.error) Error{other.data.error};
+        new (&data.error) Error{std::move(other.data.error)};
         break;
       case Type::value:
-        new (&data.value) Value{other.data.value};
+        new (&data.value) Value{std::move(other.data.value)};
         break;
     }
   }
@@ -83,11 +89,11 @@ class AIRMAP_EXPORT Outcome {
 
     switch (type) {
       case Type::error: {
-        new (&data.error) Error{other.data.error};
+        new (&data.error) Error{std::move(other.data.error)};
         break;
       }
       case Type::value: {
-        new (&data.value) Value{other.data.value};
+        new (&data.value) Value{std::move(other.data.value)};
         break;
       }
     }
@@ -112,11 +118,11 @@ class AIRMAP_EXPORT Outcome {
 
     switch (type) {
       case Type::error: {
-        new (&data.error) Error{other.data.error};
+        new (&data.error) Error{std::move(other.data.error)};
         break;
       }
       case Type::value: {
-        new (&data.value) Value{other.data.value};
+        new (&data.value) Value{std::move(other.data.value)};
         break;
       }
     }
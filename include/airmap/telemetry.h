@@ -18,8 +18,10 @@
 #include <airmap/visibility.h>
 
 #include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace airmap {
 
@@ -119,6 +121,18 @@ class AIRMAP_EXPORT Telemetry : DoNotCopyOrMove {
   virtual void submit_updates(const Flight& flight, const std::string& key,
                               const std::initializer_list<Update>& updates) = 0;
 
+  /// submit_updates sends the telemetry data in 'updates' associated to 'flight' to the AirMap
+  /// services. Implementations may pack all of 'updates' into a single packet.
+  ///
+  /// The default implementation submits every update on its own, in a packet of its own.
+  virtual void submit_updates(const Flight& flight, const std::string& key, const std::vector<Update>& updates);
+
+  /// end_session releases all state kept for submitting telemetry associated to 'flight',
+  /// e.g., once the vehicle flying 'flight' went away.
+  ///
+  /// The default implementation does not keep any state and does nothing.
+  virtual void end_session(const Flight& flight);
+
  protected:
   /// @cond
   Telemetry() = default;
@@ -13,9 +13,13 @@
 #include <airmap/boost/context.h>
 
 #include <airmap/net/http/boost/requester.h>
+#include <airmap/net/http/caching_requester.h>
+#include <airmap/net/http/coalescing_requester.h>
+#include <airmap/net/http/retrying_requester.h>
 #include <airmap/net/mqtt/boost/broker.h>
 #include <airmap/net/udp/boost/sender.h>
 
+#include <airmap/paths.h>
 #include <airmap/rest/client.h>
 
 #include <boost/lexical_cast.hpp>
@@ -35,6 +39,28 @@ std::string get(const char* name, const std::string& default_value) {
 }
 
 }  // namespace env
+
+const char* to_string(airmap::net::http::boost::ConnectionPool::Priority priority) {
+  switch (priority) {
+    case airmap::net::http::boost::ConnectionPool::Priority::high:
+      return "high";
+    case airmap::net::http::boost::ConnectionPool::Priority::normal:
+      return "normal";
+    case airmap::net::http::boost::ConnectionPool::Priority::low:
+      return "low";
+  }
+
+  return "unknown";
+}
+
+// retry_configuration returns the retry policy of requesters, hedging get requests if 'hedge' is true.
+// Hedging adds load on the servers and is off by default, setting AIRMAP_HTTP_HEDGING to "on" switches it on.
+airmap::net::http::RetryingRequester::Configuration retry_configuration(bool hedge) {
+  airmap::net::http::RetryingRequester::Configuration configuration;
+  configuration.hedge = hedge && env::get("AIRMAP_HTTP_HEDGING", "off") == "on";
+  return configuration;
+}
+
 }  // namespace
 
 std::shared_ptr<airmap::boost::Context> airmap::boost::Context::create(
@@ -49,6 +75,7 @@ airmap::boost::Context::Context(
     : log_{logger},
       io_service_{std::make_shared<::boost::asio::io_service>()},
       keep_alive_{std::make_shared<::boost::asio::io_service::work>(*io_service_)},
+      resolver_cache_{net::dns::ResolverCache::create(net::dns::ResolverCache::Configuration{}, io_service_)},
       schedule_out_(schedule_out),
       state_{State::stopped},
       return_code_{Context::ReturnCode::success} {
@@ -61,12 +88,17 @@ const std::shared_ptr<::boost::asio::io_service>& airmap::boost::Context::io_ser
   return io_service_;
 }
 
+const std::shared_ptr<airmap::net::dns::ResolverCache>& airmap::boost::Context::resolver_cache() const {
+  return resolver_cache_;
+}
+
 // From airmap::Context
 void airmap::boost::Context::create_client_with_configuration(const Client::Configuration& configuration,
                                                               const ClientCreateCallback& cb) {
   auto sp = shared_from_this();
   auto udp_sender =
-      net::udp::boost::Sender::create(configuration.telemetry.host, configuration.telemetry.port, io_service_);
+      net::udp::boost::Sender::create(configuration.telemetry.host, configuration.telemetry.port, io_service_,
+                                      resolver_cache_);
 
   rest::Client::Requesters requesters;
   requesters.advisory      = advisory(configuration);
@@ -81,7 +113,7 @@ void airmap::boost::Context::create_client_with_configuration(const Client::Conf
   requesters.sso           = sso(configuration);
 
   auto mqtt_broker = std::make_shared<net::mqtt::boost::Broker>(configuration.traffic.host, configuration.traffic.port,
-                                                                log_.logger(), io_service_);
+                                                                log_.logger(), io_service_, resolver_cache_);
   cb(ClientCreateResult{std::make_shared<rest::Client>(configuration, sp, udp_sender, requesters, mqtt_broker)});
 }
 
@@ -121,6 +153,8 @@ airmap::Context::ReturnCode airmap::boost::Context::run() {
     }
   }
 
+  log_connection_pool_statistics();
+
   state_.store(State::stopped);
   return return_code_.load();
 }
@@ -237,18 +271,72 @@ void SchedulingRequester::post(const std::string& path, std::unordered_map<std::
 }
 
 
+std::unordered_map<std::string, std::shared_ptr<airmap::net::http::boost::ConnectionPool>>
+airmap::boost::Context::connection_pools() {
+  std::lock_guard<std::mutex> lg{connection_pools_guard_};
+  return connection_pools_;
+}
+
+void airmap::boost::Context::log_connection_pool_statistics() {
+  for (const auto& pair : connection_pools()) {
+    for (const auto& statistics : pair.second->statistics()) {
+      const auto& wait_times = statistics.wait_times;
+      if (wait_times.total() == 0)
+        continue;
+
+      log_.debugf(component, "connection pool %s: handed out %d connections at %s priority, waiting %d [us] on average",
+                  pair.first, wait_times.total(), to_string(statistics.priority),
+                  wait_times.sum() / wait_times.total());
+    }
+  }
+}
+
+std::shared_ptr<airmap::net::http::boost::ConnectionPool> airmap::boost::Context::connection_pool_for(
+    const std::string& protocol, const std::string& host, std::uint16_t port) {
+  auto key = protocol + "://" + host + ":" + std::to_string(port);
+
+  std::lock_guard<std::mutex> lg{connection_pools_guard_};
+  auto it = connection_pools_.find(key);
+  if (it == connection_pools_.end()) {
+    auto factory = net::http::boost::Requester::connection_factory_for_protocol(protocol, host, io_service_);
+    auto pool    = net::http::boost::ConnectionPool::create(net::http::boost::ConnectionPool::Configuration{},
+                                                         io_service_, factory);
+    it           = connection_pools_.emplace(key, pool).first;
+  }
+
+  return it->second;
+}
+
+std::shared_ptr<airmap::net::http::ResponseCache> airmap::boost::Context::response_cache_for(
+    const airmap::Client::Configuration& configuration) {
+  std::lock_guard<std::mutex> lg{response_caches_guard_};
+  auto it = response_caches_.find(configuration.version);
+  if (it == response_caches_.end()) {
+    // AIRMAP_HTTP_CACHE selects between caching in 'memory' only and persisting to 'disk', too.
+    net::http::ResponseCache::Configuration cc;
+    if (env::get("AIRMAP_HTTP_CACHE", "memory") == "disk")
+      cc.directory = paths::cache_dir(configuration.version) / "http";
+    it = response_caches_.emplace(configuration.version, net::http::ResponseCache::create(cc)).first;
+  }
+
+  return it->second;
+}
+
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::advisory(
     const airmap::Client::Configuration& configuration) {
   auto protocol = env::get("AIRMAP_PROTOCOL_ADVISORY", "https");
   auto host     = env::get("AIRMAP_HOST_ADVISORY", configuration.host);
   auto port     = env::get("AIRMAP_PORT_ADVISORY", ::boost::lexical_cast<std::string>(443));
   auto route    = env::get("AIRMAP_ROUTE_ADVISORY", rest::Advisory::default_route_for_version(configuration.version));
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::low;
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
       route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+        log_.logger(), net::http::RetryingRequester::create(
+          retry_configuration(true), shared_from_this(), net::http::boost::Requester::create(
+            host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+            connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::aircrafts(
@@ -259,10 +347,14 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::aircrafts(
   auto route    = env::get("AIRMAP_ROUTE_AIRCRAFTS", rest::Aircrafts::default_route_for_version(configuration.version));
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
-      route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+      route, std::make_shared<net::http::CoalescingRequester>(std::make_shared<net::http::CachingRequester>(
+        protocol + "://" + host + ":" + port, Microseconds{hours(24)}, Microseconds{hours(24)},
+        response_cache_for(configuration),
+        std::make_shared<net::http::LoggingRequester>(
+          log_.logger(), net::http::RetryingRequester::create(
+            retry_configuration(true), shared_from_this(), net::http::boost::Requester::create(
+              host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+              connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)))))))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::airspaces(
@@ -271,12 +363,18 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::airspaces(
   auto host     = env::get("AIRMAP_HOST_AIRSPACES", configuration.host);
   auto port     = env::get("AIRMAP_PORT_AIRSPACES", ::boost::lexical_cast<std::string>(443));
   auto route    = env::get("AIRMAP_ROUTE_AIRSPACES", rest::Airspaces::default_route_for_version(configuration.version));
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::low;
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
-      route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+      route, std::make_shared<net::http::CoalescingRequester>(std::make_shared<net::http::CachingRequester>(
+        protocol + "://" + host + ":" + port, Microseconds{minutes(5)}, Microseconds{hours(1)},
+        response_cache_for(configuration),
+        std::make_shared<net::http::LoggingRequester>(
+          log_.logger(), net::http::RetryingRequester::create(
+            retry_configuration(true), shared_from_this(), net::http::boost::Requester::create(
+              host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+              connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::authenticator(
@@ -286,12 +384,15 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::authentica
   auto port     = env::get("AIRMAP_PORT_AUTHENTICATOR", ::boost::lexical_cast<std::string>(443));
   auto route =
       env::get("AIRMAP_ROUTE_AUTHENTICATOR", rest::Authenticator::default_route_for_version(configuration.version));
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::high;
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
       route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-           host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-            net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+        log_.logger(), net::http::RetryingRequester::create(
+          retry_configuration(false), shared_from_this(), net::http::boost::Requester::create(
+             host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+             connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::flights(
@@ -300,12 +401,15 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::flights(
   auto host     = env::get("AIRMAP_HOST_FLIGHTS", configuration.host);
   auto port     = env::get("AIRMAP_PORT_FLIGHTS", ::boost::lexical_cast<std::string>(443));
   auto route    = env::get("AIRMAP_ROUTE_FLIGHTS", rest::Flights::default_route_for_version(configuration.version));
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::high;
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
       route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+        log_.logger(), net::http::RetryingRequester::create(
+          retry_configuration(false), shared_from_this(), net::http::boost::Requester::create(
+            host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+            connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::flight_plans(
@@ -314,12 +418,17 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::flight_pla
   auto host     = env::get("AIRMAP_HOST_FLIGHTS", configuration.host);
   auto port     = env::get("AIRMAP_PORT_FLIGHTS", ::boost::lexical_cast<std::string>(443));
   auto route    = env::get("AIRMAP_ROUTE_FLIGHTS", rest::FlightPlans::default_route_for_version(configuration.version));
+  // Flight plans carry potentially large geometries, we optionally send them compressed.
+  net::http::boost::Requester::Options options;
+  options.priority                 = net::http::boost::ConnectionPool::Priority::high;
+  options.body_compression.enabled = env::get("AIRMAP_COMPRESS_REQUESTS_FLIGHTS", "false") == "true";
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
       route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+        log_.logger(), net::http::RetryingRequester::create(
+          retry_configuration(false), shared_from_this(), net::http::boost::Requester::create(
+            host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+            connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::pilots(
@@ -331,9 +440,10 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::pilots(
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
       route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+        log_.logger(), net::http::RetryingRequester::create(
+          retry_configuration(false), shared_from_this(), net::http::boost::Requester::create(
+            host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+            connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)))))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::rulesets(
@@ -342,12 +452,18 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::rulesets(
   auto host     = env::get("AIRMAP_HOST_RULESETS", configuration.host);
   auto port     = env::get("AIRMAP_PORT_RULESETS", ::boost::lexical_cast<std::string>(443));
   auto route    = env::get("AIRMAP_ROUTE_RULESETS", rest::RuleSets::default_route_for_version(configuration.version));
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::low;
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
-      route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+      route, std::make_shared<net::http::CoalescingRequester>(std::make_shared<net::http::CachingRequester>(
+        protocol + "://" + host + ":" + port, Microseconds{hours(1)}, Microseconds{hours(24)},
+        response_cache_for(configuration),
+        std::make_shared<net::http::LoggingRequester>(
+          log_.logger(), net::http::RetryingRequester::create(
+            retry_configuration(true), shared_from_this(), net::http::boost::Requester::create(
+              host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+              connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options)))))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::status(
@@ -358,10 +474,14 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::status(
   auto route    = env::get("AIRMAP_ROUTE_STATUS", rest::Status::default_route_for_version(configuration.version));
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::RoutingRequester>(
-      route, std::make_shared<net::http::LoggingRequester>(
-        log_.logger(), net::http::boost::Requester::create(
-          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-          net::http::boost::Requester::request_factory_for_protocol(protocol)))));
+      route, std::make_shared<net::http::CoalescingRequester>(std::make_shared<net::http::CachingRequester>(
+        protocol + "://" + host + ":" + port, Microseconds{minutes(1)}, Microseconds{minutes(10)},
+        response_cache_for(configuration),
+        std::make_shared<net::http::LoggingRequester>(
+          log_.logger(), net::http::RetryingRequester::create(
+            retry_configuration(true), shared_from_this(), net::http::boost::Requester::create(
+              host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+              connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)))))))));
 }
 
 std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::sso(
@@ -370,12 +490,17 @@ std::shared_ptr<airmap::net::http::Requester> airmap::boost::Context::sso(
   auto host     = env::get("AIRMAP_HOST_SSO", configuration.sso.host);
   auto port     = env::get("AIRMAP_PORT_SSO", ::boost::lexical_cast<std::string>(configuration.sso.port));
 
+  net::http::boost::Requester::Options options;
+  options.priority = net::http::boost::ConnectionPool::Priority::high;
+
   return std::make_shared<SchedulingRequester>(
     shared_from_this(), std::make_shared<net::http::LoggingRequester>(
       log_.logger(),
-      net::http::boost::Requester::create(
-        host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_,
-        net::http::boost::Requester::request_factory_for_protocol(protocol))));
+      net::http::RetryingRequester::create(
+        retry_configuration(false), shared_from_this(),
+        net::http::boost::Requester::create(
+          host, ::boost::lexical_cast<std::uint16_t>(port), log_.logger(), io_service_, resolver_cache_,
+          connection_pool_for(protocol, host, ::boost::lexical_cast<std::uint16_t>(port)), options))));
 }
 
 #if defined(AIRMAP_ENABLE_GRPC)
@@ -14,6 +14,9 @@
 #define AIRMAP_BOOST_CONTEXT_H_
 
 #include <airmap/context.h>
+#include <airmap/net/dns/resolver_cache.h>
+#include <airmap/net/http/boost/connection_pool.h>
+#include <airmap/net/http/response_cache.h>
 #include <airmap/rest/client.h>
 #include <airmap/util/formatting_logger.h>
 
@@ -21,8 +24,11 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace airmap {
@@ -39,6 +45,14 @@ class Context : public airmap::Context, public std::enable_shared_from_this<Cont
   // the component can integrate easily.
   const std::shared_ptr<::boost::asio::io_service>& io_service() const;
 
+  // Enable access to the resolver cache shared by all network stacks
+  // running on the io_service.
+  const std::shared_ptr<net::dns::ResolverCache>& resolver_cache() const;
+
+  // Enable access to the pools of connections to all hosts, keyed by
+  // protocol://host:port, e.g., to inspect their queues and wait times.
+  std::unordered_map<std::string, std::shared_ptr<net::http::boost::ConnectionPool>> connection_pools();
+
   // From airmap::Context
   void create_client_with_configuration(const Client::Configuration& configuration,
                                         const ClientCreateCallback& cb) override;
@@ -55,6 +69,18 @@ class Context : public airmap::Context, public std::enable_shared_from_this<Cont
   enum class State { stopped, stopping, running };
   explicit Context(const std::shared_ptr<Logger>& logger, const Context::Scheduler::shared_ptr& schedule_out);
 
+  // log_connection_pool_statistics logs how long requests waited for connections, per host and priority.
+  void log_connection_pool_statistics();
+
+  // connection_pool_for returns the pool of connections to 'host':'port', shared
+  // by all requesters talking to the same host with the same 'protocol'.
+  std::shared_ptr<net::http::boost::ConnectionPool> connection_pool_for(const std::string& protocol,
+                                                                       const std::string& host, std::uint16_t port);
+
+  // response_cache_for returns the cache of responses to read-only requests, shared by
+  // all requesters talking to the services of 'configuration.version'.
+  std::shared_ptr<net::http::ResponseCache> response_cache_for(const airmap::Client::Configuration& configuration);
+
   std::shared_ptr<net::http::Requester> advisory(const airmap::Client::Configuration& configuration);
   std::shared_ptr<net::http::Requester> aircrafts(const airmap::Client::Configuration& configuration);
   std::shared_ptr<net::http::Requester> airspaces(const airmap::Client::Configuration& configuration);
@@ -70,9 +96,14 @@ class Context : public airmap::Context, public std::enable_shared_from_this<Cont
 
   std::shared_ptr<::boost::asio::io_service> io_service_;
   std::shared_ptr<::boost::asio::io_service::work> keep_alive_;
+  std::shared_ptr<net::dns::ResolverCache> resolver_cache_;
   std::shared_ptr<Context::Scheduler> schedule_out_;
   std::atomic<State> state_;
   std::atomic<ReturnCode> return_code_;
+  std::mutex connection_pools_guard_;
+  std::unordered_map<std::string, std::shared_ptr<net::http::boost::ConnectionPool>> connection_pools_;
+  std::mutex response_caches_guard_;
+  std::map<airmap::Client::Version, std::shared_ptr<net::http::ResponseCache>> response_caches_;
 };
 
 }  // namespace boost
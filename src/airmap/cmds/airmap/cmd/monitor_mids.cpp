@@ -38,7 +38,7 @@ cmd::MonitorMids::MonitorMids()
     : cli::CommandWithFlagsAndAction{"monitor-mids", "monitors traffic visible to mids",
                                      "monitors traffic visible to mids"} {
   flag(flags::log_level(params_.log_level));
-  flag(cli::make_flag("mids", "comma-separated list of mids", params_.mids));
+  flag(cli::make_flag("mids", "comma-separated list of mids, defaults to all mids", params_.mids));
   flag(cli::make_flag("mqtt-host", "host address of the mqtt broker", params_.mqtt.host));
   flag(cli::make_flag("mqtt-port", "port of the mqtt broker", params_.mqtt.port));
   flag(cli::make_flag("mqtt-username", "username for accessing the mqtt broker", params_.mqtt.username));
@@ -74,20 +74,17 @@ cmd::MonitorMids::MonitorMids()
                "  mqtt.port:     %d\n"
                "  mqtt.username: %s\n"
                "  mqtt.password: %s",
-               params_.mids.get(), params_.mqtt.host.get(), params_.mqtt.port.get(), params_.mqtt.username.get(),
-               params_.mqtt.password.get());
+               params_.mids ? params_.mids.get().string() : std::string{"all"}, params_.mqtt.host.get(),
+               params_.mqtt.port.get(), params_.mqtt.username.get(), params_.mqtt.password.get());
 
     auto bc  = boost::Context::create(log_.logger());
     context_ = bc;
     broker_  = std::make_shared<net::mqtt::boost::Broker>(params_.mqtt.host.get(), params_.mqtt.port.get(),
-                                                         log_.logger(), bc->io_service());
+                                                         log_.logger(), bc->io_service(), bc->resolver_cache());
     broker_->connect({params_.mqtt.username.get(), params_.mqtt.password.get()}, [this](const auto& result) {
       if (result) {
         client_ = result.value();
 
-        std::vector<std::string> mids;
-        ::boost::algorithm::split(mids, params_.mids.get().string(), ::boost::algorithm::is_any_of(","));
-
         auto handler = [this](const std::string& topic, const std::string& message) {
           // TODO(tvoss): We should not have to identify the scope by interpreting the topic name here.
           // Ideally, the update would give us all information required for classification and further processing.
@@ -112,10 +109,18 @@ cmd::MonitorMids::MonitorMids()
           }
         };
 
+        if (!params_.mids) {
+          // Without a list of mids, we monitor all of them with a single subscription.
+          subscriptions_.insert(client_->subscribe("+/telemetry/position/+", net::mqtt::QualityOfService::exactly_once,
+                                                   handler));
+          return;
+        }
+
+        std::vector<std::string> mids;
+        ::boost::algorithm::split(mids, params_.mids.get().string(), ::boost::algorithm::is_any_of(","));
+
         for (const auto& mid : mids) {
-          subscriptions_.insert(client_->subscribe(fmt::sprintf("mav/telemetry/position/%s", mid),
-                                                   net::mqtt::QualityOfService::exactly_once, handler));
-          subscriptions_.insert(client_->subscribe(fmt::sprintf("uav/telemetry/position/%s", mid),
+          subscriptions_.insert(client_->subscribe(fmt::sprintf("+/telemetry/position/%s", mid),
                                                    net::mqtt::QualityOfService::exactly_once, handler));
         }
       } else {
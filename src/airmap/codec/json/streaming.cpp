@@ -0,0 +1,133 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/codec/json/streaming.h>
+
+#include <airmap/codec.h>
+#include <airmap/codec/json/airspace.h>
+#include <airmap/codec/json/ruleset.h>
+#include <airmap/codec/json/status.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Successful JSEND responses carry their payload in this member.
+constexpr const char* data{"data"};
+
+}  // namespace
+
+void airmap::codec::json::ArrayStreamer::stream(const Path& path, const Sink& sink) {
+  sinks_.emplace_back(path, sink);
+}
+
+nlohmann::json airmap::codec::json::ArrayStreamer::parse(const std::string& document) {
+  if (sinks_.empty())
+    return nlohmann::json::parse(document);
+
+  path_.clear();
+  active_.clear();
+
+  return nlohmann::json::parse(document.begin(), document.end(),
+                               [this](int depth, nlohmann::json::parse_event_t event, nlohmann::json& parsed) {
+                                 return handle(depth, event, parsed);
+                               });
+}
+
+bool airmap::codec::json::ArrayStreamer::handle(int depth, nlohmann::json::parse_event_t event,
+                                                nlohmann::json& parsed) {
+  using Event = nlohmann::json::parse_event_t;
+
+  // A streamed element is complete: hand it to the sink and drop it from the document.
+  if (!active_.empty() && depth == active_.back().depth + 1 &&
+      (event == Event::object_end || event == Event::array_end || event == Event::value)) {
+    (*active_.back().sink)(parsed);
+    return false;
+  }
+
+  switch (event) {
+    case Event::key:
+      // Keys are reported at the depth of the members of the enclosing object.
+      path_.resize(depth);
+      path_.back() = parsed.get<std::string>();
+      break;
+    case Event::array_start:
+      // Arrays nested in streamed elements are decoded as part of their element.
+      if (active_.empty() && static_cast<int>(path_.size()) >= depth) {
+        for (const auto& pair : sinks_) {
+          if (static_cast<int>(pair.first.size()) == depth &&
+              std::equal(pair.first.begin(), pair.first.end(), path_.begin())) {
+            active_.push_back(Active{depth, &pair.second});
+            break;
+          }
+        }
+      }
+      break;
+    case Event::array_end:
+      if (!active_.empty() && active_.back().depth == depth)
+        active_.pop_back();
+      break;
+    default:
+      break;
+  }
+
+  return true;
+}
+
+void airmap::codec::json::Streaming<std::vector<airmap::Airspace>>::prepare(ArrayStreamer& streamer) {
+  auto sink = [this](const nlohmann::json& element) {
+    airspaces_.push_back(Airspace{});
+    decode(element, airspaces_.back());
+  };
+
+  streamer.stream(ArrayStreamer::Path{}, sink);
+  streamer.stream(ArrayStreamer::Path{data}, sink);
+}
+
+void airmap::codec::json::Streaming<std::vector<airmap::Airspace>>::complete(std::vector<Airspace>& airspaces) {
+  airspaces.insert(airspaces.end(), std::make_move_iterator(airspaces_.begin()),
+                   std::make_move_iterator(airspaces_.end()));
+  airspaces_.clear();
+}
+
+void airmap::codec::json::Streaming<std::vector<airmap::RuleSet>>::prepare(ArrayStreamer& streamer) {
+  auto sink = [this](const nlohmann::json& element) {
+    rulesets_.push_back(RuleSet{});
+    decode(element, rulesets_.back());
+  };
+
+  streamer.stream(ArrayStreamer::Path{}, sink);
+  streamer.stream(ArrayStreamer::Path{data}, sink);
+}
+
+void airmap::codec::json::Streaming<std::vector<airmap::RuleSet>>::complete(std::vector<RuleSet>& rulesets) {
+  rulesets.insert(rulesets.end(), std::make_move_iterator(rulesets_.begin()),
+                  std::make_move_iterator(rulesets_.end()));
+  rulesets_.clear();
+}
+
+void airmap::codec::json::Streaming<airmap::FlightPlan::Briefing>::prepare(ArrayStreamer& streamer) {
+  auto sink = [this](const nlohmann::json& element) {
+    advisories_.push_back(Status::Advisory{});
+    decode(element, advisories_.back());
+  };
+
+  streamer.stream(ArrayStreamer::Path{"airspace", "advisories"}, sink);
+  streamer.stream(ArrayStreamer::Path{data, "airspace", "advisories"}, sink);
+}
+
+void airmap::codec::json::Streaming<airmap::FlightPlan::Briefing>::complete(FlightPlan::Briefing& briefing) {
+  briefing.airspace.advisories.insert(briefing.airspace.advisories.end(), std::make_move_iterator(advisories_.begin()),
+                                      std::make_move_iterator(advisories_.end()));
+  advisories_.clear();
+}
@@ -0,0 +1,117 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_CODEC_JSON_STREAMING_H_
+#define AIRMAP_CODEC_JSON_STREAMING_H_
+
+#include <airmap/airspace.h>
+#include <airmap/flight_plan.h>
+#include <airmap/ruleset.h>
+#include <airmap/status.h>
+
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace airmap {
+namespace codec {
+namespace json {
+
+/// ArrayStreamer parses JSON documents, handing the elements of selected
+/// arrays to sinks as soon as they have been parsed. Streamed elements are
+/// discarded right after, such that the DOM of a large array never exists
+/// in full. The returned document contains the streamed arrays, empty.
+class ArrayStreamer {
+ public:
+  /// Path is the sequence of object keys leading from the root of a document to an array.
+  /// The empty path refers to a top-level array.
+  using Path = std::vector<std::string>;
+  /// Sink is invoked with every element of a streamed array, in order.
+  using Sink = std::function<void(const nlohmann::json& element)>;
+
+  /// stream registers 'sink' for the elements of the array found at 'path'.
+  void stream(const Path& path, const Sink& sink);
+
+  /// parse parses 'document', throwing on syntax errors and
+  /// passing on exceptions thrown by sinks.
+  nlohmann::json parse(const std::string& document);
+
+ private:
+  // Active describes an array being streamed.
+  struct Active {
+    int depth;
+    const Sink* sink;
+  };
+
+  bool handle(int depth, nlohmann::json::parse_event_t event, nlohmann::json& parsed);
+
+  std::vector<std::pair<Path, Sink>> sinks_;
+  Path path_;
+  std::vector<Active> active_;
+};
+
+/// Streaming<T> decides which arrays of a document carrying a T are streamed.
+///
+/// prepare registers sinks with an ArrayStreamer before a document is
+/// parsed, complete appends the streamed elements to the T decoded from
+/// the remainder of the document. By default, nothing is streamed.
+template <typename T>
+class Streaming {
+ public:
+  void prepare(ArrayStreamer&) {
+  }
+
+  void complete(T&) {
+  }
+};
+
+/// Streaming<std::vector<Airspace>> streams the airspaces returned by searches.
+template <>
+class Streaming<std::vector<Airspace>> {
+ public:
+  void prepare(ArrayStreamer& streamer);
+  void complete(std::vector<Airspace>& airspaces);
+
+ private:
+  std::vector<Airspace> airspaces_;
+};
+
+/// Streaming<std::vector<RuleSet>> streams the rulesets returned by searches.
+template <>
+class Streaming<std::vector<RuleSet>> {
+ public:
+  void prepare(ArrayStreamer& streamer);
+  void complete(std::vector<RuleSet>& rulesets);
+
+ private:
+  std::vector<RuleSet> rulesets_;
+};
+
+/// Streaming<FlightPlan::Briefing> streams the advisories of a briefing.
+template <>
+class Streaming<FlightPlan::Briefing> {
+ public:
+  void prepare(ArrayStreamer& streamer);
+  void complete(FlightPlan::Briefing& briefing);
+
+ private:
+  std::vector<Status::Advisory> advisories_;
+};
+
+}  // namespace json
+}  // namespace codec
+}  // namespace airmap
+
+#endif  // AIRMAP_CODEC_JSON_STREAMING_H_
@@ -15,6 +15,371 @@
 #include <airmap/codec.h>
 #include <airmap/codec/json/get.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+// Scanner walks the characters of a json document, without building up a DOM.
+class Scanner {
+ public:
+  explicit Scanner(const std::string& document) : it_{document.data()}, end_{document.data() + document.size()} {
+  }
+
+  // consume skips whitespace and consumes 'c' if it is the next character.
+  bool consume(char c) {
+    skip_whitespace();
+    if (it_ != end_ && *it_ == c) {
+      ++it_;
+      return true;
+    }
+    return false;
+  }
+
+  // expect consumes 'c', throwing if it is not the next character.
+  void expect(char c) {
+    if (!consume(c))
+      fail(std::string{"expected '"} + c + "'");
+  }
+
+  // peek returns the next character after whitespace.
+  char peek() {
+    skip_whitespace();
+    if (it_ == end_)
+      fail("unexpected end of document");
+    return *it_;
+  }
+
+  // string consumes a string, returning its contents. Contents without
+  // escapes are returned in place, others are unescaped into 'scratch'.
+  std::string_view string(std::string& scratch) {
+    expect('"');
+
+    auto begin = it_;
+    while (it_ != end_ && *it_ != '"' && *it_ != '\\')
+      ++it_;
+
+    if (it_ == end_)
+      fail("unterminated string");
+    if (*it_ == '"')
+      return std::string_view(begin, static_cast<std::size_t>(it_++ - begin));
+
+    scratch.assign(begin, it_);
+    while (it_ != end_ && *it_ != '"') {
+      if (*it_ != '\\') {
+        scratch.push_back(*it_++);
+        continue;
+      }
+
+      if (++it_ == end_)
+        fail("unterminated string");
+
+      switch (*it_++) {
+        case '"':
+          scratch.push_back('"');
+          break;
+        case '\\':
+          scratch.push_back('\\');
+          break;
+        case '/':
+          scratch.push_back('/');
+          break;
+        case 'b':
+          scratch.push_back('\b');
+          break;
+        case 'f':
+          scratch.push_back('\f');
+          break;
+        case 'n':
+          scratch.push_back('\n');
+          break;
+        case 'r':
+          scratch.push_back('\r');
+          break;
+        case 't':
+          scratch.push_back('\t');
+          break;
+        case 'u':
+          unicode(scratch);
+          break;
+        default:
+          fail("invalid escape sequence");
+      }
+    }
+
+    if (it_ == end_)
+      fail("unterminated string");
+    ++it_;
+
+    return scratch;
+  }
+
+  // scalar consumes a number or a string, returning its raw text.
+  std::string_view scalar(std::string& scratch) {
+    if (peek() == '"')
+      return string(scratch);
+
+    auto begin = it_;
+    while (it_ != end_ && (std::isdigit(static_cast<unsigned char>(*it_)) || *it_ == '-' || *it_ == '+' ||
+                           *it_ == '.' || *it_ == 'e' || *it_ == 'E'))
+      ++it_;
+
+    if (it_ == begin)
+      fail("expected number or string");
+
+    return std::string_view(begin, static_cast<std::size_t>(it_ - begin));
+  }
+
+  // skip consumes an arbitrary value.
+  void skip(std::string& scratch) {
+    switch (peek()) {
+      case '{':
+        ++it_;
+        if (consume('}'))
+          return;
+        do {
+          string(scratch);
+          expect(':');
+          skip(scratch);
+        } while (consume(','));
+        expect('}');
+        return;
+      case '[':
+        ++it_;
+        if (consume(']'))
+          return;
+        do {
+          skip(scratch);
+        } while (consume(','));
+        expect(']');
+        return;
+      case '"':
+        string(scratch);
+        return;
+      case 't':
+        literal("true");
+        return;
+      case 'f':
+        literal("false");
+        return;
+      case 'n':
+        literal("null");
+        return;
+      default:
+        scalar(scratch);
+        return;
+    }
+  }
+
+  // null consumes a null literal if it is the next value.
+  bool null() {
+    if (peek() != 'n')
+      return false;
+    literal("null");
+    return true;
+  }
+
+  // done throws if anything but whitespace is left in the document.
+  void done() {
+    skip_whitespace();
+    if (it_ != end_)
+      fail("unexpected trailing characters");
+  }
+
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::runtime_error{"failed to decode traffic payload: " + what};
+  }
+
+ private:
+  void skip_whitespace() {
+    while (it_ != end_ && (*it_ == ' ' || *it_ == '\n' || *it_ == '\r' || *it_ == '\t'))
+      ++it_;
+  }
+
+  void literal(std::string_view literal) {
+    if (static_cast<std::size_t>(end_ - it_) < literal.size() || std::string_view(it_, literal.size()) != literal)
+      fail("invalid literal");
+    it_ += literal.size();
+  }
+
+  std::uint32_t hex4() {
+    if (end_ - it_ < 4)
+      fail("invalid unicode escape");
+
+    std::uint32_t result{0};
+    auto r = std::from_chars(it_, it_ + 4, result, 16);
+    if (r.ptr != it_ + 4)
+      fail("invalid unicode escape");
+    it_ += 4;
+
+    return result;
+  }
+
+  // unicode appends the code point of a \u escape to 'out', encoded in UTF-8.
+  void unicode(std::string& out) {
+    auto cp = hex4();
+
+    if (cp >= 0xd800 && cp <= 0xdbff) {
+      if (end_ - it_ < 2 || it_[0] != '\\' || it_[1] != 'u')
+        fail("invalid surrogate pair");
+      it_ += 2;
+      auto low = hex4();
+      if (low < 0xdc00 || low > 0xdfff)
+        fail("invalid surrogate pair");
+      cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+    }
+
+    if (cp < 0x80) {
+      out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+      out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else {
+      out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+  }
+
+  const char* it_;
+  const char* end_;
+};
+
+#if defined(__cpp_lib_to_chars)
+template <typename T>
+using ParsedByFromChars = std::is_arithmetic<T>;
+#else
+// Standard libraries without floating-point from_chars (e.g., libstdc++ before 11 and
+// the libc++ of older Android NDKs) only parse integers with it.
+template <typename T>
+using ParsedByFromChars = std::is_integral<T>;
+#endif  // __cpp_lib_to_chars
+
+// to_number converts all of 'text' to 'value', returning false and leaving
+// 'value' untouched if 'text' is not a valid number.
+template <typename T>
+typename std::enable_if<ParsedByFromChars<T>::value, bool>::type to_number(std::string_view text, T& value) {
+  T result{};
+  auto r = std::from_chars(text.data(), text.data() + text.size(), result);
+  if (r.ec != std::errc{} || r.ptr != text.data() + text.size())
+    return false;
+  value = result;
+  return true;
+}
+
+// to_number falls back to strtod for floating-point values. strtod needs a terminated
+// string and honors the decimal point of the current locale, so it is handed a bounded
+// copy of 'text' with '.' replaced accordingly. No valid coordinate or speed needs more digits.
+template <typename T>
+typename std::enable_if<!ParsedByFromChars<T>::value, bool>::type to_number(std::string_view text, T& value) {
+  char buffer[64];
+  // strtod also accepts leading whitespace, an explicit '+' and hexadecimal values, JSON does not.
+  if (text.empty() || text.size() >= sizeof(buffer) ||
+      (text.front() != '-' && !std::isdigit(static_cast<unsigned char>(text.front()))) ||
+      text.find_first_of("xX") != std::string_view::npos)
+    return false;
+
+  const char decimal_point = *std::localeconv()->decimal_point;
+  std::replace_copy(text.begin(), text.end(), buffer, '.', decimal_point);
+  buffer[text.size()] = '\0';
+
+  char* end   = nullptr;
+  errno       = 0;
+  auto result = std::strtod(buffer, &end);
+  if (errno == ERANGE || end != buffer + text.size())
+    return false;
+  value = static_cast<T>(result);
+  return true;
+}
+
+// decode_update decodes a single element of the traffic array into 'update', resetting all of its fields first.
+void decode_update(Scanner& scanner, airmap::Traffic::Update& update, std::string& key, std::string& value) {
+  update.id.clear();
+  update.aircraft_id.clear();
+  update.latitude     = 0;
+  update.longitude    = 0;
+  update.altitude     = 0;
+  update.ground_speed = 0;
+  update.heading      = 0;
+  update.direction    = 0;
+  update.timestamp    = airmap::DateTime{};
+
+  bool has_latitude{false}, has_longitude{false}, has_recorded{false};
+
+  scanner.expect('{');
+  if (!scanner.consume('}')) {
+    do {
+      auto name = scanner.string(key);
+      scanner.expect(':');
+
+      if (scanner.null())
+        continue;
+
+      // Latitude, longitude and the recorded time are mandatory, all other numeric values are best effort.
+      if (name == "id") {
+        update.id.assign(scanner.string(value));
+      } else if (name == "latitude") {
+        has_latitude = to_number(scanner.scalar(value), update.latitude);
+      } else if (name == "longitude") {
+        has_longitude = to_number(scanner.scalar(value), update.longitude);
+      } else if (name == "altitude") {
+        to_number(scanner.scalar(value), update.altitude);
+      } else if (name == "ground_speed_kts") {
+        to_number(scanner.scalar(value), update.ground_speed);
+      } else if (name == "true_heading") {
+        to_number(scanner.scalar(value), update.heading);
+      } else if (name == "direction") {
+        to_number(scanner.scalar(value), update.direction);
+      } else if (name == "recorded_time") {
+        std::int64_t ts{0};
+        has_recorded    = to_number(scanner.scalar(value), ts);
+        update.recorded = airmap::from_seconds_since_epoch(airmap::seconds(ts));
+      } else if (name == "timestamp") {
+        std::int64_t ts{0};
+        to_number(scanner.scalar(value), ts);
+        update.timestamp = airmap::from_milliseconds_since_epoch(airmap::milliseconds(ts));
+      } else if (name == "properties" && scanner.peek() == '{') {
+        scanner.expect('{');
+        if (!scanner.consume('}')) {
+          do {
+            auto property = scanner.string(key);
+            scanner.expect(':');
+            if (property == "aircraft_id" && !scanner.null())
+              update.aircraft_id.assign(scanner.string(value));
+            else
+              scanner.skip(value);
+          } while (scanner.consume(','));
+          scanner.expect('}');
+        }
+      } else {
+        scanner.skip(value);
+      }
+    } while (scanner.consume(','));
+    scanner.expect('}');
+  }
+
+  if (!has_latitude || !has_longitude || !has_recorded)
+    Scanner::fail("missing or invalid position or recorded time");
+
+  update.altitude *= 0.3048;
+  update.ground_speed *= 0.514444;
+}
+
+}  // namespace
+
 void airmap::codec::json::decode(const nlohmann::json& j, Traffic::Update& update) {
   get(update.id, j, "id");
   get(update.aircraft_id, j["properties"], "aircraft_id");
@@ -56,8 +421,52 @@ void airmap::codec::json::decode(const nlohmann::json& j, Traffic::Update& updat
 }
 
 void airmap::codec::json::decode(const nlohmann::json& j, std::vector<Traffic::Update>& v) {
-  for (auto element : j) {
+  v.reserve(v.size() + j.size());
+  for (const auto& element : j) {
     v.push_back(Traffic::Update{});
     v.back() = element;
   }
 }
+
+void airmap::codec::json::decode_traffic_payload(const std::string& payload, std::vector<Traffic::Update>& updates) {
+  // Keys and escaped strings are unescaped into these buffers, reused across the whole payload.
+  std::string key, value;
+  std::size_t count{0};
+  bool has_traffic{false};
+
+  Scanner scanner{payload};
+  scanner.expect('{');
+
+  if (!scanner.consume('}')) {
+    do {
+      auto name = scanner.string(key);
+      scanner.expect(':');
+
+      if (name != "traffic" || scanner.peek() != '[') {
+        scanner.skip(value);
+        continue;
+      }
+
+      has_traffic = true;
+      count       = 0;
+
+      scanner.expect('[');
+      if (!scanner.consume(']')) {
+        do {
+          if (count == updates.size())
+            updates.emplace_back();
+          decode_update(scanner, updates[count++], key, value);
+        } while (scanner.consume(','));
+        scanner.expect(']');
+      }
+    } while (scanner.consume(','));
+    scanner.expect('}');
+  }
+
+  scanner.done();
+
+  if (!has_traffic)
+    Scanner::fail("missing traffic");
+
+  updates.resize(count);
+}
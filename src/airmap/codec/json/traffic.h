@@ -17,6 +17,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include <string>
+#include <vector>
+
 namespace airmap {
 namespace codec {
 namespace json {
@@ -24,6 +27,16 @@ namespace json {
 void decode(const nlohmann::json& j, Traffic::Update& update);
 void decode(const nlohmann::json& j, std::vector<Traffic::Update>& v);
 
+/// decode_traffic_payload decodes the updates in the "traffic" array of the mqtt
+/// 'payload' into 'updates', yielding the same result as decoding the array with
+/// the functions above.
+///
+/// The payload is scanned directly instead of being parsed into a DOM, and numeric
+/// values are converted with std::from_chars. 'updates' is resized to the number
+/// of updates, reusing its elements and their storage. Throws std::runtime_error
+/// if 'payload' is malformed.
+void decode_traffic_payload(const std::string& payload, std::vector<Traffic::Update>& updates);
+
 }  // namespace json
 }  // namespace codec
 }  // namespace airmap
@@ -46,11 +46,9 @@ void airmap::grpc::server::Executor::run() {
 
   while (server_completion_queue_->Next(&tag, &ok)) {
     if (auto method_invocation = static_cast<MethodInvocation*>(tag)) {
-      context_->dispatch([method_invocation, ok]() { method_invocation->proceed(ok); });
+      // A failed operation only concerns its own invocation, and must not stop serving others.
+      context_->schedule_in([method_invocation, ok]() { method_invocation->proceed(ok); });
     }
-
-    if (!ok)
-      break;
   }
 }
 
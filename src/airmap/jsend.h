@@ -13,12 +13,14 @@
 #ifndef AIRMAP_JSEND_H_
 #define AIRMAP_JSEND_H_
 
+#include <airmap/codec/json/streaming.h>
 #include <airmap/error.h>
 #include <airmap/outcome.h>
 
 #include <nlohmann/json.hpp>
 
 #include <string>
+#include <utility>
 
 namespace airmap {
 namespace jsend {
@@ -43,15 +45,20 @@ static constexpr const char* message{"message"};
 // to the JSEND spec. However, if and when the APIs in question do not conform,
 // we put heuristics to handle that case here. At least, we will gather all the black
 // magic in one place for future analysis.
+//
+// 'streaming' completes the decoded value with the array elements
+// that have been streamed out of 'j' while parsing it.
 template <typename T>
-inline Outcome<T, Error> to_outcome(const nlohmann::json& j) {
+inline Outcome<T, Error> to_outcome(const nlohmann::json& j, codec::json::Streaming<T>& streaming) {
   using Result = Outcome<T, Error>;
 
   if (j.find(key::status) != j.end()) {
     auto s = j[key::status];
 
     if (s == status::success) {
-      return Result{j[key::data].get<T>()};
+      T value = j[key::data].get<T>();
+      streaming.complete(value);
+      return Result{std::move(value)};
     } else if (s == status::failure) {
       if (j.count(key::message) > 0) {
         // This shouldn't happen. Failure responses are _not_ required
@@ -98,16 +105,27 @@ inline Outcome<T, Error> to_outcome(const nlohmann::json& j) {
       return Result{Error{j.at(key::message).get<std::string>()}};
     }
 
-    return Result{j.get<T>()};
+    T value = j.get<T>();
+    streaming.complete(value);
+    return Result{std::move(value)};
   }
 
   return Result{Error{"not jsend formatted"}.value(Error::Value{"json"}, Error::Value{j.dump()})};
 }
 
+template <typename T>
+inline Outcome<T, Error> to_outcome(const nlohmann::json& j) {
+  codec::json::Streaming<T> streaming;
+  return to_outcome<T>(j, streaming);
+}
+
 template <typename T>
 inline Outcome<T, Error> parse_to_outcome(const std::string& json) {
   try {
-    return to_outcome<T>(nlohmann::json::parse(json));
+    codec::json::Streaming<T> streaming;
+    codec::json::ArrayStreamer streamer;
+    streaming.prepare(streamer);
+    return to_outcome<T>(streamer.parse(json), streaming);
   } catch (const std::exception& e) {
     return Outcome<T, Error>{
         Error{"failed to parse JSON response"}.description(e.what()).value(Error::Value{"json"}, Error::Value{json})};
@@ -0,0 +1,39 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_MAVLINK_ATTITUDE_H_
+#define AIRMAP_MAVLINK_ATTITUDE_H_
+
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Waddress-of-packed-member"
+#pragma clang diagnostic ignored "-Wnested-anon-types"
+#pragma clang diagnostic ignored "-Wgnu-anonymous-struct"
+#endif
+#include <standard/mavlink.h>
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+
+#include <iosfwd>
+
+namespace airmap {
+namespace mavlink {
+
+using Attitude = mavlink_attitude_t;
+
+}  // namespace mavlink
+}  // namespace airmap
+
+std::ostream& operator<<(std::ostream& out, const airmap::mavlink::Attitude& attitude);
+
+#endif  // AIRMAP_MAVLINK_ATTITUDE_H_
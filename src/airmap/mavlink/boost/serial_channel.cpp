@@ -52,9 +52,7 @@ void airmap::mavlink::boost::SerialChannel::handle_read(const ::boost::system::e
     return;
   }
 
-  if (auto result = process_mavlink_data(buffer_.begin(), buffer_.begin() + transferred)) {
-    invoke_subscribers(result.get());
-  }
+  process_mavlink_data(buffer_.begin(), buffer_.begin() + transferred);
 
   start_read();
 }
@@ -40,9 +40,8 @@ void airmap::mavlink::boost::TcpChannel::handle_read(const ::boost::system::erro
     return;
   }
 
-  if (auto result = process_mavlink_data(buffer_.begin(), buffer_.begin() + transferred)) {
-    log_.debugf(component, "handing %d message to subscribers", result.get().size());
-    invoke_subscribers(result.get());
+  if (auto dispatched = process_mavlink_data(buffer_.begin(), buffer_.begin() + transferred)) {
+    log_.debugf(component, "handed %d messages to subscribers", dispatched);
   }
 
   start_impl();
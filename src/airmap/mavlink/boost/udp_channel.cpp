@@ -12,39 +12,237 @@
 // limitations under the License.
 #include <airmap/mavlink/boost/udp_channel.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
 namespace {
 constexpr const char* component{"airmap::mavlink::UdpChannel"};
 }  // namespace
 
+airmap::mavlink::Channel::Source airmap::mavlink::boost::UdpChannel::source_for(
+    const ::boost::asio::ip::udp::endpoint& endpoint) {
+  // UDP carries a single MAVLink stream per endpoint, the channel stays at 0. A
+  // sender always hashes to the same shard, so its origin alone identifies it.
+  Source source;
+
+  // IPv4 addresses are keyed by their IPv4-mapped IPv6 form, followed by the port.
+  if (endpoint.address().is_v4()) {
+    auto bytes        = endpoint.address().to_v4().to_bytes();
+    source.origin[10] = 0xff;
+    source.origin[11] = 0xff;
+    std::copy(bytes.begin(), bytes.end(), source.origin.begin() + 12);
+  } else {
+    auto bytes = endpoint.address().to_v6().to_bytes();
+    std::copy(bytes.begin(), bytes.end(), source.origin.begin());
+  }
+
+  source.origin[16] = static_cast<std::uint8_t>(endpoint.port() >> 8);
+  source.origin[17] = static_cast<std::uint8_t>(endpoint.port() & 0xff);
+
+  return source;
+}
+
+airmap::mavlink::boost::UdpChannel::Shard::Shard(const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                                 std::uint16_t port, const Configuration& configuration)
+    : io_service{io_service}, socket{*io_service}, buffers(configuration.batch_size * buffer_size) {
+  socket.open(::boost::asio::ip::udp::v4());
+  if (configuration.shards > 1) {
+    using reuse_port = ::boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+    socket.set_option(reuse_port{true});
+  }
+  socket.bind(::boost::asio::ip::udp::endpoint{::boost::asio::ip::udp::v4(), port});
+
+#if defined(__linux__)
+  headers.resize(configuration.batch_size);
+  iovecs.resize(configuration.batch_size);
+  addresses.resize(configuration.batch_size);
+
+  for (std::size_t i = 0; i < configuration.batch_size; i++) {
+    iovecs[i].iov_base                = &buffers[i * buffer_size];
+    iovecs[i].iov_len                 = buffer_size;
+    headers[i].msg_hdr.msg_name       = &addresses[i];
+    headers[i].msg_hdr.msg_namelen    = sizeof(addresses[i]);
+    headers[i].msg_hdr.msg_iov        = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen     = 1;
+    headers[i].msg_hdr.msg_control    = nullptr;
+    headers[i].msg_hdr.msg_controllen = 0;
+    headers[i].msg_hdr.msg_flags      = 0;
+  }
+#endif  // __linux__
+}
+
 airmap::mavlink::boost::UdpChannel::UdpChannel(const std::shared_ptr<Logger>& logger,
                                                const std::shared_ptr<::boost::asio::io_service>& io_service,
                                                std::uint16_t port)
-    : log_{logger},
-      io_service_{io_service},
-      socket_{*io_service_, ::boost::asio::ip::udp::endpoint{::boost::asio::ip::udp::v4(), port}} {
+    : UdpChannel{logger, io_service, port, Configuration{}} {
+}
+
+airmap::mavlink::boost::UdpChannel::UdpChannel(const std::shared_ptr<Logger>& logger,
+                                               const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                               std::uint16_t port, const Configuration& configuration)
+    : log_{logger}, io_service_{io_service}, configuration_{configuration} {
+  configuration_.shards      = std::max<std::size_t>(configuration_.shards, 1);
+  configuration_.batch_size  = std::max<std::size_t>(configuration_.batch_size, 1);
+  configuration_.max_batches = std::max<std::size_t>(configuration_.max_batches, 1);
+
+  shards_.emplace_back(new Shard{io_service_, port, configuration_});
+  for (std::size_t i = 1; i < configuration_.shards; i++)
+    shards_.emplace_back(new Shard{std::make_shared<::boost::asio::io_service>(), port, configuration_});
+
+  for (auto& shard : shards_)
+    shard->parsers = &create_parser_pool();
+}
+
+airmap::mavlink::boost::UdpChannel::~UdpChannel() {
+  // Handlers keep the channel alive, so none of them is running anymore. The
+  // last reference might have been released on one of our workers, though.
+  for (std::size_t i = 1; i < shards_.size(); i++)
+    shards_[i]->io_service->stop();
+
+  join_workers();
 }
 
 void airmap::mavlink::boost::UdpChannel::start_impl() {
+  running_ = true;
+
+  for (auto& shard : shards_)
+    start_read(*shard);
+
+  for (std::size_t i = 1; i < shards_.size(); i++) {
+    auto io_service = shards_[i]->io_service;
+    io_service->reset();
+    workers_.emplace_back([io_service]() { io_service->run(); });
+  }
+}
+
+void airmap::mavlink::boost::UdpChannel::stop_impl() {
+  running_ = false;
+
+  // Sockets are only touched from the thread running their io_service. Once the
+  // cancelled wait completed, a worker's io_service runs out of work and returns.
+  for (auto& shard : shards_) {
+    auto& socket = shard->socket;
+    shard->io_service->post([self = shared_from_this(), &socket]() {
+      ::boost::system::error_code ec;
+      socket.cancel(ec);
+    });
+  }
+
+  join_workers();
+}
+
+void airmap::mavlink::boost::UdpChannel::join_workers() {
+  struct Joiner {
+    ~Joiner() {
+      for (auto& worker : workers) {
+        if (worker.joinable())
+          worker.join();
+      }
+    }
+    std::vector<std::thread> workers;
+  };
+
+  auto joiner     = std::make_shared<Joiner>();
+  joiner->workers = std::move(workers_);
+  workers_.clear();
+
+  auto on_worker = std::any_of(joiner->workers.begin(), joiner->workers.end(), [](const std::thread& worker) {
+    return worker.get_id() == std::this_thread::get_id();
+  });
+
+  // io_service_ is never run by one of our workers. The joiner completes once the
+  // handler ran or got destroyed together with io_service_.
+  if (on_worker)
+    io_service_->post([joiner = std::move(joiner)]() {});
+}
+
+void airmap::mavlink::boost::UdpChannel::start_read(Shard& shard) {
   using std::placeholders::_1;
   using std::placeholders::_2;
 
-  ::boost::asio::ip::udp::endpoint endpoint;
-  socket_.async_receive_from(::boost::asio::buffer(buffer_), endpoint,
-                             std::bind(&UdpChannel::handle_read, shared_from_this(), _1, _2));
+  // A read that completed before the socket got cancelled must not re-arm.
+  if (!running_)
+    return;
+
+#if defined(__linux__)
+  shard.socket.async_wait(::boost::asio::ip::udp::socket::wait_read,
+                          std::bind(&UdpChannel::handle_readable, shared_from_this(), std::ref(shard), _1));
+#else
+  shard.socket.async_receive_from(
+      ::boost::asio::buffer(shard.buffers.data(), buffer_size), shard.endpoint,
+      std::bind(&UdpChannel::handle_read, shared_from_this(), std::ref(shard), _1, _2));
+#endif  // __linux__
 }
 
-void airmap::mavlink::boost::UdpChannel::stop_impl() {
-  socket_.cancel();
+void airmap::mavlink::boost::UdpChannel::handle_read(Shard& shard, const ::boost::system::error_code& ec,
+                                                     std::size_t transferred) {
+  if (ec == ::boost::asio::error::operation_aborted)
+    return;
+
+  if (ec) {
+    log_.errorf(component, "failed to read from udp endpoint: %s", ec.message());
+    return;
+  }
+
+  dispatch(shard, shard.endpoint, shard.buffers.data(), transferred);
+  start_read(shard);
 }
 
-void airmap::mavlink::boost::UdpChannel::handle_read(const ::boost::system::error_code& ec, std::size_t transferred) {
+void airmap::mavlink::boost::UdpChannel::handle_readable(Shard& shard, const ::boost::system::error_code& ec) {
+  if (ec == ::boost::asio::error::operation_aborted)
+    return;
+
   if (ec) {
-    log_.errorf(component, "failed to read from tcp endpoint: %s", ec.message());
+    log_.errorf(component, "failed to wait for udp endpoint: %s", ec.message());
     return;
   }
 
-  if (auto result = process_mavlink_data(buffer_.begin(), buffer_.begin() + transferred))
-    invoke_subscribers(result.get());
+#if defined(__linux__)
+  const auto batch_size = static_cast<unsigned int>(shard.headers.size());
+
+  // Shard 0 shares io_service_ with the rest of the Context. Once max_batches were
+  // received, we re-arm the wait and leave the remaining datagrams for the next wakeup.
+  for (std::size_t batch = 0; batch < configuration_.max_batches; batch++) {
+    auto received = ::recvmmsg(shard.socket.native_handle(), shard.headers.data(), batch_size, MSG_DONTWAIT, nullptr);
+
+    if (received < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        log_.errorf(component, "failed to read from udp endpoint: %s", std::strerror(errno));
+      break;
+    }
+
+    for (int i = 0; i < received; i++) {
+      auto& header = shard.headers[i];
+
+      ::boost::asio::ip::udp::endpoint endpoint;
+      auto size = std::min<std::size_t>(header.msg_hdr.msg_namelen, endpoint.capacity());
+      std::memcpy(endpoint.data(), &shard.addresses[i], size);
+      endpoint.resize(size);
+
+      dispatch(shard, endpoint, &shard.buffers[i * buffer_size], header.msg_len);
+
+      // recvmmsg updates the length of the source address in place.
+      header.msg_hdr.msg_namelen = sizeof(shard.addresses[i]);
+    }
+
+    if (static_cast<unsigned int>(received) < batch_size)
+      break;
+  }
+#endif  // __linux__
+
+  start_read(shard);
+}
 
-  start_impl();
+void airmap::mavlink::boost::UdpChannel::dispatch(Shard& shard, const ::boost::asio::ip::udp::endpoint& endpoint,
+                                                  const char* data, std::size_t size) {
+  process_mavlink_data(*shard.parsers, source_for(endpoint),
+                       [&endpoint]() {
+                         std::ostringstream ss;
+                         ss << "udp://" << endpoint;
+                         return ss.str();
+                       },
+                       data, data + size);
 }
@@ -20,16 +20,45 @@
 
 #include <boost/asio.hpp>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif  // __linux__
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 namespace airmap {
 namespace mavlink {
 namespace boost {
 
+/// UdpChannel receives MAVLink messages from all senders that send to a local UDP port.
+///
+/// Every sender gets its own parse state and statistics, such that partial
+/// frames from different senders never interleave. On Linux, datagrams are received in
+/// batches via recvmmsg. With more than one shard, the port is bound by
+/// multiple sockets with SO_REUSEPORT, and the kernel distributes senders
+/// across them. Every shard beyond the first one runs on its own thread, and
+/// subscribers are then invoked concurrently from multiple threads.
 class UdpChannel : public Channel, public std::enable_shared_from_this<UdpChannel> {
  public:
   static constexpr std::size_t buffer_size{1024};
 
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::size_t shards{1};       ///< Number of sockets bound to the port.
+    std::size_t batch_size{32};  ///< Maximum number of datagrams received with a single call.
+    std::size_t max_batches{4};  ///< Maximum number of batches received before yielding to other handlers.
+  };
+
   explicit UdpChannel(const std::shared_ptr<Logger>& logger,
                       const std::shared_ptr<::boost::asio::io_service>& io_service, std::uint16_t port);
+  explicit UdpChannel(const std::shared_ptr<Logger>& logger,
+                      const std::shared_ptr<::boost::asio::io_service>& io_service, std::uint16_t port,
+                      const Configuration& configuration);
+  ~UdpChannel();
 
  protected:
   // From Channel
@@ -37,12 +66,41 @@ class UdpChannel : public Channel, public std::enable_shared_from_this<UdpChanne
   void stop_impl() override;
 
  private:
-  void handle_read(const ::boost::system::error_code& ec, std::size_t transferred);
+  struct Shard {
+    explicit Shard(const std::shared_ptr<::boost::asio::io_service>& io_service, std::uint16_t port,
+                   const Configuration& configuration);
+
+    std::shared_ptr<::boost::asio::io_service> io_service;
+    ::boost::asio::ip::udp::socket socket;
+    ::boost::asio::ip::udp::endpoint endpoint;
+    std::vector<char> buffers;
+#if defined(__linux__)
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> iovecs;
+    std::vector<::sockaddr_storage> addresses;
+#endif  // __linux__
+    ParserPool* parsers{nullptr};
+  };
+
+  /// source_for returns the Source identifying datagrams from 'endpoint'.
+  static Source source_for(const ::boost::asio::ip::udp::endpoint& endpoint);
+
+  /// join_workers joins all worker threads. If called on one of the workers, the
+  /// threads are handed to io_service_ and joined from there instead.
+  void join_workers();
+
+  void start_read(Shard& shard);
+  void handle_read(Shard& shard, const ::boost::system::error_code& ec, std::size_t transferred);
+  void handle_readable(Shard& shard, const ::boost::system::error_code& ec);
+  void dispatch(Shard& shard, const ::boost::asio::ip::udp::endpoint& endpoint, const char* data,
+                std::size_t size);
 
   util::FormattingLogger log_;
   std::shared_ptr<::boost::asio::io_service> io_service_;
-  ::boost::asio::ip::udp::socket socket_;
-  std::array<char, buffer_size> buffer_;
+  Configuration configuration_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> running_{false};
 };
 
 }  // namespace boost
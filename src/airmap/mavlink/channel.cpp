@@ -12,25 +12,127 @@
 // limitations under the License.
 #include <airmap/mavlink/channel.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <iterator>
 
-airmap::mavlink::Channel::Channel() {
-  ::memset(&parse_buffer_.msg, 0, sizeof(parse_buffer_.msg));
-  ::memset(&parse_buffer_.status, 0, sizeof(parse_buffer_.status));
+airmap::mavlink::Channel::ParseState::ParseState() {
+  ::memset(&msg, 0, sizeof(msg));
+  ::memset(&status, 0, sizeof(status));
+}
+
+std::size_t airmap::mavlink::Channel::ParserPool::SourceHash::operator()(const Source& source) const {
+  // FNV-1a over the origin and the channel.
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (auto byte : source.origin)
+    hash = (hash ^ byte) * 0x100000001b3;
+  return static_cast<std::size_t>((hash ^ source.channel) * 0x100000001b3);
+}
+
+airmap::mavlink::Channel::ParserPool::ParserPool(std::size_t capacity) : capacity_{std::max<std::size_t>(capacity, 1)} {
+  // Slots never move, such that the reading thread can use a slot's parse state without holding guard_.
+  slots_.reserve(capacity_);
+  index_.reserve(capacity_);
+}
+
+std::size_t airmap::mavlink::Channel::ParserPool::acquire(const Source& source,
+                                                          const std::function<std::string()>& describe) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  auto it = index_.find(source);
+  if (it != index_.end()) {
+    slots_[it->second].last_used = ++tick_;
+    return it->second;
+  }
+
+  std::size_t index = slots_.size();
+
+  if (slots_.size() < capacity_) {
+    slots_.emplace_back();
+  } else {
+    auto lru = std::min_element(slots_.begin(), slots_.end(),
+                                [](const Slot& lhs, const Slot& rhs) { return lhs.last_used < rhs.last_used; });
+    index    = std::distance(slots_.begin(), lru);
+    index_.erase(lru->statistics.source);
+    *lru = Slot{};
+  }
+
+  auto& slot             = slots_[index];
+  slot.statistics.name   = describe();
+  slot.statistics.source = source;
+  slot.last_used         = ++tick_;
+  index_[source]         = index;
+
+  return index;
+}
+
+airmap::mavlink::Channel::ParseState& airmap::mavlink::Channel::ParserPool::state(std::size_t index) {
+  return slots_[index].state;
+}
+
+void airmap::mavlink::Channel::ParserPool::record(std::size_t index, std::uint64_t good, std::uint64_t bad,
+                                                  const Optional<std::uint8_t>& system_id) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  auto& statistics = slots_[index].statistics;
+  statistics.received += good + bad;
+  statistics.good += good;
+  statistics.bad += bad;
+  if (system_id)
+    statistics.system_id = system_id;
+}
+
+void airmap::mavlink::Channel::ParserPool::statistics(std::vector<SourceStatistics>& result) const {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  for (const auto& slot : slots_)
+    result.push_back(slot.statistics);
+}
+
+airmap::mavlink::Channel::Channel()
+    : subscribers_{std::make_shared<SubscriberSet>()}, stream_parsers_{&create_parser_pool(1)} {
 }
 
 const airmap::mavlink::Channel::Counters& airmap::mavlink::Channel::counters() const {
   return counters_;
 }
 
+std::vector<airmap::mavlink::Channel::SourceStatistics> airmap::mavlink::Channel::source_statistics() const {
+  std::vector<SourceStatistics> result;
+
+  std::lock_guard<std::mutex> lg{guard_};
+  for (const auto& pool : parser_pools_)
+    pool->statistics(result);
+
+  return result;
+}
+
+airmap::mavlink::Channel::ParserPool& airmap::mavlink::Channel::create_parser_pool(std::size_t capacity) {
+  std::lock_guard<std::mutex> lg{guard_};
+  parser_pools_.emplace_back(new ParserPool{capacity});
+  return *parser_pools_.back();
+}
+
 airmap::mavlink::Channel::Subscription airmap::mavlink::Channel::subscribe(const Subscriber& subscriber) {
   std::lock_guard<std::mutex> lg{guard_};
-  return subscribers_.insert(subscribers_.end(), subscriber);
+
+  auto subscribers = std::make_shared<SubscriberSet>(*subscribers_);
+  subscribers->push_back(Entry{++next_subscription_, subscriber});
+  std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberSet>{std::move(subscribers)});
+
+  return next_subscription_;
 }
 
 void airmap::mavlink::Channel::unsubscribe(Subscription&& subscription) {
   std::lock_guard<std::mutex> lg{guard_};
-  subscribers_.erase(subscription);
+
+  auto subscribers = std::make_shared<SubscriberSet>();
+  subscribers->reserve(subscribers_->size());
+  std::copy_if(subscribers_->begin(), subscribers_->end(), std::back_inserter(*subscribers),
+               [subscription](const Entry& entry) { return entry.subscription != subscription; });
+  std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberSet>{std::move(subscribers)});
 }
 
 void airmap::mavlink::Channel::start() {
@@ -45,43 +147,58 @@ void airmap::mavlink::Channel::stop() {
   stop_impl();
 }
 
-void airmap::mavlink::Channel::invoke_subscribers(const std::vector<mavlink_message_t>& msgs) {
-  std::unique_lock<std::mutex> ul{guard_};
-  auto subscribers = subscribers_;
-  ul.unlock();
+void airmap::mavlink::Channel::invoke_subscribers(const mavlink_message_t& msg) {
+  auto subscribers = std::atomic_load(&subscribers_);
 
-  for (const auto& msg : msgs) {
-    for (const auto& subscriber : subscribers)
-      subscriber(msg);
-  }
+  for (const auto& entry : *subscribers)
+    entry.subscriber(msg);
+}
+
+std::size_t airmap::mavlink::Channel::process_mavlink_data(const char* begin, const char* end) {
+  static const std::function<std::string()> describe{[]() { return std::string{"stream"}; }};
+  return process_mavlink_data(*stream_parsers_, Source{}, describe, begin, end);
 }
 
-airmap::Optional<std::vector<mavlink_message_t>> airmap::mavlink::Channel::process_mavlink_data(const char* begin,
-                                                                                                const char* end) {
-  Optional<std::vector<mavlink_message_t>> result;
+std::size_t airmap::mavlink::Channel::process_mavlink_data(ParserPool& pool, const Source& source,
+                                                           const std::function<std::string()>& describe,
+                                                           const char* begin, const char* end) {
+  auto index  = pool.acquire(source, describe);
+  auto& state = pool.state(index);
+
+  // The snapshot is acquired once per read and stays valid even if a
+  // subscriber unsubscribes while messages are being dispatched.
+  auto subscribers = std::atomic_load(&subscribers_);
+
+  std::uint64_t good = 0;
+  std::uint64_t bad  = 0;
+  Optional<std::uint8_t> system_id;
 
   for (; begin < end; ++begin) {
-    auto rc = mavlink_frame_char_buffer(&parse_buffer_.msg, &parse_buffer_.status, *begin, &parse_out_.msg,
-                                        &parse_out_.status);
+    auto rc = mavlink_frame_char_buffer(&state.msg, &state.status, *begin, &state.out_msg, &state.out_status);
 
     switch (rc) {
       case MAVLINK_FRAMING_INCOMPLETE:
         break;
       case MAVLINK_FRAMING_OK:
-        if (not result)
-          result = std::vector<mavlink_message_t>{};
-        result.get().push_back(parse_out_.msg);
-        counters_.received++;
-        counters_.good++;
+        good++;
+        system_id = state.out_msg.sysid;
+        for (const auto& entry : *subscribers)
+          entry.subscriber(state.out_msg);
         break;
       case MAVLINK_FRAMING_BAD_CRC:
-        counters_.received++;
-        counters_.bad++;
+        bad++;
         break;
     }
   }
 
-  return result;
+  if (good || bad) {
+    counters_.received += good + bad;
+    counters_.good += good;
+    counters_.bad += bad;
+    pool.record(index, good, bad, system_id);
+  }
+
+  return good;
 }
 
 airmap::mavlink::FilteringChannel::FilteringChannel(const std::shared_ptr<airmap::mavlink::Channel>& next,
@@ -100,9 +217,9 @@ std::shared_ptr<airmap::mavlink::FilteringChannel> airmap::mavlink::FilteringCha
 void airmap::mavlink::FilteringChannel::start_impl() {
   subscription_ = next_->subscribe([sp = shared_from_this()](const mavlink_message_t& msg) {
     if (msg.sysid != sp->system_id_)
-      return
+      return;
 
-          sp->invoke_subscribers({msg});
+    sp->invoke_subscribers(msg);
   });
 }
 
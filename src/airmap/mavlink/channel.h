@@ -27,31 +27,69 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace airmap {
 namespace mavlink {
 
+/// Channel models a source of MAVLink messages, dispatching every framed
+/// message to all subscribers.
+///
+/// Subscribers are kept in an immutable snapshot that is replaced on subscribe
+/// and unsubscribe. Dispatching only acquires the current snapshot and neither
+/// locks nor copies the set of subscribers.
 class Channel : DoNotCopyOrMove {
  public:
+  /// Counters are updated from whatever thread reads from the channel.
   struct Counters {
-    std::uint64_t received{0};
-    std::uint64_t good{0};
-    std::uint64_t bad{0};
+    std::atomic<std::uint64_t> received{0};
+    std::atomic<std::uint64_t> good{0};
+    std::atomic<std::uint64_t> bad{0};
   };
 
-  using Subscriber    = std::function<void(const mavlink_message_t&)>;
-  using SubscriberSet = std::list<Subscriber>;
-  using Subscription  = SubscriberSet::const_iterator;
+  /// Source identifies an individual byte stream feeding into a channel,
+  /// e.g., a remote UDP endpoint together with a MAVLink channel.
+  struct Source {
+    /// Origin is wide enough to hold an IPv6 address and a port.
+    using Origin = std::array<std::uint8_t, 18>;
+
+    Origin origin{};          ///< Implementation-defined id of the stream's origin.
+    std::uint8_t channel{0};  ///< The MAVLink channel multiplexed over the origin.
+
+    bool operator==(const Source& rhs) const {
+      return origin == rhs.origin && channel == rhs.channel;
+    }
+  };
+
+  /// SourceStatistics summarizes the traffic received from a single source.
+  struct SourceStatistics {
+    std::string name;                  ///< Human-readable description of the source.
+    Source source;                     ///< The source described by this instance.
+    std::uint64_t received{0};         ///< Number of framed messages, good or bad.
+    std::uint64_t good{0};             ///< Number of messages that passed the CRC check.
+    std::uint64_t bad{0};              ///< Number of messages that failed the CRC check.
+    Optional<std::uint8_t> system_id;  ///< System id of the most recent good message.
+  };
+
+  using Subscriber   = std::function<void(const mavlink_message_t&)>;
+  using Subscription = std::uint64_t;
 
   const Counters& counters() const;
 
+  /// source_statistics returns a snapshot of the statistics of all sources
+  /// currently known to the channel.
+  std::vector<SourceStatistics> source_statistics() const;
+
   Subscription subscribe(const Subscriber&);
   void unsubscribe(Subscription&& subscription);
 
@@ -64,21 +102,92 @@ class Channel : DoNotCopyOrMove {
   virtual void start_impl() = 0;
   virtual void stop_impl()  = 0;
 
-  void invoke_subscribers(const std::vector<mavlink_message_t>& msgs);
-  Optional<std::vector<mavlink_message_t>> process_mavlink_data(const char* begin, const char* end);
+  /// ParseState bundles up the framing state of a single byte stream.
+  struct ParseState {
+    ParseState();
 
- private:
-  Counters counters_;
-  std::mutex guard_;
-  SubscriberSet subscribers_;
-  struct {
     mavlink_message_t msg;
     mavlink_status_t status;
-  } parse_buffer_;
-  struct {
-    mavlink_message_t msg;
-    mavlink_status_t status;
-  } parse_out_;
+    mavlink_message_t out_msg;
+    mavlink_status_t out_status;
+  };
+
+  /// ParserPool keeps the parse state and statistics of individual sources in a
+  /// flat table of fixed capacity, indexed by source. Once the table is full, the
+  /// least recently active source gives up its slot.
+  ///
+  /// A pool is fed from a single reading thread, statistics can be queried from any thread.
+  class ParserPool : DoNotCopyOrMove {
+   public:
+    static constexpr std::size_t default_capacity{256};
+
+    explicit ParserPool(std::size_t capacity);
+
+    /// acquire returns the index of the slot for 'source', initializing a
+    /// slot named 'describe()' if 'source' has not been seen before.
+    std::size_t acquire(const Source& source, const std::function<std::string()>& describe);
+
+    /// state returns the parse state in slot 'index'.
+    ParseState& state(std::size_t index);
+
+    /// record accounts for messages received via slot 'index'.
+    void record(std::size_t index, std::uint64_t good, std::uint64_t bad, const Optional<std::uint8_t>& system_id);
+
+    /// statistics appends the statistics of all known sources to 'result'.
+    void statistics(std::vector<SourceStatistics>& result) const;
+
+   private:
+    struct Slot {
+      ParseState state;
+      SourceStatistics statistics;
+      std::uint64_t last_used{0};
+    };
+
+    struct SourceHash {
+      std::size_t operator()(const Source& source) const;
+    };
+
+    std::size_t capacity_;
+    mutable std::mutex guard_;
+    std::uint64_t tick_{0};
+    std::vector<Slot> slots_;
+    std::unordered_map<Source, std::size_t, SourceHash> index_;
+  };
+
+  /// create_parser_pool returns a new ParserPool with 'capacity' slots, owned by
+  /// and reporting through this channel.
+  ParserPool& create_parser_pool(std::size_t capacity = ParserPool::default_capacity);
+
+  /// invoke_subscribers hands 'msg' to all subscribers.
+  void invoke_subscribers(const mavlink_message_t& msg);
+
+  /// process_mavlink_data frames the raw bytes in [begin, end) and hands every
+  /// complete message to all subscribers, straight from the channel's parse buffer.
+  /// Partial frames are carried over to the next call. Returns the number of
+  /// messages that were dispatched.
+  std::size_t process_mavlink_data(const char* begin, const char* end);
+
+  /// process_mavlink_data frames the raw bytes in [begin, end) received from 'source'
+  /// with the parse state kept for 'source' in 'pool', enabling implementations to
+  /// keep independent streams (e.g., different senders) apart. 'describe' is only
+  /// invoked for sources that are not yet known to 'pool'.
+  std::size_t process_mavlink_data(ParserPool& pool, const Source& source,
+                                   const std::function<std::string()>& describe, const char* begin,
+                                   const char* end);
+
+ private:
+  struct Entry {
+    Subscription subscription;
+    Subscriber subscriber;
+  };
+  using SubscriberSet = std::vector<Entry>;
+
+  Counters counters_;
+  mutable std::mutex guard_;
+  Subscription next_subscription_{0};
+  std::shared_ptr<const SubscriberSet> subscribers_;
+  std::vector<std::unique_ptr<ParserPool>> parser_pools_;
+  ParserPool* stream_parsers_;
 };
 
 class FilteringChannel : public Channel, public std::enable_shared_from_this<FilteringChannel> {
@@ -12,8 +12,11 @@
 // limitations under the License.
 #include <airmap/mavlink/vehicle.h>
 
+#include <common/mavlink_msg_attitude.h>
 #include <common/mavlink_msg_global_position_int.h>
 #include <common/mavlink_msg_heartbeat.h>
+#include <common/mavlink_msg_scaled_pressure.h>
+#include <common/mavlink_msg_vfr_hud.h>
 
 #include <cassert>
 
@@ -30,6 +33,15 @@ void airmap::mavlink::Vehicle::update(const mavlink_message_t& msg) {
     case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
       handle_msg_global_position_int(msg);
       break;
+    case MAVLINK_MSG_ID_ATTITUDE:
+      handle_msg_attitude(msg);
+      break;
+    case MAVLINK_MSG_ID_VFR_HUD:
+      handle_msg_vfr_hud(msg);
+      break;
+    case MAVLINK_MSG_ID_SCALED_PRESSURE:
+      handle_msg_scaled_pressure(msg);
+      break;
     case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
     case MAVLINK_MSG_ID_MISSION_COUNT:
     case MAVLINK_MSG_ID_MISSION_ITEM:
@@ -68,6 +80,36 @@ void airmap::mavlink::Vehicle::handle_msg_global_position_int(const mavlink_mess
   global_position_int_ = gpi;
 }
 
+void airmap::mavlink::Vehicle::handle_msg_attitude(const mavlink_message_t& msg) {
+  Attitude attitude;
+  mavlink_msg_attitude_decode(&msg, &attitude);
+
+  for (const auto& monitor : monitors_) {
+    monitor->on_attitude_changed(attitude_, attitude);
+  }
+  attitude_ = attitude;
+}
+
+void airmap::mavlink::Vehicle::handle_msg_vfr_hud(const mavlink_message_t& msg) {
+  VfrHud vfr_hud;
+  mavlink_msg_vfr_hud_decode(&msg, &vfr_hud);
+
+  for (const auto& monitor : monitors_) {
+    monitor->on_vfr_hud_changed(vfr_hud_, vfr_hud);
+  }
+  vfr_hud_ = vfr_hud;
+}
+
+void airmap::mavlink::Vehicle::handle_msg_scaled_pressure(const mavlink_message_t& msg) {
+  ScaledPressure pressure;
+  mavlink_msg_scaled_pressure_decode(&msg, &pressure);
+
+  for (const auto& monitor : monitors_) {
+    monitor->on_pressure_changed(scaled_pressure_, pressure);
+  }
+  scaled_pressure_ = pressure;
+}
+
 void airmap::mavlink::Vehicle::handle_msg_mission(const mavlink_message_t& msg) {
   if (mission_.update(msg)) {
     Geometry::LineString line_string{{mission_.coordinates()}};
@@ -96,6 +138,24 @@ void airmap::mavlink::LoggingVehicleMonitor::on_position_changed(const Optional<
   next_->on_position_changed(old_position, new_position);
 }
 
+void airmap::mavlink::LoggingVehicleMonitor::on_attitude_changed(const Optional<Attitude>& old_attitude,
+                                                                 const Attitude& new_attitude) {
+  log_.debugf(component_, "attitude changed: %s -> %s", old_attitude, new_attitude);
+  next_->on_attitude_changed(old_attitude, new_attitude);
+}
+
+void airmap::mavlink::LoggingVehicleMonitor::on_vfr_hud_changed(const Optional<VfrHud>& old_vfr_hud,
+                                                                const VfrHud& new_vfr_hud) {
+  log_.debugf(component_, "vfr hud changed: %s -> %s", old_vfr_hud, new_vfr_hud);
+  next_->on_vfr_hud_changed(old_vfr_hud, new_vfr_hud);
+}
+
+void airmap::mavlink::LoggingVehicleMonitor::on_pressure_changed(const Optional<ScaledPressure>& old_pressure,
+                                                                 const ScaledPressure& new_pressure) {
+  log_.debugf(component_, "pressure changed: %s -> %s", old_pressure, new_pressure);
+  next_->on_pressure_changed(old_pressure, new_pressure);
+}
+
 void airmap::mavlink::LoggingVehicleMonitor::on_mission_received(const airmap::Geometry& geometry) {
   log_.infof(component_, "mission received with geometry");
   next_->on_mission_received(geometry);
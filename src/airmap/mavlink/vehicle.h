@@ -17,9 +17,12 @@
 #include <airmap/optional.h>
 #include <airmap/util/formatting_logger.h>
 
+#include <airmap/mavlink/attitude.h>
 #include <airmap/mavlink/global_position_int.h>
 #include <airmap/mavlink/mission.h>
+#include <airmap/mavlink/scaled_pressure.h>
 #include <airmap/mavlink/state.h>
+#include <airmap/mavlink/vfr_hud.h>
 
 #include <cstdint>
 
@@ -33,10 +36,14 @@ class Vehicle {
  public:
   class Monitor : DoNotCopyOrMove {
    public:
-    virtual void on_system_status_changed(const Optional<State>& old_state, State new_state) = 0;
+    virtual void on_system_status_changed(const Optional<State>& old_state, State new_state)               = 0;
     virtual void on_position_changed(const Optional<GlobalPositionInt>& old_position,
-                                     const GlobalPositionInt& new_position)                  = 0;
-    virtual void on_mission_received(const airmap::Geometry& geometry)                       = 0;
+                                     const GlobalPositionInt& new_position)                                = 0;
+    virtual void on_attitude_changed(const Optional<Attitude>& old_attitude, const Attitude& new_attitude) = 0;
+    virtual void on_vfr_hud_changed(const Optional<VfrHud>& old_vfr_hud, const VfrHud& new_vfr_hud)        = 0;
+    virtual void on_pressure_changed(const Optional<ScaledPressure>& old_pressure,
+                                     const ScaledPressure& new_pressure)                                   = 0;
+    virtual void on_mission_received(const airmap::Geometry& geometry)                                     = 0;
 
    protected:
     Monitor() = default;
@@ -50,15 +57,21 @@ class Vehicle {
   void unregister_monitor(const std::shared_ptr<Monitor>& monitor);
 
  protected:
+  void handle_msg_attitude(const mavlink_message_t& msg);
   void handle_msg_global_position_int(const mavlink_message_t& msg);
   void handle_msg_heartbeat(const mavlink_message_t& msg);
   void handle_msg_mission(const mavlink_message_t& msg);
+  void handle_msg_scaled_pressure(const mavlink_message_t& msg);
+  void handle_msg_vfr_hud(const mavlink_message_t& msg);
 
   std::uint8_t system_id_;
   std::unordered_set<std::shared_ptr<Monitor>> monitors_;
 
   State system_status_;
   Optional<GlobalPositionInt> global_position_int_;
+  Optional<Attitude> attitude_;
+  Optional<VfrHud> vfr_hud_;
+  Optional<ScaledPressure> scaled_pressure_;
 
   Mission mission_;
 };
@@ -72,6 +85,9 @@ class LoggingVehicleMonitor : public Vehicle::Monitor {
   void on_system_status_changed(const Optional<State>& old_state, State new_state) override;
   void on_position_changed(const Optional<GlobalPositionInt>& old_position,
                            const GlobalPositionInt& new_position) override;
+  void on_attitude_changed(const Optional<Attitude>& old_attitude, const Attitude& new_attitude) override;
+  void on_vfr_hud_changed(const Optional<VfrHud>& old_vfr_hud, const VfrHud& new_vfr_hud) override;
+  void on_pressure_changed(const Optional<ScaledPressure>& old_pressure, const ScaledPressure& new_pressure) override;
   void on_mission_received(const airmap::Geometry& geometry) override;
 
  private:
@@ -12,16 +12,100 @@
 // limitations under the License.
 #include <airmap/mavlink/vehicle_tracker.h>
 
+#include <algorithm>
+
+namespace {
+// Upper bound on the messages handed to a single vehicle before a worker moves on.
+constexpr std::size_t max_batch_size{64};
+}  // namespace
+
+airmap::mavlink::VehicleTracker::VehicleTracker() : VehicleTracker{Configuration{}} {
+}
+
+airmap::mavlink::VehicleTracker::VehicleTracker(const Configuration& configuration) : configuration_{configuration} {
+  configuration_.workers = std::min(configuration_.workers, max_vehicles);
+
+  for (std::size_t i = 0; i < configuration_.workers; i++)
+    workers_.emplace_back(new Worker{});
+  for (std::size_t i = 0; i < configuration_.workers; i++)
+    workers_[i]->thread = std::thread{[this, i]() { run(i); }};
+}
+
+airmap::mavlink::VehicleTracker::~VehicleTracker() {
+  running_ = false;
+
+  for (auto& worker : workers_) {
+    notify(*worker);
+    if (worker->thread.joinable())
+      worker->thread.join();
+  }
+}
+
 void airmap::mavlink::VehicleTracker::update(const mavlink_message_t& msg) {
-  auto it = vehicles_.find(msg.sysid);
+  auto& slot = vehicles_[msg.sysid];
+
+  if (!slot.owned) {
+    slot.owned.reset(new Tracked{std::make_shared<Vehicle>(msg.sysid), nullptr, std::chrono::steady_clock::now()});
+    if (!workers_.empty())
+      slot.owned->queue.reset(new util::SpscRing<mavlink_message_t>{configuration_.queue_capacity});
+    active_.fetch_add(1, std::memory_order_relaxed);
+
+    // Monitors are informed before the vehicle becomes visible to its worker.
+    for (const auto& monitor : monitors_)
+      monitor->on_vehicle_added(slot.owned->vehicle);
+
+    slot.published.store(slot.owned.get(), std::memory_order_release);
+  }
+
+  auto& tracked = *slot.owned;
+
+  if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT)
+    tracked.last_heartbeat = std::chrono::steady_clock::now();
+
+  if (workers_.empty()) {
+    tracked.vehicle->update(msg);
+    return;
+  }
+
+  if (!tracked.queue->try_push(msg)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto& worker = *workers_[msg.sysid % workers_.size()];
+  // Pairs with the fence in run, such that either the worker observes the new
+  // message or we observe the worker going to sleep.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (worker.sleeping.load(std::memory_order_relaxed))
+    notify(worker);
+}
+
+std::size_t airmap::mavlink::VehicleTracker::evict_stale_vehicles(std::chrono::steady_clock::time_point now) {
+  std::size_t evicted = 0;
+
+  for (std::size_t sysid = 0; sysid < max_vehicles; sysid++) {
+    auto& slot = vehicles_[sysid];
+    if (!slot.owned || now - slot.owned->last_heartbeat < configuration_.heartbeat_timeout)
+      continue;
+
+    if (!workers_.empty()) {
+      // Once the worker released its scan guard, it cannot observe the vehicle anymore.
+      std::lock_guard<std::mutex> lg{workers_[sysid % workers_.size()]->scan_guard};
+      slot.published.store(nullptr, std::memory_order_release);
+    } else {
+      slot.published.store(nullptr, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Tracked> tracked{std::move(slot.owned)};
+    active_.fetch_sub(1, std::memory_order_relaxed);
+    evicted_.fetch_add(1, std::memory_order_relaxed);
+    evicted++;
 
-  if (it == vehicles_.end()) {
-    std::tie(it, std::ignore) = vehicles_.emplace(msg.sysid, std::make_shared<Vehicle>(msg.sysid));
     for (const auto& monitor : monitors_)
-      monitor->on_vehicle_added(it->second);
+      monitor->on_vehicle_removed(tracked->vehicle);
   }
 
-  it->second->update(msg);
+  return evicted;
 }
 
 void airmap::mavlink::VehicleTracker::register_monitor(const std::shared_ptr<Monitor>& monitor) {
@@ -32,6 +116,75 @@ void airmap::mavlink::VehicleTracker::unregister_monitor(const std::shared_ptr<M
   monitors_.erase(monitor);
 }
 
+std::uint64_t airmap::mavlink::VehicleTracker::dropped() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t airmap::mavlink::VehicleTracker::active() const {
+  return active_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t airmap::mavlink::VehicleTracker::evicted() const {
+  return evicted_.load(std::memory_order_relaxed);
+}
+
+void airmap::mavlink::VehicleTracker::run(std::size_t index) {
+  auto& worker          = *workers_[index];
+  std::uint64_t wakeups = 0;
+
+  while (running_) {
+    if (drain(index))
+      continue;
+
+    std::unique_lock<std::mutex> ul{worker.guard};
+    worker.sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (running_ && !has_pending(index))
+      worker.wakeup.wait(ul, [&]() { return worker.wakeups != wakeups || !running_; });
+
+    wakeups = worker.wakeups;
+    worker.sleeping.store(false, std::memory_order_relaxed);
+  }
+}
+
+bool airmap::mavlink::VehicleTracker::drain(std::size_t index) {
+  std::lock_guard<std::mutex> lg{workers_[index]->scan_guard};
+  bool handled = false;
+
+  for (std::size_t sysid = index; sysid < max_vehicles; sysid += workers_.size()) {
+    auto tracked = vehicles_[sysid].published.load(std::memory_order_acquire);
+    if (!tracked)
+      continue;
+
+    auto& vehicle = *tracked->vehicle;
+    if (tracked->queue->consume([&vehicle](const mavlink_message_t& msg) { vehicle.update(msg); }, max_batch_size) > 0)
+      handled = true;
+  }
+
+  return handled;
+}
+
+bool airmap::mavlink::VehicleTracker::has_pending(std::size_t index) const {
+  std::lock_guard<std::mutex> lg{workers_[index]->scan_guard};
+
+  for (std::size_t sysid = index; sysid < max_vehicles; sysid += workers_.size()) {
+    auto tracked = vehicles_[sysid].published.load(std::memory_order_acquire);
+    if (tracked && !tracked->queue->empty())
+      return true;
+  }
+
+  return false;
+}
+
+void airmap::mavlink::VehicleTracker::notify(Worker& worker) {
+  {
+    std::lock_guard<std::mutex> lg{worker.guard};
+    worker.wakeups++;
+  }
+  worker.wakeup.notify_one();
+}
+
 airmap::mavlink::LoggingVehicleTrackerMonitor::LoggingVehicleTrackerMonitor(
     const char* component, const std::shared_ptr<Logger>& logger, const std::shared_ptr<VehicleTracker::Monitor>& next)
     : component_{component}, log_{logger}, next_{next} {
@@ -44,5 +197,5 @@ void airmap::mavlink::LoggingVehicleTrackerMonitor::on_vehicle_added(const std::
 
 void airmap::mavlink::LoggingVehicleTrackerMonitor::on_vehicle_removed(const std::shared_ptr<Vehicle>& vehicle) {
   log_.infof(component_, "vehicle removed from tracker: %s", vehicle);
-  next_->on_vehicle_added(vehicle);
+  next_->on_vehicle_removed(vehicle);
 }
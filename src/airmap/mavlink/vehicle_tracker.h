@@ -16,6 +16,7 @@
 #include <airmap/do_not_copy_or_move.h>
 #include <airmap/mavlink/vehicle.h>
 #include <airmap/util/formatting_logger.h>
+#include <airmap/util/spsc_ring.h>
 
 #if defined(__clang__)
 #pragma clang diagnostic push
@@ -28,14 +29,36 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 namespace airmap {
 namespace mavlink {
 
-class VehicleTracker {
+/// VehicleTracker creates a Vehicle for every MAVLink system id it sees and
+/// hands incoming messages to the respective vehicle.
+///
+/// By default, messages are handed to vehicles synchronously on the thread
+/// calling update. In fleet mode (Configuration::workers > 0), every vehicle
+/// is assigned to one of a fixed number of worker threads and messages are
+/// handed over via bounded per-vehicle SPSC queues. A slow vehicle pipeline
+/// then only stalls the vehicles sharing its worker. Vehicle monitors are
+/// invoked on the worker threads in fleet mode.
+///
+/// Vehicles that have not sent a HEARTBEAT for Configuration::heartbeat_timeout
+/// are removed by evict_stale_vehicles, which is meant to be invoked periodically.
+///
+/// update and evict_stale_vehicles must only be called from a single thread at a time.
+class VehicleTracker : DoNotCopyOrMove {
  public:
   class Monitor : DoNotCopyOrMove {
    public:
@@ -46,14 +69,75 @@ class VehicleTracker {
     Monitor() = default;
   };
 
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::size_t workers{0};                      ///< Number of worker threads, 0 dispatches synchronously.
+    std::size_t queue_capacity{256};             ///< Capacity of the per-vehicle message queue in fleet mode.
+    std::chrono::seconds heartbeat_timeout{30};  ///< Vehicles without a HEARTBEAT for this long are evicted.
+  };
+
+  VehicleTracker();
+  explicit VehicleTracker(const Configuration& configuration);
+  ~VehicleTracker();
+
   void update(const mavlink_message_t& msg);
 
   void register_monitor(const std::shared_ptr<Monitor>& monitor);
   void unregister_monitor(const std::shared_ptr<Monitor>& monitor);
 
+  /// evict_stale_vehicles removes all vehicles that did not send a HEARTBEAT
+  /// for Configuration::heartbeat_timeout as of 'now', informing all monitors.
+  /// Returns the number of evicted vehicles.
+  std::size_t evict_stale_vehicles(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /// dropped returns the number of messages dropped due to full vehicle queues.
+  std::uint64_t dropped() const;
+
+  /// active returns the number of vehicles currently tracked.
+  std::uint64_t active() const;
+
+  /// evicted returns the number of vehicles evicted so far.
+  std::uint64_t evicted() const;
+
  protected:
+  static constexpr std::size_t max_vehicles{256};
+
+  struct Tracked {
+    std::shared_ptr<Vehicle> vehicle;
+    std::unique_ptr<util::SpscRing<mavlink_message_t>> queue;
+    std::chrono::steady_clock::time_point last_heartbeat;
+  };
+
+  struct Slot {
+    std::unique_ptr<Tracked> owned;            ///< Only accessed by the thread calling update.
+    std::atomic<Tracked*> published{nullptr};  ///< Visible to the worker in fleet mode.
+  };
+
+  struct Worker {
+    std::thread thread;
+    std::mutex guard;
+    std::condition_variable wakeup;
+    std::atomic<bool> sleeping{false};
+    std::uint64_t wakeups{0};
+    std::mutex scan_guard;  ///< Held while the worker accesses published vehicles.
+  };
+
+  /// run drains the queues of all vehicles assigned to the worker with 'index'.
+  void run(std::size_t index);
+  /// drain hands queued messages to all vehicles assigned to the worker with
+  /// 'index', returning true if at least one message was handled.
+  bool drain(std::size_t index);
+  bool has_pending(std::size_t index) const;
+  void notify(Worker& worker);
+
+  Configuration configuration_;
   std::unordered_set<std::shared_ptr<Monitor>> monitors_;
-  std::unordered_map<std::uint8_t, std::shared_ptr<Vehicle>> vehicles_;
+  std::array<Slot, max_vehicles> vehicles_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<bool> running_{true};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> active_{0};
+  std::atomic<std::uint64_t> evicted_{0};
 };
 
 class LoggingVehicleTrackerMonitor : public VehicleTracker::Monitor {
@@ -0,0 +1,25 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/mavlink/vfr_hud.h>
+
+#include <iostream>
+
+std::ostream& operator<<(std::ostream& out, const airmap::mavlink::VfrHud& vfr_hud) {
+  return out << "(" << vfr_hud.airspeed << " [m/s]"
+             << "," << vfr_hud.groundspeed << " [m/s]"
+             << "," << vfr_hud.alt << " [m]"
+             << "," << vfr_hud.climb << " [m/s]"
+             << "," << vfr_hud.heading << " [°]"
+             << "," << vfr_hud.throttle << " [%]"
+             << ")";
+}
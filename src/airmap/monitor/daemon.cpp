@@ -17,6 +17,8 @@
 
 namespace {
 constexpr const char* component{"airmap::monitor::Daemon"};
+// Period of the sweep evicting vehicles that stopped sending heartbeats and expiring stale traffic tracks.
+constexpr std::int64_t eviction_interval_in_ms{1000};
 }  // namespace
 
 std::shared_ptr<airmap::monitor::Daemon> airmap::monitor::Daemon::create(const Configuration& configuration) {
@@ -31,13 +33,15 @@ std::shared_ptr<airmap::monitor::Daemon> airmap::monitor::Daemon::create(const C
 airmap::monitor::Daemon::Daemon(const Configuration& configuration)
     : configuration_{configuration},
       log_{configuration_.logger},
-      fan_out_traffic_monitor_{std::make_shared<FanOutTrafficMonitor>()},
+      fan_out_traffic_monitor_{std::make_shared<FanOutTrafficMonitor>(configuration_.traffic_state)},
       executor_{std::make_shared<airmap::grpc::server::Executor>(airmap::grpc::server::Executor::Configuration{
           configuration.context,
           configuration_.grpc_endpoint,
-          {std::make_shared<airmap::monitor::grpc::Service>(configuration_.logger, fan_out_traffic_monitor_)},
+          {std::make_shared<airmap::monitor::grpc::Service>(configuration_.logger, fan_out_traffic_monitor_,
+                                                          configuration_.grpc_service)},
           ::grpc::InsecureServerCredentials()})},
-      executor_worker_{[this]() { executor_->run(); }} {
+      executor_worker_{[this]() { executor_->run(); }},
+      vehicle_tracker_{configuration_.vehicle_tracker} {
 }
 
 std::shared_ptr<airmap::monitor::Daemon> airmap::monitor::Daemon::finalize() {
@@ -77,6 +81,29 @@ void airmap::monitor::Daemon::start() {
   mavlink_channel_subscription_ = configuration_.channel->subscribe(
       [sp = shared_from_this()](const mavlink_message_t& msg) { sp->handle_mavlink_message(msg); });
   configuration_.channel->start();
+  schedule_eviction();
+}
+
+void airmap::monitor::Daemon::schedule_eviction() {
+  configuration_.context->schedule_in(
+      [wp = std::weak_ptr<Daemon>{shared_from_this()}]() {
+        if (auto sp = wp.lock())
+          sp->handle_eviction_timeout();
+      },
+      Microseconds{milliseconds(eviction_interval_in_ms)});
+}
+
+void airmap::monitor::Daemon::handle_eviction_timeout() {
+  std::lock_guard<std::mutex> lg{vehicle_tracker_guard_};
+  if (auto evicted = vehicle_tracker_.evict_stale_vehicles()) {
+    log_.infof(component, "evicted %d stale vehicles, %d vehicles active, %d vehicles evicted in total", evicted,
+               vehicle_tracker_.active(), vehicle_tracker_.evicted());
+  }
+
+  if (auto expired = fan_out_traffic_monitor_->expire_stale_tracks())
+    log_.debugf(component, "expired %d stale traffic tracks", expired);
+
+  schedule_eviction();
 }
 
 void airmap::monitor::Daemon::handle_mavlink_message(const mavlink_message_t& msg) {
@@ -90,16 +117,25 @@ void airmap::monitor::Daemon::handle_mavlink_message(const mavlink_message_t& ms
               "  compid:   %d\n"
               "  msgid:    %d",
               msg.checksum, msg.magic, msg.len, msg.seq, msg.sysid, msg.compid, msg.msgid);
+  std::lock_guard<std::mutex> lg{vehicle_tracker_guard_};
   vehicle_tracker_.update(msg);
 }
 
 void airmap::monitor::Daemon::on_vehicle_added(const std::shared_ptr<mavlink::Vehicle>& vehicle) {
   auto submitter = TelemetrySubmitter::create(configuration_.credentials, configuration_.aircraft_id, log_.logger(),
-                                              configuration_.client, fan_out_traffic_monitor_);
+                                              configuration_.context, configuration_.client, fan_out_traffic_monitor_,
+                                              configuration_.telemetry_coalescing);
   vehicle->register_monitor(std::make_shared<mavlink::LoggingVehicleMonitor>(
-      component, log_.logger(), std::make_shared<SubmittingVehicleMonitor>(submitter)));
+      component, log_.logger(), std::make_shared<SubmittingVehicleMonitor>(configuration_.context, submitter)));
+  submitters_[vehicle] = submitter;
 }
 
-void airmap::monitor::Daemon::on_vehicle_removed(const std::shared_ptr<mavlink::Vehicle>&) {
-  // empty on purpose
+void airmap::monitor::Daemon::on_vehicle_removed(const std::shared_ptr<mavlink::Vehicle>& vehicle) {
+  auto it = submitters_.find(vehicle);
+  if (it == submitters_.end())
+    return;
+
+  // Ends flight comms and the flight, and drops the traffic subscription.
+  it->second->deactivate();
+  submitters_.erase(it);
 }
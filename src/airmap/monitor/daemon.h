@@ -23,12 +23,15 @@
 #include <airmap/mavlink/vehicle.h>
 #include <airmap/mavlink/vehicle_tracker.h>
 #include <airmap/monitor/fan_out_traffic_monitor.h>
+#include <airmap/monitor/grpc/service.h>
 
 #include <airmap/monitor/telemetry_submitter.h>
 #include <airmap/util/formatting_logger.h>
 
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace airmap {
 /// namespace monitor bundles up all types and functions used in running AirMap's monitor daemon.
@@ -50,6 +53,14 @@ class Daemon : public mavlink::VehicleTracker::Monitor, public std::enable_share
     std::shared_ptr<Context> context;           ///< Target context for incoming calls.
     std::shared_ptr<airmap::Client> client;     ///< The client used to communicate with the AirMap cloud services.
     std::string grpc_endpoint;                  ///< The local endpoint that the service should be exposed on.
+    /// Controls how telemetry updates are batched into packets.
+    TelemetryCoalescer::Configuration telemetry_coalescing{};
+    /// Controls whether vehicles are tracked synchronously or by a pool of workers.
+    mavlink::VehicleTracker::Configuration vehicle_tracker{};
+    /// Controls which traffic updates are forwarded to subscribers and when tracks expire.
+    TrafficStateStore::Configuration traffic_state{};
+    /// Controls how many updates are queued per gRPC client and how overflows are handled.
+    monitor::grpc::Service::Configuration grpc_service{};
   };
 
   // create returns a new Daemon instance ready for startup.
@@ -76,14 +87,22 @@ class Daemon : public mavlink::VehicleTracker::Monitor, public std::enable_share
 
   void handle_mavlink_message(const mavlink_message_t& msg);
 
+  /// schedule_eviction arms a timer on the context that periodically
+  /// evicts vehicles that stopped sending heartbeats and expires stale traffic tracks.
+  void schedule_eviction();
+  void handle_eviction_timeout();
+
   Configuration configuration_;
 
   util::FormattingLogger log_;
   std::shared_ptr<FanOutTrafficMonitor> fan_out_traffic_monitor_;
-  std::shared_ptr<grpc::server::Executor> executor_;
+  std::shared_ptr<airmap::grpc::server::Executor> executor_;
   std::thread executor_worker_;
   std::shared_ptr<mavlink::LoggingVehicleTrackerMonitor> vehicle_tracker_monitor_;
+  // Serializes updates coming in from the channel with the periodic eviction sweep.
+  std::mutex vehicle_tracker_guard_;
   mavlink::VehicleTracker vehicle_tracker_;
+  std::unordered_map<std::shared_ptr<mavlink::Vehicle>, std::shared_ptr<TelemetrySubmitter>> submitters_;
   mavlink::Channel::Subscription mavlink_channel_subscription_;
   mavlink::Channel::Subscription logging_channel_subscription_;
 };
@@ -12,6 +12,33 @@
 // limitations under the License.
 #include <airmap/monitor/fan_out_traffic_monitor.h>
 
+airmap::monitor::FanOutTrafficMonitor::FanOutTrafficMonitor(const TrafficStateStore::Configuration& configuration)
+    : state_{configuration} {
+}
+
+void airmap::monitor::FanOutTrafficMonitor::subscribe(const std::shared_ptr<DeltaSubscriber>& subscriber) {
+  std::lock_guard<std::mutex> lg{subscribers_guard_};
+  delta_subscribers_.insert(subscriber);
+}
+
+void airmap::monitor::FanOutTrafficMonitor::unsubscribe(const std::shared_ptr<DeltaSubscriber>& subscriber) {
+  std::lock_guard<std::mutex> lg{subscribers_guard_};
+  delta_subscribers_.erase(subscriber);
+}
+
+std::size_t airmap::monitor::FanOutTrafficMonitor::expire_stale_tracks(std::chrono::steady_clock::time_point now) {
+  TrafficStateStore::Delta delta;
+  {
+    std::lock_guard<std::mutex> lg{state_guard_};
+    delta = state_.expire(now);
+  }
+
+  if (!delta.empty())
+    dispatch(Traffic::Update::Type::unknown, delta);
+
+  return delta.expired.size();
+}
+
 void airmap::monitor::FanOutTrafficMonitor::subscribe(const std::shared_ptr<Traffic::Monitor::Subscriber>& subscriber) {
   std::lock_guard<std::mutex> lg{subscribers_guard_};
   subscribers_.insert(subscriber);
@@ -25,11 +52,38 @@ void airmap::monitor::FanOutTrafficMonitor::unsubscribe(
 
 void airmap::monitor::FanOutTrafficMonitor::handle_update(Traffic::Update::Type type,
                                                           const std::vector<Traffic::Update>& update) {
+  TrafficStateStore::Delta delta;
+  {
+    std::lock_guard<std::mutex> lg{state_guard_};
+    delta = state_.apply(type, update);
+  }
+
+  if (!delta.empty())
+    dispatch(type, delta);
+}
+
+void airmap::monitor::FanOutTrafficMonitor::dispatch(Traffic::Update::Type type,
+                                                     const TrafficStateStore::Delta& delta) {
   std::set<std::shared_ptr<Traffic::Monitor::Subscriber>> copy;
+  std::set<std::shared_ptr<DeltaSubscriber>> delta_copy;
   {
     std::lock_guard<std::mutex> lg{subscribers_guard_};
-    copy = subscribers_;
+    copy       = subscribers_;
+    delta_copy = delta_subscribers_;
   }
+
+  for (const auto& subscriber : delta_copy)
+    subscriber->handle_delta(type, delta);
+
+  // Subscribers to batches only learn about new and changed tracks.
+  if (copy.empty() || (delta.added.empty() && delta.changed.empty()))
+    return;
+
+  std::vector<Traffic::Update> batch;
+  batch.reserve(delta.added.size() + delta.changed.size());
+  batch.insert(batch.end(), delta.added.begin(), delta.added.end());
+  batch.insert(batch.end(), delta.changed.begin(), delta.changed.end());
+
   for (const auto& subscriber : copy)
-    subscriber->handle_update(type, update);
+    subscriber->handle_update(type, batch);
 }
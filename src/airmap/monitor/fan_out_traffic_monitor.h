@@ -15,6 +15,9 @@
 
 #include <airmap/traffic.h>
 
+#include <airmap/monitor/traffic_state_store.h>
+
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -23,8 +26,37 @@ namespace airmap {
 namespace monitor {
 
 // FanOutTrafficMonitor fans out incoming updates to all of its subscribers.
+//
+// Incoming updates pass through a TrafficStateStore first, such that updates of tracks
+// that did not change materially are dropped before reaching any subscriber. Subscribers
+// receive the remaining updates as a batch, DeltaSubscribers as a delta that also
+// reports expired tracks.
 class FanOutTrafficMonitor : public Traffic::Monitor::Subscriber, public Traffic::Monitor {
  public:
+  // DeltaSubscriber abstracts handling of changes to the set of known tracks.
+  class DeltaSubscriber {
+   public:
+    // handle_delta is invoked with the changes caused by a batch of updates of 'type'.
+    // Deltas reporting expired tracks carry Traffic::Update::Type::unknown.
+    virtual void handle_delta(Traffic::Update::Type type, const TrafficStateStore::Delta& delta) = 0;
+
+   protected:
+    DeltaSubscriber()          = default;
+    virtual ~DeltaSubscriber() = default;
+  };
+
+  // FanOutTrafficMonitor initializes a new instance, tracking state as configured by 'configuration'.
+  explicit FanOutTrafficMonitor(const TrafficStateStore::Configuration& configuration = {});
+
+  // subscribe registers 'subscriber' for deltas.
+  void subscribe(const std::shared_ptr<DeltaSubscriber>& subscriber);
+  // unsubscribe unregisters 'subscriber' from deltas.
+  void unsubscribe(const std::shared_ptr<DeltaSubscriber>& subscriber);
+
+  // expire_stale_tracks removes tracks that have not been updated for too long as of 'now',
+  // informing all DeltaSubscribers. Returns the number of expired tracks.
+  std::size_t expire_stale_tracks(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
   // From Traffic::Monitor
   void subscribe(const std::shared_ptr<Traffic::Monitor::Subscriber>& subscriber) override;
   void unsubscribe(const std::shared_ptr<Traffic::Monitor::Subscriber>& subscriber) override;
@@ -33,8 +65,15 @@ class FanOutTrafficMonitor : public Traffic::Monitor::Subscriber, public Traffic
   void handle_update(airmap::Traffic::Update::Type type, const std::vector<airmap::Traffic::Update>& update) override;
 
  protected:
+  // dispatch hands out 'delta' to all subscribers.
+  void dispatch(Traffic::Update::Type type, const TrafficStateStore::Delta& delta);
+
   std::mutex subscribers_guard_;
   std::set<std::shared_ptr<Traffic::Monitor::Subscriber>> subscribers_;
+  std::set<std::shared_ptr<DeltaSubscriber>> delta_subscribers_;
+
+  std::mutex state_guard_;
+  TrafficStateStore state_;
 };
 
 }  // namespace monitor
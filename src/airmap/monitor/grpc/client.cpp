@@ -90,12 +90,12 @@ void airmap::monitor::grpc::Client::ConnectToUpdatesInvocation::proceed(bool res
   switch (state_) {
     case State::ready:
       if (!result) {
-        context_->dispatch([cb = cb_]() { cb(ConnectToUpdates::Result{Error{"failed to connect to updates"}}); });
+        context_->schedule_out([cb = cb_]() { cb(ConnectToUpdates::Result{Error{"failed to connect to updates"}}); });
         state_ = State::finished;
         stream_->Finish(&status_, this);
       } else {
         update_stream_ = std::make_shared<UpdateStreamImpl>();
-        context_->dispatch([cb = cb_, us = update_stream_]() { cb(ConnectToUpdates::Result{us}); });
+        context_->schedule_out([cb = cb_, us = update_stream_]() { cb(ConnectToUpdates::Result{us}); });
         state_ = State::streaming;
         stream_->Read(&element_, this);
       }
@@ -113,7 +113,7 @@ void airmap::monitor::grpc::Client::ConnectToUpdatesInvocation::proceed(bool res
           u.traffic.push_back(to);
         }
 
-        context_->dispatch([us = update_stream_, u]() { us->write_update(u); });
+        context_->schedule_out([us = update_stream_, u]() { us->write_update(u); });
         stream_->Read(&element_, this);
       }
       break;
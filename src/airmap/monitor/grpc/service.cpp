@@ -14,13 +14,31 @@
 
 #include <airmap/codec/grpc/traffic.h>
 
+#include <grpc/support/time.h>
+
+#include <utility>
+
 namespace {
 constexpr const char* component{"airmap::monitor::grpc::Service"};
 }  // namespace
 
 airmap::monitor::grpc::Service::Service(const std::shared_ptr<Logger>& logger,
-                                        const std::shared_ptr<Traffic::Monitor>& traffic_monitor)
-    : log_{logger}, traffic_monitor_{traffic_monitor} {
+                                        const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor,
+                                        const Configuration& configuration)
+    : log_{logger},
+      traffic_monitor_{traffic_monitor},
+      configuration_{configuration},
+      registry_{std::make_shared<Registry>()} {
+}
+
+std::vector<airmap::monitor::grpc::Service::Statistics> airmap::monitor::grpc::Service::statistics() const {
+  std::vector<Statistics> result;
+
+  std::lock_guard<std::mutex> lg{registry_->guard};
+  for (auto invocation : registry_->invocations)
+    result.push_back(invocation->statistics());
+
+  return result;
 }
 
 ::grpc::Service& airmap::monitor::grpc::Service::instance() {
@@ -29,13 +47,18 @@ airmap::monitor::grpc::Service::Service(const std::shared_ptr<Logger>& logger,
 
 void airmap::monitor::grpc::Service::start(::grpc::ServerCompletionQueue& cq) {
   log_.infof(component, "starting to serve grpc.airmap.Monitor service");
-  ConnectToUpdates::start_listening(log_.logger(), &cq, &async_monitor_, traffic_monitor_);
+  ConnectToUpdates::start_listening(log_.logger(), &cq, &async_monitor_, traffic_monitor_, configuration_, registry_);
 }
 
 airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::Subscriber(ConnectToUpdates* invocation)
     : invocation_{invocation} {
 }
 
+void airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::detach() {
+  std::lock_guard<std::mutex> lg{guard_};
+  invocation_ = nullptr;
+}
+
 void airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::handle_update(
     airmap::Traffic::Update::Type type, const std::vector<airmap::Traffic::Update>& updates) {
   ::grpc::airmap::monitor::Update u;
@@ -44,55 +67,255 @@ void airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::handle_update
     codec::grpc::encode(*u.add_traffic(), update);
   }
 
-  invocation_->write(u);
+  forward(std::move(u));
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::handle_delta(airmap::Traffic::Update::Type,
+                                                                                const TrafficStateStore::Delta& delta) {
+  ::grpc::airmap::monitor::Update u;
+
+  for (const auto& update : delta.added)
+    codec::grpc::encode(*u.add_added(), update);
+  for (const auto& update : delta.changed)
+    codec::grpc::encode(*u.add_changed(), update);
+  for (const auto& id : delta.expired)
+    u.add_expired()->set_as_string(id);
+
+  forward(std::move(u));
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::Subscriber::forward(Result&& update) {
+  std::lock_guard<std::mutex> lg{guard_};
+  if (invocation_)
+    invocation_->enqueue(std::move(update));
+}
+
+airmap::monitor::grpc::Service::ConnectToUpdates::Event::Event(ConnectToUpdates* invocation, Handler handler)
+    : invocation_{invocation}, handler_{handler} {
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::Event::proceed(bool result) {
+  (invocation_->*handler_)(result);
 }
 
 void airmap::monitor::grpc::Service::ConnectToUpdates::start_listening(
     const std::shared_ptr<Logger>& logger, ::grpc::ServerCompletionQueue* completion_queue,
     ::grpc::airmap::monitor::Monitor::AsyncService* async_monitor,
-    const std::shared_ptr<Traffic::Monitor>& traffic_monitor) {
-  new ConnectToUpdates(logger, completion_queue, async_monitor, traffic_monitor);
+    const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor, const Configuration& configuration,
+    const std::shared_ptr<Registry>& registry) {
+  new ConnectToUpdates(logger, completion_queue, async_monitor, traffic_monitor, configuration, registry);
 }
 
 airmap::monitor::grpc::Service::ConnectToUpdates::ConnectToUpdates(
     const std::shared_ptr<Logger>& logger, ::grpc::ServerCompletionQueue* completion_queue,
     ::grpc::airmap::monitor::Monitor::AsyncService* async_monitor,
-    const std::shared_ptr<Traffic::Monitor>& traffic_monitor)
+    const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor, const Configuration& configuration,
+    const std::shared_ptr<Registry>& registry)
     : log_{logger},
       completion_queue_{completion_queue},
       async_monitor_{async_monitor},
       traffic_monitor_{traffic_monitor},
-      responder_{&server_context_} {
+      configuration_{configuration},
+      registry_{registry},
+      responder_{&server_context_},
+      queue_{configuration.max_queued_updates, configuration.overflow_policy} {
+  // Only delivered if the call starts, it tells about clients that went away without a failing write.
+  server_context_.AsyncNotifyWhenDone(&call_done_);
   async_monitor_->RequestConnectToUpdates(&server_context_, &parameters_, &responder_, completion_queue_,
                                           completion_queue_, this);
 }
 
-void airmap::monitor::grpc::Service::ConnectToUpdates::write(const ::grpc::airmap::monitor::Update& update) {
-  responder_.Write(update, this);
+void airmap::monitor::grpc::Service::ConnectToUpdates::destroy() {
+  release_subscriber();
+
+  {
+    std::lock_guard<std::mutex> lg{registry_->guard};
+    registry_->invocations.erase(this);
+  }
+
+  delete this;
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::release_subscriber() {
+  if (traffic_monitor_subscriber_) {
+    unsubscribe();
+    // Waits for updates being forwarded right now.
+    traffic_monitor_subscriber_->detach();
+    traffic_monitor_subscriber_.reset();
+  }
 }
 
-void airmap::monitor::grpc::Service::ConnectToUpdates::proceed(bool result) {
-  log_.debugf(component, "ConnectToUpdates::proceed: (%s, %s)", state_, result ? "true" : "false");
-  if (state_ == State::ready) {
-    start_listening(log_.logger(), completion_queue_, async_monitor_, traffic_monitor_);
+void airmap::monitor::grpc::Service::ConnectToUpdates::subscribe() {
+  if (parameters_.deltas()) {
+    traffic_monitor_->subscribe(std::shared_ptr<FanOutTrafficMonitor::DeltaSubscriber>{traffic_monitor_subscriber_});
+  } else {
+    traffic_monitor_->subscribe(std::shared_ptr<Traffic::Monitor::Subscriber>{traffic_monitor_subscriber_});
+  }
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::unsubscribe() {
+  if (parameters_.deltas()) {
+    traffic_monitor_->unsubscribe(std::shared_ptr<FanOutTrafficMonitor::DeltaSubscriber>{traffic_monitor_subscriber_});
+  } else {
+    traffic_monitor_->unsubscribe(std::shared_ptr<Traffic::Monitor::Subscriber>{traffic_monitor_subscriber_});
+  }
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::enqueue(Result&& update) {
+  std::lock_guard<std::mutex> lg{queue_guard_};
+
+  if (finish_requested_)
+    return;
+
+  if (!queue_.push(std::move(update))) {
+    log_.errorf(component, "write queue of %s overflowed, disconnecting", peer_);
+    request_finish(::grpc::Status{::grpc::StatusCode::RESOURCE_EXHAUSTED, "client does not keep up with updates"});
+    return;
+  }
+
+  if (!write_in_flight_)
+    wake_up();
+}
+
+airmap::monitor::grpc::Service::Statistics airmap::monitor::grpc::Service::ConnectToUpdates::statistics() const {
+  std::lock_guard<std::mutex> lg{queue_guard_};
+  return Statistics{peer_, queue_.size(), written_, queue_.dropped(), queue_.coalesced()};
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::handle_wakeup(bool) {
+  bool is_done{false};
+
+  {
+    std::lock_guard<std::mutex> lg{queue_guard_};
+    wakeup_pending_ = false;
+    write_next();
+    is_done = done();
+  }
+
+  if (is_done)
+    destroy();
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::handle_write(bool result) {
+  bool is_done{false};
+
+  {
+    std::lock_guard<std::mutex> lg{queue_guard_};
+    write_in_flight_ = false;
+
     if (result) {
-      state_                      = State::streaming;
-      traffic_monitor_subscriber_ = std::make_shared<Subscriber>(this);
-      traffic_monitor_->subscribe(traffic_monitor_subscriber_);
+      written_++;
     } else {
-      state_ = State::finished;
-      responder_.Finish(::grpc::Status::CANCELLED, this);
+      // The stream is broken, and we cancel it.
+      request_finish(::grpc::Status::CANCELLED);
     }
-  } else if (state_ == State::streaming) {
-    // We have encountered an error and cancel the streaming.
+
+    write_next();
+    is_done = done();
+  }
+
+  if (is_done)
+    destroy();
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::handle_done(bool) {
+  // A client that went away is not noticed before the next write fails, which might take
+  // long if no traffic is flowing. Its subscriber and queued updates are released right away.
+  auto cancelled = server_context_.IsCancelled();
+  if (cancelled)
+    release_subscriber();
+
+  bool is_done{false};
+
+  {
+    std::lock_guard<std::mutex> lg{queue_guard_};
+    call_done_pending_ = false;
+
+    if (cancelled)
+      request_finish(::grpc::Status::CANCELLED);
+
+    is_done = done();
+  }
+
+  if (is_done)
+    destroy();
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::wake_up() {
+  if (wakeup_pending_)
+    return;
+
+  wakeup_pending_ = true;
+  alarm_.Set(completion_queue_, gpr_now(GPR_CLOCK_MONOTONIC), &wakeup_);
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::request_finish(const ::grpc::Status& status) {
+  if (finish_requested_)
+    return;
+
+  finish_requested_ = true;
+  finish_status_    = status;
+  queue_.clear();
+
+  if (!write_in_flight_)
+    wake_up();
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::write_next() {
+  if (write_in_flight_ || finish_started_)
+    return;
+
+  if (finish_requested_) {
+    finish_started_ = true;
+    state_          = State::finished;
+    responder_.Finish(finish_status_, this);
+    return;
+  }
+
+  if (!queue_.pop(in_flight_))
+    return;
+
+  write_in_flight_ = true;
+  responder_.Write(in_flight_, &write_done_);
+}
+
+bool airmap::monitor::grpc::Service::ConnectToUpdates::done() const {
+  return finished_ && !write_in_flight_ && !wakeup_pending_ && !call_done_pending_;
+}
+
+void airmap::monitor::grpc::Service::ConnectToUpdates::proceed(bool result) {
+  log_.debugf(component, "ConnectToUpdates::proceed: (%s, %s)", state_, result ? "true" : "false");
+  if (state_ == State::ready) {
     if (!result) {
-      // After the subscriber has been unsubscribed, no more updates will come in
-      // from the traffic monitor. With that, we are good to clean up ourselves.
-      traffic_monitor_->unsubscribe(traffic_monitor_subscriber_);
-      state_ = State::finished;
-      responder_.Finish(::grpc::Status::CANCELLED, this);
+      // The server is shutting down. The call never started, there is nothing to finish and no one to listen for.
+      destroy();
+      return;
     }
+
+    start_listening(log_.logger(), completion_queue_, async_monitor_, traffic_monitor_, configuration_, registry_);
+    {
+      std::lock_guard<std::mutex> lg{queue_guard_};
+      peer_              = server_context_.peer();
+      state_             = State::streaming;
+      call_done_pending_ = true;
+    }
+    {
+      std::lock_guard<std::mutex> lg{registry_->guard};
+      registry_->invocations.insert(this);
+    }
+    traffic_monitor_subscriber_ = std::make_shared<Subscriber>(this);
+    subscribe();
   } else if (state_ == State::finished) {
-    delete this;
+    // Finish completed. Pending writes or wakeups might still be outstanding,
+    // and the last of them cleans up.
+    bool is_done{false};
+    {
+      std::lock_guard<std::mutex> lg{queue_guard_};
+      finished_ = true;
+      is_done   = done();
+    }
+
+    if (is_done)
+      destroy();
   }
 }
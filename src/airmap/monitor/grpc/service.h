@@ -15,33 +15,81 @@
 
 #include <airmap/grpc/method_invocation.h>
 #include <airmap/grpc/server/service.h>
+#include <airmap/monitor/grpc/update_queue.h>
 
 #include <airmap/aircrafts.h>
 #include <airmap/client.h>
 #include <airmap/logger.h>
+#include <airmap/monitor/fan_out_traffic_monitor.h>
 #include <airmap/traffic.h>
 
 #include <airmap/util/formatting_logger.h>
 
 #include "grpc/airmap/monitor/monitor.grpc.pb.h"
 
+#include <grpc++/alarm.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
 namespace airmap {
 namespace monitor {
 namespace grpc {
 /// Service exposes the daemon via gRPC.
 ///
 /// An instance subscribes to incoming traffic updates
-/// and forwards the updates to subscribers connected via gRPC.
+/// and forwards the updates to subscribers connected via gRPC,
+/// either as batches or, if requested, as deltas.
+///
+/// Every streaming invocation owns a bounded UpdateQueue of pending updates. Updates
+/// are enqueued from whatever thread delivers traffic, and written one at a time
+/// driven by the completion queue. If a client does not keep up and its queue is
+/// full, Configuration::overflow_policy decides how to make room.
 class Service : public airmap::grpc::server::Service {
  public:
-  /// Service initializes a new instance with 'traffic_monitor'
-  explicit Service(const std::shared_ptr<Logger>& logger, const std::shared_ptr<Traffic::Monitor>& traffic_monitor);
+  /// OverflowPolicy enumerates all known ways of handling a full write queue.
+  using OverflowPolicy = UpdateQueue::OverflowPolicy;
+
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::size_t max_queued_updates{64};                           ///< Upper bound on updates queued per client.
+    OverflowPolicy overflow_policy{OverflowPolicy::drop_oldest};  ///< Applied when a queue is full.
+  };
+
+  /// Statistics summarizes the write queue of a single connected client.
+  struct Statistics {
+    std::string peer;         ///< The address of the client.
+    std::size_t queue_depth;  ///< Number of updates currently queued.
+    std::uint64_t written;    ///< Number of updates written so far.
+    std::uint64_t dropped;    ///< Number of updates dropped by OverflowPolicy::drop_oldest.
+    std::uint64_t coalesced;  ///< Number of updates merged into others by OverflowPolicy::coalesce_latest.
+  };
+
+  /// Service initializes a new instance with 'traffic_monitor', handling writes as configured by 'configuration'.
+  explicit Service(const std::shared_ptr<Logger>& logger, const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor,
+                   const Configuration& configuration);
+
+  /// statistics returns a snapshot of the write queues of all connected clients.
+  std::vector<Statistics> statistics() const;
 
   // From airmap::grpc::server::Service.
   ::grpc::Service& instance() override;
   void start(::grpc::ServerCompletionQueue& completion_queue) override;
 
  private:
+  class ConnectToUpdates;
+
+  // Registry tracks all streaming invocations, such that their statistics can be collected.
+  struct Registry {
+    mutable std::mutex guard;
+    std::set<ConnectToUpdates*> invocations;
+  };
+
   // ConnectToUpdates models the state of a single invocation of
   // the method 'ConnectToUpdates'.
   class ConnectToUpdates : public airmap::grpc::MethodInvocation {
@@ -54,50 +102,137 @@ class Service : public airmap::grpc::server::Service {
     // for handling incoming requests.
     static void start_listening(const std::shared_ptr<Logger>& logger, ::grpc::ServerCompletionQueue* completion_qeueu,
                                 ::grpc::airmap::monitor::Monitor::AsyncService* async_monitor,
-                                const std::shared_ptr<Traffic::Monitor>& traffic_monitor);
+                                const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor,
+                                const Configuration& configuration, const std::shared_ptr<Registry>& registry);
+
+    // enqueue queues 'update' for writing, applying the overflow policy if the queue is full.
+    // Might be called from any thread.
+    void enqueue(Result&& update);
 
-    // write sends out 'update'.
-    void write(const ::grpc::airmap::monitor::Update& update);
+    // statistics returns a snapshot of the statistics of the write queue.
+    Statistics statistics() const;
 
     // From MethodInvocation
     void proceed(bool result) override;
 
    private:
-    // Subscriber handles incoming traffic updates and bridges them
-    // over to a Responder instance.
+    // Subscriber handles incoming traffic updates or deltas and bridges them
+    // over to a ConnectToUpdates instance.
     //
-    // Please note that the lifetime of a Subscriber instance has to be < than the lifetime
-    // of the responder instance.
-    class Subscriber : public Traffic::Monitor::Subscriber {
+    // Subscribers might still be invoked for a short while after having been
+    // unsubscribed. For that, the invocation detaches from its Subscriber before
+    // going away.
+    class Subscriber : public Traffic::Monitor::Subscriber, public FanOutTrafficMonitor::DeltaSubscriber {
      public:
-      // Subscriber initializes a new instance with 'responder'.
+      // Subscriber initializes a new instance with 'invocation'.
       explicit Subscriber(ConnectToUpdates* invocation);
 
+      // detach stops forwarding to the invocation.
+      void detach();
+
       // From Traffic::Monitor::Subscriber
       void handle_update(airmap::Traffic::Update::Type type,
                          const std::vector<airmap::Traffic::Update>& update) override;
 
+      // From FanOutTrafficMonitor::DeltaSubscriber
+      void handle_delta(airmap::Traffic::Update::Type type, const TrafficStateStore::Delta& delta) override;
+
+     private:
+      // forward hands 'update' to the invocation, unless detached.
+      void forward(Result&& update);
+
+      std::mutex guard_;
+      ConnectToUpdates* invocation_;
+    };
+
+    // Event tags a single kind of asynchronous operation of a ConnectToUpdates
+    // on the completion queue, dispatching its completion to 'handler'.
+    class Event : public airmap::grpc::MethodInvocation {
+     public:
+      using Handler = void (ConnectToUpdates::*)(bool);
+
+      explicit Event(ConnectToUpdates* invocation, Handler handler);
+
+      // From MethodInvocation
+      void proceed(bool result) override;
+
      private:
       ConnectToUpdates* invocation_;
+      Handler handler_;
     };
 
     ConnectToUpdates(const std::shared_ptr<Logger>& logger, ::grpc::ServerCompletionQueue* completion_queue,
                      ::grpc::airmap::monitor::Monitor::AsyncService* async_monitor,
-                     const std::shared_ptr<Traffic::Monitor>& traffic_monitor);
+                     const std::shared_ptr<FanOutTrafficMonitor>& traffic_monitor, const Configuration& configuration,
+                     const std::shared_ptr<Registry>& registry);
+
+    // destroy unsubscribes from traffic_monitor_ and deletes this instance, once
+    // no more operations are outstanding.
+    void destroy();
+    // release_subscriber unsubscribes from traffic_monitor_ and waits for updates
+    // being forwarded right now, if subscribed.
+    void release_subscriber();
+
+    // subscribe registers traffic_monitor_subscriber_ for batches or deltas, as requested by the caller.
+    void subscribe();
+    // unsubscribe undoes subscribe.
+    void unsubscribe();
+
+    // handle_wakeup is invoked on the completion queue after enqueue requested a write.
+    void handle_wakeup(bool result);
+    // handle_write is invoked on the completion queue when a write completed.
+    void handle_write(bool result);
+    // handle_done is invoked on the completion queue once the call ended, either
+    // because it finished or because the client went away.
+    void handle_done(bool result);
+
+    // wake_up arms alarm_ to post wakeup_ to the completion queue. Requires queue_guard_ to be held.
+    void wake_up();
+    // request_finish stops accepting updates and arranges for the stream to be ended
+    // with 'status' once no write is in flight. Requires queue_guard_ to be held.
+    void request_finish(const ::grpc::Status& status);
+    // write_next starts writing the next queued update, or ends the stream if requested.
+    // Requires queue_guard_ to be held.
+    void write_next();
+    // done returns true if no more operations are outstanding after the stream ended.
+    // Requires queue_guard_ to be held.
+    bool done() const;
 
     State state_{State::ready};
     util::FormattingLogger log_;
     ::grpc::ServerCompletionQueue* completion_queue_;
     ::grpc::airmap::monitor::Monitor::AsyncService* async_monitor_;
-    std::shared_ptr<Traffic::Monitor> traffic_monitor_;
+    std::shared_ptr<FanOutTrafficMonitor> traffic_monitor_;
+    Configuration configuration_;
+    std::shared_ptr<Registry> registry_;
     std::shared_ptr<Subscriber> traffic_monitor_subscriber_;
     ::grpc::ServerContext server_context_;
     Parameters parameters_;
     Responder responder_;
+
+    Event wakeup_{this, &ConnectToUpdates::handle_wakeup};
+    Event write_done_{this, &ConnectToUpdates::handle_write};
+    Event call_done_{this, &ConnectToUpdates::handle_done};
+    ::grpc::Alarm alarm_;
+
+    mutable std::mutex queue_guard_;
+    std::string peer_;
+    UpdateQueue queue_;
+    Result in_flight_;
+    bool write_in_flight_{false};
+    bool wakeup_pending_{false};
+    bool call_done_pending_{false};
+    bool finish_requested_{false};
+    bool finish_started_{false};
+    bool finished_{false};
+    ::grpc::Status finish_status_;
+    std::uint64_t written_{0};
   };
 
   util::FormattingLogger log_;
-  std::shared_ptr<Traffic::Monitor> traffic_monitor_;
+  std::shared_ptr<FanOutTrafficMonitor> traffic_monitor_;
+  Configuration configuration_;
+  std::shared_ptr<Registry> registry_;
   ::grpc::airmap::monitor::Monitor::AsyncService async_monitor_;
 };
 
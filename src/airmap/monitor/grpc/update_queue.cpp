@@ -0,0 +1,135 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/monitor/grpc/update_queue.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+airmap::monitor::grpc::UpdateQueue::UpdateQueue(std::size_t capacity, OverflowPolicy policy)
+    : capacity_{std::max<std::size_t>(capacity, 1)}, policy_{policy} {
+}
+
+bool airmap::monitor::grpc::UpdateQueue::push(Update&& update) {
+  if (updates_.size() >= capacity_) {
+    switch (policy_) {
+      case OverflowPolicy::drop_oldest:
+        updates_.pop_front();
+        dropped_++;
+        break;
+      case OverflowPolicy::coalesce_latest:
+        update = coalesce(updates_, update);
+        coalesced_ += updates_.size();
+        updates_.clear();
+        break;
+      case OverflowPolicy::disconnect:
+        return false;
+    }
+  }
+
+  updates_.push_back(std::move(update));
+  return true;
+}
+
+bool airmap::monitor::grpc::UpdateQueue::pop(Update& update) {
+  if (updates_.empty())
+    return false;
+
+  update = std::move(updates_.front());
+  updates_.pop_front();
+  return true;
+}
+
+void airmap::monitor::grpc::UpdateQueue::clear() {
+  updates_.clear();
+}
+
+std::size_t airmap::monitor::grpc::UpdateQueue::size() const {
+  return updates_.size();
+}
+
+std::uint64_t airmap::monitor::grpc::UpdateQueue::dropped() const {
+  return dropped_;
+}
+
+std::uint64_t airmap::monitor::grpc::UpdateQueue::coalesced() const {
+  return coalesced_;
+}
+
+airmap::monitor::grpc::UpdateQueue::Update airmap::monitor::grpc::coalesce(
+    const std::deque<UpdateQueue::Update>& queued, const UpdateQueue::Update& latest) {
+  using TrafficUpdate = ::grpc::airmap::Traffic_Update;
+
+  struct Track {
+    bool full;          // The track was reported in full mode.
+    bool known_before;  // The client knew about the track before the first merged delta.
+    bool expired;       // The track expired in the last merged delta mentioning it.
+    TrafficUpdate latest;
+  };
+
+  std::vector<std::string> order;
+  std::unordered_map<std::string, Track> tracks;
+
+  auto track = [&order, &tracks](const std::string& id, bool known_before) -> Track& {
+    auto it = tracks.find(id);
+    if (it == tracks.end()) {
+      order.push_back(id);
+      it = tracks.emplace(id, Track{false, known_before, false, TrafficUpdate{}}).first;
+    }
+    return it->second;
+  };
+
+  auto merge = [&track](const UpdateQueue::Update& update) {
+    for (const auto& u : update.traffic()) {
+      auto& t  = track(u.track().as_string(), true);
+      t.full   = true;
+      t.latest = u;
+    }
+    for (const auto& u : update.added()) {
+      auto& t   = track(u.track().as_string(), false);
+      t.expired = false;
+      t.latest  = u;
+    }
+    for (const auto& u : update.changed()) {
+      auto& t   = track(u.track().as_string(), true);
+      t.expired = false;
+      t.latest  = u;
+    }
+    for (const auto& id : update.expired())
+      track(id.as_string(), true).expired = true;
+  };
+
+  for (const auto& update : queued)
+    merge(update);
+  merge(latest);
+
+  UpdateQueue::Update result;
+  for (const auto& id : order) {
+    const auto& t = tracks.at(id);
+    if (t.full) {
+      *result.add_traffic() = t.latest;
+    } else if (t.expired) {
+      // Tracks that came and went within the merged deltas are never reported.
+      if (t.known_before)
+        result.add_expired()->set_as_string(id);
+    } else if (t.known_before) {
+      *result.add_changed() = t.latest;
+    } else {
+      *result.add_added() = t.latest;
+    }
+  }
+
+  return result;
+}
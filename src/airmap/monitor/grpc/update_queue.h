@@ -0,0 +1,81 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_MONITOR_GRPC_UPDATE_QUEUE_H_
+#define AIRMAP_MONITOR_GRPC_UPDATE_QUEUE_H_
+
+#include "grpc/airmap/monitor/monitor.pb.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace airmap {
+namespace monitor {
+namespace grpc {
+
+/// UpdateQueue bounds the updates waiting to be written to a single client.
+///
+/// If a client does not keep up and the queue is full, the OverflowPolicy
+/// decides how to make room. Instances are not thread-safe.
+class UpdateQueue {
+ public:
+  using Update = ::grpc::airmap::monitor::Update;
+
+  /// OverflowPolicy enumerates all known ways of handling a full queue.
+  enum class OverflowPolicy {
+    drop_oldest,      ///< Drops the oldest queued update.
+    coalesce_latest,  ///< Merges all queued updates, keeping the latest state of every track.
+    disconnect        ///< Ends the stream with RESOURCE_EXHAUSTED.
+  };
+
+  /// UpdateQueue initializes a new instance holding at most 'capacity' updates,
+  /// applying 'policy' once full.
+  explicit UpdateQueue(std::size_t capacity, OverflowPolicy policy);
+
+  /// push queues 'update', making room as required by the overflow policy. Returns false
+  /// and leaves the queue untouched if it is full and the policy asks for disconnecting.
+  bool push(Update&& update);
+
+  /// pop moves the oldest queued update to 'update', returning false if the queue is empty.
+  bool pop(Update& update);
+
+  /// clear drops all queued updates, without accounting for them as dropped.
+  void clear();
+
+  /// size returns the number of updates currently queued.
+  std::size_t size() const;
+
+  /// dropped returns the number of updates dropped by OverflowPolicy::drop_oldest.
+  std::uint64_t dropped() const;
+
+  /// coalesced returns the number of updates merged into others by OverflowPolicy::coalesce_latest.
+  std::uint64_t coalesced() const;
+
+ private:
+  std::size_t capacity_;
+  OverflowPolicy policy_;
+  std::deque<Update> updates_;
+  std::uint64_t dropped_{0};
+  std::uint64_t coalesced_{0};
+};
+
+/// coalesce merges 'queued' and 'latest', in order, into a single update carrying the
+/// latest state of every track. In delta mode, the result describes the net change
+/// across all merged deltas.
+UpdateQueue::Update coalesce(const std::deque<UpdateQueue::Update>& queued, const UpdateQueue::Update& latest);
+
+}  // namespace grpc
+}  // namespace monitor
+}  // namespace airmap
+
+#endif  // AIRMAP_MONITOR_GRPC_UPDATE_QUEUE_H_
@@ -13,8 +13,8 @@
 #include <airmap/monitor/submitting_vehicle_monitor.h>
 
 airmap::monitor::SubmittingVehicleMonitor::SubmittingVehicleMonitor(
-    const std::shared_ptr<TelemetrySubmitter>& submitter)
-    : submitter_{submitter} {
+    const std::shared_ptr<Context>& context, const std::shared_ptr<TelemetrySubmitter>& submitter)
+    : context_{context}, submitter_{submitter} {
 }
 
 void airmap::monitor::SubmittingVehicleMonitor::on_system_status_changed(const Optional<mavlink::State>& old_state,
@@ -26,7 +26,7 @@ void airmap::monitor::SubmittingVehicleMonitor::on_system_status_changed(const O
       case MAV_STATE_CALIBRATING:
       case MAV_STATE_STANDBY:
         if (new_state == MAV_STATE_ACTIVE) {
-          submitter_->activate();
+          context_->schedule_in([sp = submitter_]() { sp->activate(); });
         }
         break;
       case MAV_STATE_ACTIVE:
@@ -37,7 +37,7 @@ void airmap::monitor::SubmittingVehicleMonitor::on_system_status_changed(const O
           case MAV_STATE_BOOT:
           case MAV_STATE_CALIBRATING:
           case MAV_STATE_STANDBY:
-            submitter_->deactivate();
+            context_->schedule_in([sp = submitter_]() { sp->deactivate(); });
             break;
         }
         break;
@@ -49,9 +49,25 @@ void airmap::monitor::SubmittingVehicleMonitor::on_system_status_changed(const O
 
 void airmap::monitor::SubmittingVehicleMonitor::on_position_changed(
     const Optional<mavlink::GlobalPositionInt>& old_position, const mavlink::GlobalPositionInt& new_position) {
-  submitter_->submit(new_position);
+  context_->schedule_in([sp = submitter_, new_position]() { sp->submit(new_position); });
+}
+
+void airmap::monitor::SubmittingVehicleMonitor::on_attitude_changed(const Optional<mavlink::Attitude>&,
+                                                                    const mavlink::Attitude& new_attitude) {
+  context_->schedule_in([sp = submitter_, new_attitude]() { sp->submit(new_attitude); });
+}
+
+void airmap::monitor::SubmittingVehicleMonitor::on_vfr_hud_changed(const Optional<mavlink::VfrHud>&,
+                                                                   const mavlink::VfrHud&) {
+  // Velocity is submitted from the NED components of GLOBAL_POSITION_INT, VFR_HUD
+  // only carries the scalar ground speed and climb rate.
+}
+
+void airmap::monitor::SubmittingVehicleMonitor::on_pressure_changed(const Optional<mavlink::ScaledPressure>&,
+                                                                    const mavlink::ScaledPressure& new_pressure) {
+  context_->schedule_in([sp = submitter_, new_pressure]() { sp->submit(new_pressure); });
 }
 
 void airmap::monitor::SubmittingVehicleMonitor::on_mission_received(const airmap::Geometry& geometry) {
-  submitter_->set_mission_geometry(geometry);
+  context_->schedule_in([sp = submitter_, geometry]() { sp->set_mission_geometry(geometry); });
 }
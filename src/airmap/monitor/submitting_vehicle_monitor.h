@@ -13,6 +13,7 @@
 #ifndef AIRMAP_MONITOR_SUBMITTING_VEHICLE_MONITOR_H_
 #define AIRMAP_MONITOR_SUBMITTING_VEHICLE_MONITOR_H_
 
+#include <airmap/context.h>
 #include <airmap/mavlink/vehicle.h>
 #include <airmap/monitor/telemetry_submitter.h>
 
@@ -28,25 +29,36 @@ namespace monitor {
 ///   - vehicle becomes active
 ///     - create flight
 ///     - start flight comms
-///   - new position estimate
+///   - new position, attitude or pressure estimate
 ///     - if vehicle active:
 ///       - submit telemetry
 ///   - vehicle becomes inactive
 ///     - end flight comms
 ///     - end flight
+///
+/// Vehicles might report changes from any thread, e.g., from the workers of a
+/// mavlink::VehicleTracker in fleet mode. All calls into the submitter are thus
+/// scheduled into the context the submitter runs on.
 class SubmittingVehicleMonitor : public mavlink::Vehicle::Monitor {
  public:
-  /// SubmittingVehicleMonitor initializes a new instance with 'submitter'.
-  explicit SubmittingVehicleMonitor(const std::shared_ptr<TelemetrySubmitter>& submitter);
+  /// SubmittingVehicleMonitor initializes a new instance with 'submitter', running on 'context'.
+  explicit SubmittingVehicleMonitor(const std::shared_ptr<Context>& context,
+                                    const std::shared_ptr<TelemetrySubmitter>& submitter);
 
   // From Vehicle::Monitor
   void on_system_status_changed(const Optional<mavlink::State>& old_state, mavlink::State new_state) override;
   void on_position_changed(const Optional<mavlink::GlobalPositionInt>& old_position,
                            const mavlink::GlobalPositionInt& new_position) override;
+  void on_attitude_changed(const Optional<mavlink::Attitude>& old_attitude,
+                           const mavlink::Attitude& new_attitude) override;
+  void on_vfr_hud_changed(const Optional<mavlink::VfrHud>& old_vfr_hud, const mavlink::VfrHud& new_vfr_hud) override;
+  void on_pressure_changed(const Optional<mavlink::ScaledPressure>& old_pressure,
+                           const mavlink::ScaledPressure& new_pressure) override;
   void on_mission_received(const airmap::Geometry& geometry) override;
 
  private:
   /// @cond
+  std::shared_ptr<Context> context_;
   std::shared_ptr<TelemetrySubmitter> submitter_;
   /// @endcond
 };
@@ -0,0 +1,102 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/monitor/telemetry_coalescer.h>
+
+#include <airmap/rest/telemetry.h>
+
+std::shared_ptr<airmap::monitor::TelemetryCoalescer> airmap::monitor::TelemetryCoalescer::create(
+    const Configuration& configuration, const std::shared_ptr<Context>& context, const Flusher& flusher) {
+  return std::shared_ptr<TelemetryCoalescer>{new TelemetryCoalescer{configuration, context, flusher}};
+}
+
+airmap::monitor::TelemetryCoalescer::TelemetryCoalescer(const Configuration& configuration,
+                                                        const std::shared_ptr<Context>& context,
+                                                        const Flusher& flusher)
+    : configuration_{configuration}, context_{context}, flusher_{flusher} {
+}
+
+void airmap::monitor::TelemetryCoalescer::add(const Telemetry::Update& update) {
+  const auto size = rest::detail::PacketBuilder::encoded_size(update);
+
+  std::vector<Telemetry::Update> batch;
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+
+    // A sample that does not fit into the current batch goes out with the next one.
+    if (!pending_.empty() && pending_size_ + size > configuration_.max_payload_size)
+      take(batch);
+
+    pending_.push_back(update);
+    pending_size_ += size;
+
+    if (pending_.size() == 1)
+      schedule_flush(generation_);
+  }
+
+  if (!batch.empty())
+    flusher_(batch);
+}
+
+void airmap::monitor::TelemetryCoalescer::flush() {
+  std::vector<Telemetry::Update> batch;
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    take(batch);
+  }
+
+  if (batch.empty())
+    return;
+
+  flusher_(batch);
+  batch.clear();
+
+  // Hand the storage back to keep the steady state free of allocations.
+  std::lock_guard<std::mutex> lg{guard_};
+  if (pending_.empty())
+    pending_.swap(batch);
+}
+
+void airmap::monitor::TelemetryCoalescer::take(std::vector<Telemetry::Update>& batch) {
+  // Bumping the generation invalidates the timer armed for the batch we are taking over.
+  ++generation_;
+  batch.swap(pending_);
+  pending_size_ = 0;
+}
+
+void airmap::monitor::TelemetryCoalescer::clear() {
+  std::lock_guard<std::mutex> lg{guard_};
+  ++generation_;
+  pending_.clear();
+  pending_size_ = 0;
+}
+
+void airmap::monitor::TelemetryCoalescer::schedule_flush(std::uint64_t generation) {
+  context_->schedule_in(
+      [wp = std::weak_ptr<TelemetryCoalescer>{shared_from_this()}, generation]() {
+        if (auto sp = wp.lock())
+          sp->handle_flush_timeout(generation);
+      },
+      configuration_.flush_interval);
+}
+
+void airmap::monitor::TelemetryCoalescer::handle_flush_timeout(std::uint64_t generation) {
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    if (generation != generation_)
+      return;
+  }
+
+  flush();
+}
@@ -0,0 +1,89 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_MONITOR_TELEMETRY_COALESCER_H_
+#define AIRMAP_MONITOR_TELEMETRY_COALESCER_H_
+
+#include <airmap/context.h>
+#include <airmap/date_time.h>
+#include <airmap/do_not_copy_or_move.h>
+#include <airmap/telemetry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace airmap {
+namespace monitor {
+
+/// TelemetryCoalescer buffers individual telemetry updates and hands them
+/// out in batches, such that a single packet carries all samples collected
+/// within one flush interval.
+///
+/// A batch is flushed when either:
+///   - the flush interval elapsed since the first sample entered an empty batch, or
+///   - adding another sample would grow its encoded payload beyond Configuration::max_payload_size.
+///
+/// Packets add the flight header, the iv and up to one block of padding to the payload,
+/// see rest::detail::PacketBuilder::packet_size. The default leaves room for flight ids
+/// of up to 150 bytes within the minimum IPv6 MTU.
+class TelemetryCoalescer : DoNotCopyOrMove, public std::enable_shared_from_this<TelemetryCoalescer> {
+ public:
+  /// Flusher is invoked with the updates of a complete batch.
+  using Flusher = std::function<void(const std::vector<Telemetry::Update>&)>;
+
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    Microseconds flush_interval{milliseconds(200)};  ///< Upper bound on the time a sample stays buffered.
+    std::size_t max_payload_size{1024};               ///< Upper bound on the encoded payload of a batch in [bytes].
+  };
+
+  /// create returns a new TelemetryCoalescer instance, scheduling timers on 'context'
+  /// and handing out batches to 'flusher'.
+  static std::shared_ptr<TelemetryCoalescer> create(const Configuration& configuration,
+                                                    const std::shared_ptr<Context>& context, const Flusher& flusher);
+
+  /// add buffers 'update', flushing the current batch first if 'update' does not fit.
+  void add(const Telemetry::Update& update);
+
+  /// flush hands out all buffered updates immediately.
+  void flush();
+
+  /// clear drops all buffered updates without flushing them.
+  void clear();
+
+ private:
+  explicit TelemetryCoalescer(const Configuration& configuration, const std::shared_ptr<Context>& context,
+                              const Flusher& flusher);
+
+  // take moves the current batch to 'batch'. Requires guard_ to be held.
+  void take(std::vector<Telemetry::Update>& batch);
+  void schedule_flush(std::uint64_t generation);
+  void handle_flush_timeout(std::uint64_t generation);
+
+  Configuration configuration_;
+  std::shared_ptr<Context> context_;
+  Flusher flusher_;
+
+  std::mutex guard_;
+  std::uint64_t generation_{0};
+  std::vector<Telemetry::Update> pending_;
+  std::size_t pending_size_{0};
+};
+
+}  // namespace monitor
+}  // namespace airmap
+
+#endif  // AIRMAP_MONITOR_TELEMETRY_COALESCER_H_
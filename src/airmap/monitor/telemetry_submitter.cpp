@@ -16,6 +16,8 @@
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include <cmath>
+
 namespace uuids = boost::uuids;
 
 namespace {
@@ -24,10 +26,12 @@ constexpr const char* component{"airmap::monitor::TelemetrySubmitter"};
 
 std::shared_ptr<airmap::monitor::TelemetrySubmitter> airmap::monitor::TelemetrySubmitter::create(
     const Credentials& credentials, const std::string& aircraft_id, const std::shared_ptr<Logger>& logger,
-    const std::shared_ptr<airmap::Client>& client,
-    const std::shared_ptr<Traffic::Monitor::Subscriber>& traffic_subscriber) {
+    const std::shared_ptr<Context>& context, const std::shared_ptr<airmap::Client>& client,
+    const std::shared_ptr<Traffic::Monitor::Subscriber>& traffic_subscriber,
+    const TelemetryCoalescer::Configuration& coalescing) {
   return std::shared_ptr<airmap::monitor::TelemetrySubmitter>{
-      new airmap::monitor::TelemetrySubmitter{credentials, aircraft_id, logger, client, traffic_subscriber}};
+      new airmap::monitor::TelemetrySubmitter{credentials, aircraft_id, logger, client, traffic_subscriber}}
+      ->finalize(context, coalescing);
 }
 
 airmap::monitor::TelemetrySubmitter::TelemetrySubmitter(
@@ -41,6 +45,16 @@ airmap::monitor::TelemetrySubmitter::TelemetrySubmitter(
       aircraft_id_{aircraft_id} {
 }
 
+std::shared_ptr<airmap::monitor::TelemetrySubmitter> airmap::monitor::TelemetrySubmitter::finalize(
+    const std::shared_ptr<Context>& context, const TelemetryCoalescer::Configuration& coalescing) {
+  coalescer_ = TelemetryCoalescer::create(
+      coalescing, context, [wp = std::weak_ptr<TelemetrySubmitter>{shared_from_this()}](const auto& updates) {
+        if (auto sp = wp.lock())
+          sp->handle_flush(updates);
+      });
+  return shared_from_this();
+}
+
 void airmap::monitor::TelemetrySubmitter::activate() {
   state_ = State::active;
   request_authorization();
@@ -54,8 +68,27 @@ void airmap::monitor::TelemetrySubmitter::deactivate() {
   if (state_ == State::inactive)
     return;
 
+  // Hand out whatever is still buffered while the flight is still known.
+  coalescer_->flush();
+
   state_ = State::inactive;
 
+  if (traffic_monitor_)
+    traffic_monitor_.get()->unsubscribe(traffic_subscriber_);
+
+  if (authorization_ && flight_ && encryption_key_) {
+    Flights::EndFlightCommunications::Parameters parameters;
+    parameters.id = flight_.get().id;
+
+    client_->flights().end_flight_communications(parameters, [sp = shared_from_this()](const auto& result) {
+      if (!result) {
+        sp->log_.errorf(component, "failed to end flight communications: %s", result.error());
+      } else {
+        sp->log_.infof(component, "successfully ended flight communications");
+      }
+    });
+  }
+
   if (authorization_ && flight_) {
     Flights::EndFlight::Parameters parameters;
     parameters.id            = flight_.get().id;
@@ -69,6 +102,10 @@ void airmap::monitor::TelemetrySubmitter::deactivate() {
     });
   }
 
+  // The flight is over, there is no need to keep its telemetry session around.
+  if (flight_)
+    client_->telemetry().end_session(flight_.get());
+
   authorization_requested_      = false;
   pilot_id_requested_           = false;
   active_flights_requested_     = false;
@@ -96,10 +133,43 @@ void airmap::monitor::TelemetrySubmitter::submit(const mavlink::GlobalPositionIn
     return;
   }
 
-  client_->telemetry().submit_updates(flight_.get(), encryption_key_.get(),
-                                      {Telemetry::Update{Telemetry::Position{
-                                          milliseconds_since_epoch(Clock::universal_time()), position.lat / 1E7,
-                                          position.lon / 1E7, position.alt / 1E3, position.relative_alt / 1E3, 2.}}});
+  auto timestamp = milliseconds_since_epoch(Clock::universal_time());
+
+  // GLOBAL_POSITION_INT carries the NED velocity alongside the position, and both
+  // end up in the same batch.
+  coalescer_->add(Telemetry::Update{Telemetry::Position{timestamp, position.lat / 1E7, position.lon / 1E7,
+                                                        position.alt / 1E3, position.relative_alt / 1E3, 2.}});
+  coalescer_->add(Telemetry::Update{Telemetry::Speed{timestamp, static_cast<float>(position.vx / 1E2),
+                                                     static_cast<float>(position.vy / 1E2),
+                                                     static_cast<float>(position.vz / 1E2)}});
+}
+
+void airmap::monitor::TelemetrySubmitter::submit(const mavlink::Attitude& attitude) {
+  if (state_ == State::inactive || !flight_ || !encryption_key_)
+    return;
+
+  static constexpr float degrees_per_radian = 180.f / M_PI;
+
+  coalescer_->add(Telemetry::Update{Telemetry::Attitude{milliseconds_since_epoch(Clock::universal_time()),
+                                                        attitude.yaw * degrees_per_radian,
+                                                        attitude.pitch * degrees_per_radian,
+                                                        attitude.roll * degrees_per_radian}});
+}
+
+void airmap::monitor::TelemetrySubmitter::submit(const mavlink::ScaledPressure& pressure) {
+  if (state_ == State::inactive || !flight_ || !encryption_key_)
+    return;
+
+  // SCALED_PRESSURE reports [hPa], Telemetry::Barometer expects [Pa].
+  coalescer_->add(Telemetry::Update{
+      Telemetry::Barometer{milliseconds_since_epoch(Clock::universal_time()), pressure.press_abs * 100.f}});
+}
+
+void airmap::monitor::TelemetrySubmitter::handle_flush(const std::vector<Telemetry::Update>& updates) {
+  if (state_ == State::inactive || !flight_ || !encryption_key_)
+    return;
+
+  client_->telemetry().submit_updates(flight_.get(), encryption_key_.get(), updates);
 }
 
 void airmap::monitor::TelemetrySubmitter::request_authorization() {
@@ -156,7 +226,6 @@ void airmap::monitor::TelemetrySubmitter::request_pilot_id() {
 
   if (authorization_) {
     Pilots::Authenticated::Parameters params;
-    params.authorization = authorization_.get();
     client_->pilots().authenticated(params, [sp = shared_from_this()](const auto& result) {
       if (result) {
         sp->handle_request_pilot_id_finished(result.value().id);
@@ -219,8 +288,7 @@ void airmap::monitor::TelemetrySubmitter::request_end_active_flights() {
 
   for (const auto& flight : active_flights_.get()) {
     Flights::EndFlight::Parameters params;
-    params.authorization = authorization_.get();
-    params.id            = flight.id;
+    params.id = flight.id;
 
     client_->flights().end_flight(params, [sp = shared_from_this(), id = flight.id](const auto& result) {
       if (result) {
@@ -267,9 +335,8 @@ void airmap::monitor::TelemetrySubmitter::request_create_flight_plan() {
   if (current_position_) {
     if (mission_geometry_) {
       FlightPlans::Create::Parameters params;
-      params.authorization = authorization_.get();
-      params.latitude      = current_position_.get().lat / 1E7;
-      params.longitude     = current_position_.get().lon / 1E7;
+      params.latitude  = current_position_.get().lat / 1E7;
+      params.longitude = current_position_.get().lon / 1E7;
       if (!aircraft_id_.empty())
         params.aircraft = Pilot::Aircraft{aircraft_id_};
       params.pilot            = Pilot{pilot_id_.get()};
@@ -293,9 +360,8 @@ void airmap::monitor::TelemetrySubmitter::request_create_flight_plan() {
       });
     } else {
       Flights::CreateFlight::Parameters params;
-      params.authorization = authorization_.get();
-      params.latitude      = current_position_.get().lat / 1E7;
-      params.longitude     = current_position_.get().lon / 1E7;
+      params.latitude  = current_position_.get().lat / 1E7;
+      params.longitude = current_position_.get().lon / 1E7;
       params.aircraft_id   = aircraft_id_;
       params.start_time    = Clock::universal_time();
       params.end_time      = params.start_time + hours(1);
@@ -15,6 +15,7 @@
 
 #include <airmap/authenticator.h>
 #include <airmap/client.h>
+#include <airmap/context.h>
 #include <airmap/credentials.h>
 #include <airmap/flight.h>
 #include <airmap/flight_plan.h>
@@ -27,11 +28,15 @@
 #include <airmap/telemetry.h>
 #include <airmap/traffic.h>
 
+#include <airmap/mavlink/attitude.h>
 #include <airmap/mavlink/global_position_int.h>
+#include <airmap/mavlink/scaled_pressure.h>
+#include <airmap/monitor/telemetry_coalescer.h>
 #include <airmap/util/formatting_logger.h>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace airmap {
 namespace monitor {
@@ -55,10 +60,14 @@ class TelemetrySubmitter : public std::enable_shared_from_this<TelemetrySubmitte
   };
 
   /// create returns a new TelemetrySubmitter instance.
+  ///
+  /// Telemetry updates are coalesced according to 'coalescing' and
+  /// flushed from timers running on 'context'.
   static std::shared_ptr<TelemetrySubmitter> create(
       const Credentials& credentials, const std::string& aircraft_id, const std::shared_ptr<Logger>& logger,
-      const std::shared_ptr<airmap::Client>& client,
-      const std::shared_ptr<Traffic::Monitor::Subscriber>& traffic_subscriber);
+      const std::shared_ptr<Context>& context, const std::shared_ptr<airmap::Client>& client,
+      const std::shared_ptr<Traffic::Monitor::Subscriber>& traffic_subscriber,
+      const TelemetryCoalescer::Configuration& coalescing);
   /// activate transitions an instance to State::active.
   ///
   /// The following sequence of actions is triggered:
@@ -70,13 +79,23 @@ class TelemetrySubmitter : public std::enable_shared_from_this<TelemetrySubmitte
   /// deactivate transitions an instance to State::inactive.
   ///
   /// The following sequence of actions is triggered:
+  ///   * flush buffered telemetry updates
   ///   * request to end flight communications
   ///   * request to end the flight
+  ///   * unsubscribe from traffic updates
   void deactivate();
 
-  /// submit requests an instance to submit a telemetry update.
+  /// submit requests an instance to submit a position and speed update.
+  ///
+  /// Updates are buffered and submitted in batches, see TelemetryCoalescer.
   void submit(const mavlink::GlobalPositionInt&);
 
+  /// submit requests an instance to submit an attitude update.
+  void submit(const mavlink::Attitude&);
+
+  /// submit requests an instance to submit a barometer update.
+  void submit(const mavlink::ScaledPressure&);
+
   /// set_mission_geometry announces the mission geometry.
   void set_mission_geometry(const Geometry& geometry);
 
@@ -85,6 +104,13 @@ class TelemetrySubmitter : public std::enable_shared_from_this<TelemetrySubmitte
                               const std::shared_ptr<Logger>& logger, const std::shared_ptr<airmap::Client>& client,
                               const std::shared_ptr<Traffic::Monitor::Subscriber>& traffic_subscriber);
 
+  /// finalize sets up all internal event connections that require
+  /// shared_from_this() to work properly.
+  std::shared_ptr<TelemetrySubmitter> finalize(const std::shared_ptr<Context>& context,
+                                               const TelemetryCoalescer::Configuration& coalescing);
+
+  void handle_flush(const std::vector<Telemetry::Update>& updates);
+
   void request_authorization();
   void handle_request_authorization_finished(std::string authorization);
 
@@ -125,7 +151,9 @@ class TelemetrySubmitter : public std::enable_shared_from_this<TelemetrySubmitte
   std::shared_ptr<Traffic::Monitor::Subscriber> traffic_subscriber_;
   Credentials credentials_;
   std::string aircraft_id_;
+  std::shared_ptr<TelemetryCoalescer> coalescer_;
 
+  Optional<std::string> authorization_;
   Optional<mavlink::GlobalPositionInt> current_position_;
   Optional<std::vector<Flight>> active_flights_;
   Optional<FlightPlan> flight_plan_;
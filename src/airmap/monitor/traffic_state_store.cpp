@@ -0,0 +1,99 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/monitor/traffic_state_store.h>
+
+#include <airmap/util/cheap_ruler.h>
+
+#include <cmath>
+
+bool airmap::monitor::TrafficStateStore::Delta::empty() const {
+  return added.empty() && changed.empty() && expired.empty();
+}
+
+airmap::monitor::TrafficStateStore::TrafficStateStore(const Configuration& configuration)
+    : configuration_{configuration} {
+}
+
+airmap::monitor::TrafficStateStore::Delta airmap::monitor::TrafficStateStore::apply(
+    Traffic::Update::Type type, const std::vector<Traffic::Update>& updates,
+    std::chrono::steady_clock::time_point now) {
+  Delta delta;
+
+  for (const auto& update : updates) {
+    auto it = tracks_.find(update.id);
+
+    if (it == tracks_.end()) {
+      tracks_.emplace(update.id, Track{update, now, now});
+      delta.added.push_back(update);
+      continue;
+    }
+
+    auto& track   = it->second;
+    track.seen_at = now;
+
+    if (type == Traffic::Update::Type::alert || changed_materially(track, update, now)) {
+      track.forwarded    = update;
+      track.forwarded_at = now;
+      delta.changed.push_back(update);
+    } else {
+      dropped_++;
+    }
+  }
+
+  return delta;
+}
+
+airmap::monitor::TrafficStateStore::Delta airmap::monitor::TrafficStateStore::expire(
+    std::chrono::steady_clock::time_point now) {
+  Delta delta;
+
+  for (auto it = tracks_.begin(); it != tracks_.end();) {
+    if (now - it->second.seen_at < configuration_.track_timeout) {
+      ++it;
+      continue;
+    }
+
+    delta.expired.push_back(it->first);
+    it = tracks_.erase(it);
+  }
+
+  return delta;
+}
+
+std::size_t airmap::monitor::TrafficStateStore::size() const {
+  return tracks_.size();
+}
+
+std::uint64_t airmap::monitor::TrafficStateStore::dropped() const {
+  return dropped_;
+}
+
+bool airmap::monitor::TrafficStateStore::changed_materially(const Track& track, const Traffic::Update& update,
+                                                             std::chrono::steady_clock::time_point now) const {
+  const auto& forwarded = track.forwarded;
+
+  // A repeated datum never carries new information.
+  if (update.recorded == forwarded.recorded && update.latitude == forwarded.latitude &&
+      update.longitude == forwarded.longitude && update.altitude == forwarded.altitude)
+    return false;
+
+  if (std::abs(update.altitude - forwarded.altitude) >= configuration_.altitude_threshold)
+    return true;
+
+  util::CheapRuler ruler{forwarded.latitude};
+  if (ruler.distance({forwarded.latitude, forwarded.longitude, {}, {}}, {update.latitude, update.longitude, {}, {}}) >=
+      configuration_.position_threshold)
+    return true;
+
+  return update.recorded != forwarded.recorded && now - track.forwarded_at >= configuration_.refresh_interval;
+}
@@ -0,0 +1,97 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_MONITOR_TRAFFIC_STATE_STORE_H_
+#define AIRMAP_MONITOR_TRAFFIC_STATE_STORE_H_
+
+#include <airmap/traffic.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace airmap {
+namespace monitor {
+
+/// TrafficStateStore keeps the last forwarded state of every traffic track, keyed by Traffic::Update::id,
+/// and sorts incoming updates into new, materially changed and unchanged tracks.
+///
+/// Situational awareness updates of a known track are dropped unless:
+///   - the track moved by at least Configuration::position_threshold horizontally
+///     or Configuration::altitude_threshold vertically since it was last forwarded, or
+///   - Configuration::refresh_interval elapsed since it was last forwarded, and its
+///     recorded time advanced.
+/// Alerts are never dropped. Tracks without any update for Configuration::track_timeout
+/// are removed by expire, which is meant to be invoked periodically.
+///
+/// TrafficStateStore is not thread-safe.
+class TrafficStateStore {
+ public:
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    double position_threshold{10.};            ///< Horizontal movement in [m] that changes a track materially.
+    double altitude_threshold{10.};            ///< Vertical movement in [m] that changes a track materially.
+    std::chrono::seconds refresh_interval{5};  ///< Unchanged tracks are forwarded at least this often.
+    std::chrono::seconds track_timeout{30};    ///< Tracks without updates for this long expire.
+  };
+
+  /// Delta describes the changes to the set of tracks caused by a batch of updates or by expiry.
+  struct Delta {
+    std::vector<Traffic::Update> added;    ///< Updates for tracks that were not known before.
+    std::vector<Traffic::Update> changed;  ///< Updates for known tracks that changed materially.
+    std::vector<std::string> expired;      ///< Ids of tracks that expired.
+
+    /// empty returns true if the delta does not carry any changes.
+    bool empty() const;
+  };
+
+  /// TrafficStateStore initializes a new instance with 'configuration'.
+  explicit TrafficStateStore(const Configuration& configuration);
+
+  /// apply merges 'updates' of 'type' received at 'now' into the store, returning
+  /// the new and materially changed tracks.
+  Delta apply(Traffic::Update::Type type, const std::vector<Traffic::Update>& updates,
+              std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /// expire removes all tracks that did not receive an update for Configuration::track_timeout
+  /// as of 'now', returning a delta listing their ids.
+  Delta expire(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+  /// size returns the number of tracks known to the store.
+  std::size_t size() const;
+
+  /// dropped returns the number of updates dropped so far.
+  std::uint64_t dropped() const;
+
+ private:
+  struct Track {
+    Traffic::Update forwarded;                           // The state last handed out.
+    std::chrono::steady_clock::time_point forwarded_at;  // When the state was last handed out.
+    std::chrono::steady_clock::time_point seen_at;       // When the track was last updated.
+  };
+
+  // changed_materially returns true if 'update' differs materially from the state last forwarded for 'track'.
+  bool changed_materially(const Track& track, const Traffic::Update& update,
+                          std::chrono::steady_clock::time_point now) const;
+
+  Configuration configuration_;
+  std::unordered_map<std::string, Track> tracks_;
+  std::uint64_t dropped_{0};
+};
+
+}  // namespace monitor
+}  // namespace airmap
+
+#endif  // AIRMAP_MONITOR_TRAFFIC_STATE_STORE_H_
@@ -0,0 +1,110 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/dns/resolver_cache.h>
+
+#include <algorithm>
+
+using tcp = boost::asio::ip::tcp;
+
+std::shared_ptr<airmap::net::dns::ResolverCache> airmap::net::dns::ResolverCache::create(
+    const Configuration& configuration, const std::shared_ptr<::boost::asio::io_service>& io_service) {
+  return std::shared_ptr<ResolverCache>{new ResolverCache{configuration, io_service}};
+}
+
+airmap::net::dns::ResolverCache::ResolverCache(const Configuration& configuration,
+                                               const std::shared_ptr<::boost::asio::io_service>& io_service)
+    : configuration_{configuration}, io_service_{io_service}, resolver_{*io_service_} {
+}
+
+void airmap::net::dns::ResolverCache::resolve(const std::string& host, const Callback& cb) {
+  // Address literals do not need a lookup.
+  ::boost::system::error_code ec;
+  auto address = ::boost::asio::ip::make_address(host, ec);
+  if (!ec) {
+    io_service_->post([cb, address]() { cb(Result{Addresses{address}}); });
+    return;
+  }
+
+  std::lock_guard<std::mutex> lg{guard_};
+
+  const auto now = std::chrono::steady_clock::now();
+  auto& entry    = entries_[host];
+
+  if (entry.resolved && now < entry.expires_at) {
+    if (entry.result && !entry.in_flight && entry.expires_at - now < configuration_.refresh_ahead)
+      start_resolve(host, entry);
+
+    io_service_->post([cb, result = entry.result]() { cb(result); });
+    return;
+  }
+
+  entry.waiting.push_back(cb);
+  if (!entry.in_flight)
+    start_resolve(host, entry);
+}
+
+void airmap::net::dns::ResolverCache::invalidate(const std::string& host) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  auto it = entries_.find(host);
+  if (it != entries_.end())
+    it->second.resolved = false;
+}
+
+void airmap::net::dns::ResolverCache::start_resolve(const std::string& host, Entry& entry) {
+  entry.in_flight = true;
+  resolver_.async_resolve(tcp::resolver::query{host, "0", tcp::resolver::query::numeric_service},
+                          [sp = shared_from_this(), host](const auto& ec, auto it) { sp->handle_resolve(host, ec, it); });
+}
+
+void airmap::net::dns::ResolverCache::handle_resolve(const std::string& host, const ::boost::system::error_code& ec,
+                                                     tcp::resolver::iterator it) {
+  std::unique_lock<std::mutex> ul{guard_};
+
+  const auto now = std::chrono::steady_clock::now();
+  auto& entry    = entries_[host];
+
+  entry.in_flight = false;
+
+  if (ec) {
+    // We keep on handing out the addresses we know about if a
+    // refresh fails, and try again after negative_ttl.
+    if (!entry.resolved || !entry.result) {
+      entry.result = Result{Error{"failed to resolve host"}
+                                .description(ec.message())
+                                .value(Error::Value{std::string{"host"}}, Error::Value{host})};
+    }
+    entry.expires_at = now + configuration_.negative_ttl;
+  } else {
+    Addresses addresses;
+    for (; it != tcp::resolver::iterator{}; ++it) {
+      auto address = it->endpoint().address();
+      if (std::find(addresses.begin(), addresses.end(), address) == addresses.end())
+        addresses.push_back(address);
+    }
+
+    entry.result     = Result{addresses};
+    entry.expires_at = now + configuration_.ttl;
+  }
+
+  entry.resolved = true;
+
+  auto waiting = std::move(entry.waiting);
+  entry.waiting.clear();
+  auto result = entry.result;
+
+  ul.unlock();
+
+  for (const auto& cb : waiting)
+    cb(result);
+}
@@ -0,0 +1,100 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_DNS_RESOLVER_CACHE_H_
+#define AIRMAP_NET_DNS_RESOLVER_CACHE_H_
+
+#include <airmap/do_not_copy_or_move.h>
+#include <airmap/error.h>
+#include <airmap/outcome.h>
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace airmap {
+namespace net {
+namespace dns {
+
+/// ResolverCache resolves host names to addresses, caching results such
+/// that the HTTP, UDP and MQTT stacks talking to the same hosts share
+/// lookups instead of hitting the network for every operation.
+///
+/// - Successful lookups are cached for Configuration::ttl.
+/// - Failed lookups are cached for Configuration::negative_ttl.
+/// - Entries used within Configuration::refresh_ahead of their expiry are
+///   refreshed in the background, while callers keep on getting the cached
+///   addresses. A failed refresh keeps the previous addresses around.
+/// - Concurrent lookups for the same host share one in-flight resolve.
+///
+/// Addresses are cached per host, independent of the port and transport
+/// of the eventual connection.
+class ResolverCache : DoNotCopyOrMove, public std::enable_shared_from_this<ResolverCache> {
+ public:
+  using Addresses = std::vector<::boost::asio::ip::address>;
+  using Result    = Outcome<Addresses, Error>;
+  using Callback  = std::function<void(const Result&)>;
+
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::chrono::seconds ttl{300};           ///< Resolved addresses are fresh for ttl.
+    std::chrono::seconds negative_ttl{5};    ///< Failed lookups are not retried for negative_ttl.
+    std::chrono::seconds refresh_ahead{60};  ///< Entries used within refresh_ahead of expiry are refreshed.
+  };
+
+  /// create returns a new ResolverCache instance resolving on 'io_service'.
+  static std::shared_ptr<ResolverCache> create(const Configuration& configuration,
+                                               const std::shared_ptr<::boost::asio::io_service>& io_service);
+
+  /// resolve hands the addresses of 'host' to 'cb'. 'cb' is always invoked on the io_service.
+  void resolve(const std::string& host, const Callback& cb);
+
+  /// invalidate drops the cached addresses of 'host', for example
+  /// after all connection attempts to them failed.
+  void invalidate(const std::string& host);
+
+ private:
+  struct Entry {
+    Result result{Error{"not resolved yet"}};
+    std::chrono::steady_clock::time_point expires_at;
+    bool resolved{false};
+    bool in_flight{false};
+    std::vector<Callback> waiting;
+  };
+
+  explicit ResolverCache(const Configuration& configuration,
+                         const std::shared_ptr<::boost::asio::io_service>& io_service);
+
+  // start_resolve kicks off a lookup of 'host'. Requires guard_ to be held.
+  void start_resolve(const std::string& host, Entry& entry);
+  void handle_resolve(const std::string& host, const ::boost::system::error_code& ec,
+                      ::boost::asio::ip::tcp::resolver::iterator it);
+
+  Configuration configuration_;
+  std::shared_ptr<::boost::asio::io_service> io_service_;
+  ::boost::asio::ip::tcp::resolver resolver_;
+
+  std::mutex guard_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace dns
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_DNS_RESOLVER_CACHE_H_
@@ -12,92 +12,66 @@
 // limitations under the License.
 #include <airmap/net/http/authorized_requester.h>
 #include <airmap/net/http/jwt_provider.h>
-#include <airmap/util/fmt.h>
 
 constexpr const char* component{"authorized_requester"};
 
-namespace fmt = airmap::util::fmt;
-
 airmap::net::http::AuthorizedRequester::AuthorizedRequester(const std::string& api_key,
                                                             const std::shared_ptr<Requester>& next,
                                                             Optional<JWTProvider *> token_provider)
-    : api_key_{api_key}, next_{next}, token_provider_{token_provider} {
+    : api_key_{api_key}, token_provider_{token_provider}, next_{next} {
 }
 
 void airmap::net::http::AuthorizedRequester::delete_(const std::string& path,
                                                      std::unordered_map<std::string, std::string>&& query,
                                                      std::unordered_map<std::string, std::string>&& headers,
                                                      Callback cb) {
-  headers["X-API-Key"] = api_key_;
-
-  auto next_task = [path, query = std::move(query), headers = std::move(headers), cb, next = next_](Optional<std::string> token) mutable {
-    if(token) {
-      headers["Authorization"] = fmt::sprintf("Bearer %s", token);
-    }
+  authorize(std::move(headers), [path, query = std::move(query), cb, next = next_](
+                                    std::unordered_map<std::string, std::string>&& headers) mutable {
     next->delete_(path, std::move(query), std::move(headers), cb);
-  };
-
-  if (token_provider_) {
-    token_provider_.get()->perform_with_auth(next_task);
-  }
-  else {
-    next_task(Optional<std::string>());
-  }
+  });
 }
+
 void airmap::net::http::AuthorizedRequester::get(const std::string& path,
                                                  std::unordered_map<std::string, std::string>&& query,
                                                  std::unordered_map<std::string, std::string>&& headers, Callback cb) {
-  headers["X-API-Key"] = api_key_;
-
-  auto next_task = [path, query = std::move(query), headers = std::move(headers), cb, next = next_](Optional<std::string> token) mutable {
-    if(token) {
-      headers["Authorization"] = fmt::sprintf("Bearer %s", token);
-    }
+  authorize(std::move(headers), [path, query = std::move(query), cb, next = next_](
+                                    std::unordered_map<std::string, std::string>&& headers) mutable {
     next->get(path, std::move(query), std::move(headers), cb);
-  };
-
-  if (token_provider_) {
-    token_provider_.get()->perform_with_auth(next_task);
-  }
-  else {
-    next_task(Optional<std::string>());
-  }
+  });
 }
+
 void airmap::net::http::AuthorizedRequester::patch(const std::string& path,
                                                    std::unordered_map<std::string, std::string>&& headers,
                                                    const std::string& body, Callback cb) {
-  headers["X-API-Key"] = api_key_;
-
-  auto next_task = [path, headers = std::move(headers), body = std::move(body), cb, next = next_](Optional<std::string> token) mutable {
-    if(token) {
-      headers["Authorization"] = fmt::sprintf("Bearer %s", token);
-    }
-    next->patch(path, std::move(headers), std::move(body), cb);
-  };
-
-  if (token_provider_) {
-    token_provider_.get()->perform_with_auth(next_task);
-  }
-  else {
-    next_task(Optional<std::string>());
-  }
+  authorize(std::move(headers),
+            [path, body, cb, next = next_](std::unordered_map<std::string, std::string>&& headers) {
+              next->patch(path, std::move(headers), body, cb);
+            });
 }
+
 void airmap::net::http::AuthorizedRequester::post(const std::string& path,
                                                   std::unordered_map<std::string, std::string>&& headers,
                                                   const std::string& body, Callback cb) {
-  headers["X-API-Key"] = api_key_;
+  authorize(std::move(headers),
+            [path, body, cb, next = next_](std::unordered_map<std::string, std::string>&& headers) {
+              next->post(path, std::move(headers), body, cb);
+            });
+}
 
-  auto next_task = [path, headers = std::move(headers), body = std::move(body), cb, next = next_](Optional<std::string> token) mutable {
-    if(token) {
-      headers["Authorization"] = fmt::sprintf("Bearer %s", token);
-    }
-    next->post(path, std::move(headers), std::move(body), cb);
-  };
+void airmap::net::http::AuthorizedRequester::authorize(std::unordered_map<std::string, std::string>&& headers,
+                                                       const Continuation& next_task) {
+  headers["X-API-Key"] = api_key_;
 
-  if (token_provider_) {
-    token_provider_.get()->perform_with_auth(next_task);
-  }
-  else {
-    next_task(Optional<std::string>());
+  if (!token_provider_) {
+    next_task(std::move(headers));
+    return;
   }
+
+  token_provider_.get()->perform_with_auth(
+      [headers = std::move(headers), next_task](Optional<std::string> token) mutable {
+        if (token) {
+          headers["Authorization"] = "Bearer " + token.get();
+        }
+        next_task(std::move(headers));
+      });
 }
@@ -17,6 +17,7 @@
 #include <airmap/net/http/jwt_provider.h>
 #include <airmap/util/formatting_logger.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -26,7 +27,8 @@ namespace http {
 
 class AuthorizedRequester : public http::Requester {
  public:
-  explicit AuthorizedRequester(const std::string& api_key, const std::shared_ptr<Requester>& next, Optional<JWTProvider *> token_provider);
+  explicit AuthorizedRequester(const std::string& api_key, const std::shared_ptr<Requester>& next,
+                               Optional<JWTProvider *> token_provider);
 
   void delete_(const std::string& path, std::unordered_map<std::string, std::string>&& query,
                std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
@@ -38,6 +40,13 @@ class AuthorizedRequester : public http::Requester {
             Callback cb) override;
 
  private:
+  // Continuation receives the headers of a request, once credentials have been added.
+  using Continuation = std::function<void(std::unordered_map<std::string, std::string>&&)>;
+
+  // authorize adds the api key and, if available, the bearer token to 'headers',
+  // handing them to 'next_task' afterwards.
+  void authorize(std::unordered_map<std::string, std::string>&& headers, const Continuation& next_task);
+
   std::string api_key_;
   Optional<JWTProvider *> token_provider_;
   std::shared_ptr<Requester> next_;
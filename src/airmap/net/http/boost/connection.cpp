@@ -0,0 +1,110 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/boost/connection.h>
+
+namespace asio = boost::asio;
+namespace http = boost::beast::http;
+namespace ssl  = boost::asio::ssl;
+
+std::shared_ptr<airmap::net::http::boost::NonEncryptingConnection>
+airmap::net::http::boost::NonEncryptingConnection::create(
+    const std::shared_ptr<::boost::asio::io_service>& io_service) {
+  return std::shared_ptr<NonEncryptingConnection>{new NonEncryptingConnection{io_service}};
+}
+
+airmap::net::http::boost::NonEncryptingConnection::NonEncryptingConnection(
+    const std::shared_ptr<::boost::asio::io_service>& io_service)
+    : io_service_{io_service}, socket_{*io_service_} {
+}
+
+void airmap::net::http::boost::NonEncryptingConnection::async_connect(const ::boost::asio::ip::tcp::endpoint& endpoint,
+                                                                      const Handler& handler) {
+  socket_.async_connect(endpoint, handler);
+}
+
+void airmap::net::http::boost::NonEncryptingConnection::async_write(Request& request, const Handler& handler) {
+  ::http::async_write(socket_, request, [handler](const ::boost::system::error_code& ec, std::size_t) { handler(ec); });
+}
+
+void airmap::net::http::boost::NonEncryptingConnection::async_read(Response& response, const Handler& handler) {
+  ::http::async_read(socket_, buffer_, response,
+                     [handler](const ::boost::system::error_code& ec, std::size_t) { handler(ec); });
+}
+
+void airmap::net::http::boost::NonEncryptingConnection::close() {
+  ::boost::system::error_code ec;
+  socket_.shutdown(::asio::ip::tcp::socket::shutdown_both, ec);
+  socket_.close(ec);
+}
+
+bool airmap::net::http::boost::NonEncryptingConnection::is_open() const {
+  return socket_.is_open();
+}
+
+std::shared_ptr<airmap::net::http::boost::EncryptingConnection> airmap::net::http::boost::EncryptingConnection::create(
+    const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<TlsSessionCache>& session_cache) {
+  return std::shared_ptr<EncryptingConnection>{new EncryptingConnection{io_service, session_cache}};
+}
+
+airmap::net::http::boost::EncryptingConnection::EncryptingConnection(
+    const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<TlsSessionCache>& session_cache)
+    : io_service_{io_service},
+      ssl_context_{TlsSessionCache::ssl_context()},
+      session_cache_{session_cache},
+      socket_{*io_service_, *ssl_context_} {
+}
+
+void airmap::net::http::boost::EncryptingConnection::async_connect(const ::boost::asio::ip::tcp::endpoint& endpoint,
+                                                                   const Handler& handler) {
+  socket_.lowest_layer().async_connect(endpoint, [this, handler](const ::boost::system::error_code& ec) {
+    if (ec) {
+      handler(ec);
+      return;
+    }
+
+    session_cache_->prepare(socket_.native_handle());
+    socket_.async_handshake(::ssl::stream_base::client, [this, handler](const ::boost::system::error_code& ec) {
+      if (!ec)
+        session_cache_->record(socket_.native_handle());
+      handler(ec);
+    });
+  });
+}
+
+void airmap::net::http::boost::EncryptingConnection::async_write(Request& request, const Handler& handler) {
+  ::http::async_write(socket_, request, [handler](const ::boost::system::error_code& ec, std::size_t) { handler(ec); });
+}
+
+void airmap::net::http::boost::EncryptingConnection::async_read(Response& response, const Handler& handler) {
+  ::http::async_read(socket_, buffer_, response,
+                     [handler](const ::boost::system::error_code& ec, std::size_t) { handler(ec); });
+}
+
+void airmap::net::http::boost::EncryptingConnection::close() {
+  // We do not bother with a TLS close_notify: the connection is either idle
+  // and expired or already broken, and the peer copes with a plain close.
+  // A quiet shutdown keeps OpenSSL from marking the session as not resumable,
+  // which it otherwise does for connections torn down without a shutdown.
+  SSL_set_quiet_shutdown(socket_.native_handle(), 1);
+  SSL_shutdown(socket_.native_handle());
+
+  ::boost::system::error_code ec;
+  socket_.lowest_layer().shutdown(::asio::ip::tcp::socket::shutdown_both, ec);
+  socket_.lowest_layer().close(ec);
+}
+
+bool airmap::net::http::boost::EncryptingConnection::is_open() const {
+  return socket_.lowest_layer().is_open();
+}
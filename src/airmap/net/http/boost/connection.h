@@ -0,0 +1,119 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_BOOST_CONNECTION_H_
+#define AIRMAP_NET_HTTP_BOOST_CONNECTION_H_
+
+#include <airmap/do_not_copy_or_move.h>
+#include <airmap/net/http/boost/decoding_body.h>
+#include <airmap/net/http/boost/tls_session_cache.h>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace airmap {
+namespace net {
+namespace http {
+namespace boost {
+
+/// Connection models a stream to an HTTP server that outlives
+/// individual request/response exchanges.
+///
+/// Read buffers are owned by the connection, such that bytes received
+/// past the end of one response are available to the next one.
+class Connection : DoNotCopyOrMove {
+ public:
+  using Handler  = std::function<void(const ::boost::system::error_code&)>;
+  using Request  = ::boost::beast::http::request<::boost::beast::http::string_body>;
+  using Response = ::boost::beast::http::response<DecodingBody>;
+
+  /// async_connect establishes a connection to 'endpoint', including all
+  /// handshakes required by the transport, and invokes 'handler' when done.
+  virtual void async_connect(const ::boost::asio::ip::tcp::endpoint& endpoint, const Handler& handler) = 0;
+
+  /// async_write writes 'request' to the connection and invokes 'handler' when done.
+  /// 'request' must stay valid until 'handler' is invoked.
+  virtual void async_write(Request& request, const Handler& handler) = 0;
+
+  /// async_read reads the next response from the connection into 'response' and
+  /// invokes 'handler' when done. 'response' must stay valid until 'handler' is invoked.
+  virtual void async_read(Response& response, const Handler& handler) = 0;
+
+  /// close closes the connection, cancelling all outstanding operations.
+  virtual void close() = 0;
+
+  /// is_open returns true if the underlying socket is open.
+  virtual bool is_open() const = 0;
+
+ protected:
+  Connection() = default;
+};
+
+/// NonEncryptingConnection is a Connection talking plain HTTP over TCP.
+class NonEncryptingConnection : public Connection {
+ public:
+  static std::shared_ptr<NonEncryptingConnection> create(
+      const std::shared_ptr<::boost::asio::io_service>& io_service);
+
+  // From Connection
+  void async_connect(const ::boost::asio::ip::tcp::endpoint& endpoint, const Handler& handler) override;
+  void async_write(Request& request, const Handler& handler) override;
+  void async_read(Response& response, const Handler& handler) override;
+  void close() override;
+  bool is_open() const override;
+
+ private:
+  explicit NonEncryptingConnection(const std::shared_ptr<::boost::asio::io_service>& io_service);
+
+  std::shared_ptr<::boost::asio::io_service> io_service_;
+  ::boost::asio::ip::tcp::socket socket_;
+  ::boost::beast::flat_buffer buffer_{8192};
+};
+
+/// EncryptingConnection is a Connection talking HTTP over TLS.
+///
+/// All instances share the process-wide ssl::context, and resume
+/// sessions from 'session_cache' where possible.
+class EncryptingConnection : public Connection {
+ public:
+  static std::shared_ptr<EncryptingConnection> create(const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                                      const std::shared_ptr<TlsSessionCache>& session_cache);
+
+  // From Connection
+  void async_connect(const ::boost::asio::ip::tcp::endpoint& endpoint, const Handler& handler) override;
+  void async_write(Request& request, const Handler& handler) override;
+  void async_read(Response& response, const Handler& handler) override;
+  void close() override;
+  bool is_open() const override;
+
+ private:
+  explicit EncryptingConnection(const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                const std::shared_ptr<TlsSessionCache>& session_cache);
+
+  std::shared_ptr<::boost::asio::io_service> io_service_;
+  std::shared_ptr<::boost::asio::ssl::context> ssl_context_;
+  std::shared_ptr<TlsSessionCache> session_cache_;
+  ::boost::asio::ssl::stream<::boost::asio::ip::tcp::socket> socket_;
+  ::boost::beast::flat_buffer buffer_{8192};
+};
+
+}  // namespace boost
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_BOOST_CONNECTION_H_
@@ -0,0 +1,195 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/boost/connection_pool.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Upper bounds in [us] of the buckets of wait time histograms.
+const std::vector<std::uint64_t>& wait_time_bounds() {
+  static const std::vector<std::uint64_t> bounds{1000,    2000,    5000,    10000,   20000,   50000,  100000,
+                                                 200000,  500000,  1000000, 2000000, 5000000, 10000000};
+  return bounds;
+}
+
+}  // namespace
+
+constexpr std::size_t airmap::net::http::boost::ConnectionPool::priority_count;
+
+std::shared_ptr<airmap::net::http::boost::ConnectionPool> airmap::net::http::boost::ConnectionPool::create(
+    const Configuration& configuration, const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const ConnectionFactory& connection_factory) {
+  return std::shared_ptr<ConnectionPool>{new ConnectionPool{configuration, io_service, connection_factory}};
+}
+
+airmap::net::http::boost::ConnectionPool::ConnectionPool(const Configuration& configuration,
+                                                         const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                                         const ConnectionFactory& connection_factory)
+    : configuration_{configuration},
+      io_service_{io_service},
+      connection_factory_{connection_factory},
+      wait_times_(priority_count, util::Histogram{wait_time_bounds()}),
+      sweeper_{*io_service_} {
+}
+
+void airmap::net::http::boost::ConnectionPool::acquire(Priority priority, const AcquireHandler& handler) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  auto now = std::chrono::steady_clock::now();
+  auto p   = static_cast<std::size_t>(priority);
+
+  close_expired(now);
+
+  // Most recently used connections are the least likely to have been
+  // closed by the server in the meantime.
+  while (!idle_.empty()) {
+    auto connection = std::move(idle_.back().connection);
+    idle_.pop_back();
+
+    if (connection->is_open()) {
+      hand_out(p, now, handler, connection, true);
+      return;
+    }
+  }
+
+  if (active_ < configuration_.max_connections) {
+    hand_out(p, now, handler, connection_factory_(), false);
+    return;
+  }
+
+  waiting_[p].push_back(Waiting{handler, now});
+}
+
+void airmap::net::http::boost::ConnectionPool::release(const std::shared_ptr<Connection>& connection,
+                                                       bool keep_alive) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  --active_;
+
+  if (keep_alive && connection->is_open()) {
+    if (serve_waiting(connection, true))
+      return;
+
+    idle_.push_back(Idle{connection, std::chrono::steady_clock::now()});
+    schedule_sweep();
+    return;
+  }
+
+  connection->close();
+
+  if (anybody_waiting())
+    serve_waiting(connection_factory_(), false);
+}
+
+std::size_t airmap::net::http::boost::ConnectionPool::idle() const {
+  std::lock_guard<std::mutex> lg{guard_};
+  return idle_.size();
+}
+
+std::size_t airmap::net::http::boost::ConnectionPool::active() const {
+  std::lock_guard<std::mutex> lg{guard_};
+  return active_;
+}
+
+std::vector<airmap::net::http::boost::ConnectionPool::Statistics>
+airmap::net::http::boost::ConnectionPool::statistics() const {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  std::vector<Statistics> result;
+  for (std::size_t p = 0; p < priority_count; p++)
+    result.push_back(Statistics{static_cast<Priority>(p), waiting_[p].size(), wait_times_[p]});
+
+  return result;
+}
+
+void airmap::net::http::boost::ConnectionPool::hand_out(std::size_t priority,
+                                                        std::chrono::steady_clock::time_point since,
+                                                        const AcquireHandler& handler,
+                                                        const std::shared_ptr<Connection>& connection, bool reused) {
+  auto waited = std::chrono::steady_clock::now() - since;
+  wait_times_[priority].add(std::chrono::duration_cast<std::chrono::microseconds>(waited).count());
+
+  ++active_;
+  io_service_->post([handler, connection, reused]() { handler(connection, reused); });
+}
+
+bool airmap::net::http::boost::ConnectionPool::anybody_waiting() const {
+  return std::any_of(waiting_.begin(), waiting_.end(), [](const std::deque<Waiting>& w) { return !w.empty(); });
+}
+
+bool airmap::net::http::boost::ConnectionPool::serve_waiting(const std::shared_ptr<Connection>& connection,
+                                                             bool reused) {
+  auto p = std::find_if(waiting_.begin(), waiting_.end(), [](const std::deque<Waiting>& w) { return !w.empty(); });
+  if (p == waiting_.end())
+    return false;
+
+  // The longest waiting acquisition of a lower priority, if any.
+  auto lower = waiting_.end();
+  for (auto it = std::next(p); it != waiting_.end(); ++it) {
+    if (!it->empty() && (lower == waiting_.end() || it->front().since < lower->front().since))
+      lower = it;
+  }
+
+  if (lower == waiting_.end()) {
+    consecutive_grants_ = 0;
+  } else if (consecutive_grants_ >= configuration_.max_consecutive_grants) {
+    consecutive_grants_ = 0;
+    p                   = lower;
+  } else {
+    ++consecutive_grants_;
+  }
+
+  auto waiting = std::move(p->front());
+  p->pop_front();
+  hand_out(std::distance(waiting_.begin(), p), waiting.since, waiting.handler, connection, reused);
+  return true;
+}
+
+void airmap::net::http::boost::ConnectionPool::close_expired(std::chrono::steady_clock::time_point now) {
+  const std::chrono::microseconds timeout{configuration_.idle_timeout.total_microseconds()};
+
+  while (!idle_.empty() && now - idle_.front().since >= timeout) {
+    idle_.front().connection->close();
+    idle_.pop_front();
+  }
+}
+
+void airmap::net::http::boost::ConnectionPool::schedule_sweep() {
+  if (sweep_scheduled_ || idle_.empty())
+    return;
+
+  // The oldest idle connection is the first one to expire.
+  const std::chrono::microseconds timeout{configuration_.idle_timeout.total_microseconds()};
+  const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+      idle_.front().since + timeout - std::chrono::steady_clock::now());
+
+  sweep_scheduled_ = true;
+  sweeper_.expires_from_now(::boost::posix_time::microseconds(std::max<std::int64_t>(remaining.count(), 0)));
+  sweeper_.async_wait([wp = std::weak_ptr<ConnectionPool>{shared_from_this()}](const ::boost::system::error_code& ec) {
+    if (auto sp = wp.lock())
+      sp->handle_sweep(ec);
+  });
+}
+
+void airmap::net::http::boost::ConnectionPool::handle_sweep(const ::boost::system::error_code& ec) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  sweep_scheduled_ = false;
+  if (ec == ::boost::asio::error::operation_aborted)
+    return;
+
+  close_expired(std::chrono::steady_clock::now());
+  schedule_sweep();
+}
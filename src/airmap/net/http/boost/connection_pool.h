@@ -0,0 +1,160 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_BOOST_CONNECTION_POOL_H_
+#define AIRMAP_NET_HTTP_BOOST_CONNECTION_POOL_H_
+
+#include <airmap/date_time.h>
+#include <airmap/do_not_copy_or_move.h>
+#include <airmap/net/http/boost/connection.h>
+#include <airmap/util/histogram.h>
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace airmap {
+namespace net {
+namespace http {
+namespace boost {
+
+/// ConnectionPool keeps connections to a single host alive across requests.
+///
+/// Callers acquire a connection, run exactly one request/response exchange
+/// on it and release it again, indicating whether the server agreed to keep
+/// the connection alive. Connections that stay idle for longer than the
+/// configured timeout are closed. At most Configuration::max_connections are
+/// open at any point in time, which caps the number of requests in flight to
+/// the host. Further acquisitions wait for a release and are served by priority,
+/// in order of arrival within the same priority. To keep lower priorities from
+/// starving, the longest waiting acquisition of a lower priority is served after
+/// Configuration::max_consecutive_grants consecutive grants to a higher one.
+class ConnectionPool : DoNotCopyOrMove, public std::enable_shared_from_this<ConnectionPool> {
+ public:
+  /// ConnectionFactory creates a new, unconnected Connection.
+  using ConnectionFactory = std::function<std::shared_ptr<Connection>()>;
+  /// AcquireHandler is invoked with an acquired connection. 'reused' is true
+  /// if the connection is already established and has carried an exchange before.
+  using AcquireHandler = std::function<void(const std::shared_ptr<Connection>& connection, bool reused)>;
+
+  /// Priority orders acquisitions waiting for a connection.
+  ///
+  /// All requesters talking to a host share its pool. Flight-critical calls
+  /// thus skip ahead of bulk queries waiting for a connection to the same host,
+  /// and searches backing maps do not hold up anything else.
+  enum class Priority {
+    high   = 0,  ///< Safety-relevant calls, e.g., flight and telemetry management.
+    normal = 1,  ///< Everything not explicitly prioritized.
+    low    = 2   ///< Bulk queries, e.g., airspace searches backing a map.
+  };
+
+  /// Statistics summarizes the acquisitions at a single priority.
+  struct Statistics {
+    Priority priority;           ///< The priority described by this instance.
+    std::size_t waiting;         ///< Number of acquisitions currently waiting for a connection.
+    util::Histogram wait_times;  ///< Time in [us] from acquisition to handing out a connection.
+  };
+
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::size_t max_connections{6};         ///< Upper bound on connections open to the host.
+    Microseconds idle_timeout{seconds(30)};  ///< Idle connections are closed after this period.
+    /// Lower priorities are served after this many consecutive grants to a higher priority.
+    std::size_t max_consecutive_grants{8};
+  };
+
+  /// create returns a new ConnectionPool instance, running its idle timer on 'io_service'
+  /// and creating new connections with 'connection_factory'.
+  static std::shared_ptr<ConnectionPool> create(const Configuration& configuration,
+                                                const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                                const ConnectionFactory& connection_factory);
+
+  /// acquire hands a connection to 'handler', preferring the most recently
+  /// released idle one. If all connections are leased out, 'handler' waits
+  /// with 'priority'. 'handler' is always invoked on the io_service.
+  void acquire(Priority priority, const AcquireHandler& handler);
+
+  /// release returns 'connection' to the pool. If 'keep_alive' is false, or the
+  /// connection is no longer open, the connection is closed instead.
+  void release(const std::shared_ptr<Connection>& connection, bool keep_alive);
+
+  /// idle returns the number of idle connections.
+  std::size_t idle() const;
+
+  /// active returns the number of connections currently leased out.
+  std::size_t active() const;
+
+  /// statistics returns a snapshot of the statistics of all priorities, highest priority first.
+  std::vector<Statistics> statistics() const;
+
+ private:
+  static constexpr std::size_t priority_count{3};
+
+  struct Idle {
+    std::shared_ptr<Connection> connection;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  struct Waiting {
+    AcquireHandler handler;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  explicit ConnectionPool(const Configuration& configuration,
+                          const std::shared_ptr<::boost::asio::io_service>& io_service,
+                          const ConnectionFactory& connection_factory);
+
+  // close_expired closes all idle connections that reached the idle timeout. Requires guard_ to be held.
+  void close_expired(std::chrono::steady_clock::time_point now);
+  // hand_out posts 'connection' to 'handler', accounting for the time spent waiting since 'since'.
+  // Requires guard_ to be held.
+  void hand_out(std::size_t priority, std::chrono::steady_clock::time_point since, const AcquireHandler& handler,
+                const std::shared_ptr<Connection>& connection, bool reused);
+  // anybody_waiting returns true if acquisitions are waiting for a connection. Requires guard_ to be held.
+  bool anybody_waiting() const;
+  // serve_waiting hands 'connection' to the longest waiting acquisition with the highest
+  // priority, or to the longest waiting acquisition of any lower priority if the highest one
+  // has been granted max_consecutive_grants times in a row. Returns false if nobody is waiting.
+  // Requires guard_ to be held.
+  bool serve_waiting(const std::shared_ptr<Connection>& connection, bool reused);
+  // schedule_sweep arms the idle timer if there are idle connections. Requires guard_ to be held.
+  void schedule_sweep();
+  void handle_sweep(const ::boost::system::error_code& ec);
+
+  Configuration configuration_;
+  std::shared_ptr<::boost::asio::io_service> io_service_;
+  ConnectionFactory connection_factory_;
+
+  mutable std::mutex guard_;
+  std::deque<Idle> idle_;
+  std::array<std::deque<Waiting>, priority_count> waiting_;
+  std::vector<util::Histogram> wait_times_;
+  std::size_t active_{0};
+  std::size_t consecutive_grants_{0};
+  ::boost::asio::deadline_timer sweeper_;
+  bool sweep_scheduled_{false};
+};
+
+}  // namespace boost
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_BOOST_CONNECTION_POOL_H_
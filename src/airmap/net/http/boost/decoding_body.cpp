@@ -0,0 +1,57 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/boost/decoding_body.h>
+
+namespace errc = boost::system::errc;
+
+void airmap::net::http::boost::DecodingBody::reader::init(const ::boost::optional<std::uint64_t>& content_length,
+                                                          ::boost::system::error_code& ec) {
+  auto coding = content_encoding_();
+
+  body_.data.clear();
+  body_.wire_bytes = 0;
+
+  if (!(decoder_ = ContentDecoder::create(coding, max_decoded_size))) {
+    ec = errc::make_error_code(errc::not_supported);
+    return;
+  }
+
+  // We do not guess at the ratio of compressed bodies, but
+  // allocate exactly once for the common, uncompressed case.
+  if (content_length && coding.empty())
+    body_.data.reserve(*content_length);
+
+  ec = {};
+}
+
+bool airmap::net::http::boost::DecodingBody::reader::put(const char* data, std::size_t size,
+                                                         ::boost::system::error_code& ec) {
+  if (!decoder_->decode(data, size, body_.data)) {
+    ec = errc::make_error_code(body_.data.size() > max_decoded_size ? errc::message_size : errc::bad_message);
+    return false;
+  }
+
+  body_.wire_bytes += size;
+  ec = {};
+  return true;
+}
+
+void airmap::net::http::boost::DecodingBody::reader::finish(::boost::system::error_code& ec) {
+  // Beast does not initialize readers for messages without a body.
+  if (decoder_ && !decoder_->finish()) {
+    ec = errc::make_error_code(errc::bad_message);
+    return;
+  }
+
+  ec = {};
+}
@@ -0,0 +1,92 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_BOOST_DECODING_BODY_H_
+#define AIRMAP_NET_HTTP_BOOST_DECODING_BODY_H_
+
+#include <airmap/net/http/content_coding.h>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace airmap {
+namespace net {
+namespace http {
+namespace boost {
+
+/// DecodingBody is a Beast Body decoding the content coding announced
+/// in the Content-Encoding header while the body is read from the wire.
+/// Compressed bodies are never buffered in full.
+///
+/// Reading fails with errc::message_size if a body decodes to more than
+/// max_decoded_size bytes. Beast's body limit only applies to the encoded body.
+struct DecodingBody {
+  /// max_decoded_size is the upper bound on the size of a decoded body.
+  static constexpr std::uint64_t max_decoded_size{64 * 1024 * 1024};
+
+  /// value_type holds a decoded body.
+  struct value_type {
+    std::string data;             ///< The decoded body.
+    std::uint64_t wire_bytes{0};  ///< The number of bytes of the body as transferred.
+  };
+
+  /// reader feeds the body into a ContentDecoder.
+  class reader {
+   public:
+    // Beast constructs readers before the header has been parsed, we
+    // only look at the Content-Encoding once the body starts in init.
+    template <bool isRequest, typename Fields>
+    explicit reader(::boost::beast::http::header<isRequest, Fields>& header, value_type& body)
+        : content_encoding_{[&header]() {
+            return std::string{header[::boost::beast::http::field::content_encoding]};
+          }},
+          body_{body} {
+    }
+
+    void init(const ::boost::optional<std::uint64_t>& content_length, ::boost::system::error_code& ec);
+
+    template <typename ConstBufferSequence>
+    std::size_t put(const ConstBufferSequence& buffers, ::boost::system::error_code& ec) {
+      std::size_t n = 0;
+
+      for (const auto& buffer : ::boost::beast::buffers_range_ref(buffers)) {
+        if (!put(static_cast<const char*>(buffer.data()), buffer.size(), ec))
+          break;
+        n += buffer.size();
+      }
+
+      return n;
+    }
+
+    void finish(::boost::system::error_code& ec);
+
+   private:
+    bool put(const char* data, std::size_t size, ::boost::system::error_code& ec);
+
+    std::function<std::string()> content_encoding_;
+    value_type& body_;
+    std::unique_ptr<ContentDecoder> decoder_;
+  };
+};
+
+}  // namespace boost
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_BOOST_DECODING_BODY_H_
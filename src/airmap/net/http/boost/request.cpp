@@ -12,120 +12,139 @@
 // limitations under the License.
 #include <airmap/net/http/boost/request.h>
 
+#include <boost/algorithm/string.hpp>
+
 namespace asio = boost::asio;
 namespace http = boost::beast::http;
 namespace ssl  = boost::asio::ssl;
 
 namespace {
 
-airmap::Error wrap_error_code(const boost::system::error_code& ec) {
-  return airmap::Error{ec.message()};
+airmap::Error wrap_error_code(const boost::system::error_code& ec, bool request_sent) {
+  return airmap::Error{ec.message()}.value(airmap::Error::Value{std::string{airmap::net::http::request_sent_key}},
+                                           airmap::Error::Value{request_sent});
+}
+
+// is_stale returns true if 'ec' indicates that the peer closed
+// the connection before or while we were writing the request.
+bool is_stale(const boost::system::error_code& ec) {
+  return ec == asio::error::eof || ec == asio::error::connection_reset || ec == asio::error::broken_pipe ||
+         ec == asio::error::connection_aborted || ec == http::error::end_of_stream ||
+         ec == ssl::error::stream_truncated;
+}
+
+// is_idempotent returns true if repeating a request with 'verb' has the same effect as sending it once.
+bool is_idempotent(http::verb verb) {
+  switch (verb) {
+    case http::verb::get:
+    case http::verb::head:
+    case http::verb::put:
+    case http::verb::delete_:
+    case http::verb::options:
+    case http::verb::trace:
+      return true;
+    default:
+      return false;
+  }
 }
 
 constexpr const char* component{"airmap::net::http::boost::Request"};
 
 }  // namespace
 
-std::shared_ptr<airmap::net::http::boost::NonEncryptingRequest> airmap::net::http::boost::NonEncryptingRequest::create(
+std::shared_ptr<airmap::net::http::boost::Request> airmap::net::http::boost::Request::create(
     const Configuration& configuration) {
-  return std::shared_ptr<NonEncryptingRequest>{new NonEncryptingRequest{configuration}};
+  return std::shared_ptr<Request>{new Request{configuration}};
 }
 
-airmap::net::http::boost::NonEncryptingRequest::NonEncryptingRequest(const Configuration& configuration)
+airmap::net::http::boost::Request::Request(const Configuration& configuration)
     : log_{configuration.logger},
-      io_service_{configuration.io_service},
-      endpoint_{std::move(configuration.endpoint)},
-      socket_{*io_service_},
-      request_{std::move(configuration.request)},
-      cb_{std::move(configuration.cb)} {
+      pool_{configuration.pool},
+      priority_{configuration.priority},
+      endpoint_{configuration.endpoint},
+      request_{configuration.request},
+      cb_{configuration.cb},
+      connect_failed_{configuration.connect_failed} {
+  request_.keep_alive(true);
 }
 
-void airmap::net::http::boost::NonEncryptingRequest::start() {
-  socket_.async_connect(endpoint_,
-                        std::bind(&NonEncryptingRequest::handle_connect, shared_from_this(), std::placeholders::_1));
+void airmap::net::http::boost::Request::start() {
+  pool_->acquire(priority_, [sp = shared_from_this()](const std::shared_ptr<Connection>& connection, bool reused) {
+    sp->handle_acquire(connection, reused);
+  });
 }
 
-void airmap::net::http::boost::NonEncryptingRequest::handle_connect(const ::boost::system::error_code& error) {
-  if (error) {
-    cb_(Result(wrap_error_code(error)));
-    return;
-  }
-  ::http::async_write(socket_, request_,
-                      std::bind(&NonEncryptingRequest::handle_write, shared_from_this(), std::placeholders::_1));
-}
+void airmap::net::http::boost::Request::handle_acquire(const std::shared_ptr<Connection>& connection, bool reused) {
+  connection_ = connection;
+  reused_     = reused;
+  written_    = false;
 
-void airmap::net::http::boost::NonEncryptingRequest::handle_write(const ::boost::system::error_code& error) {
-  if (error) {
-    cb_(Result(wrap_error_code(error)));
-    return;
+  if (reused_) {
+    handle_connect(::boost::system::error_code{});
+  } else {
+    connection_->async_connect(
+        endpoint_, std::bind(&Request::handle_connect, shared_from_this(), std::placeholders::_1));
   }
-  ::http::async_read(socket_, buffer_, response_,
-                     std::bind(&NonEncryptingRequest::handle_read, shared_from_this(), std::placeholders::_1));
 }
 
-void airmap::net::http::boost::NonEncryptingRequest::handle_read(const ::boost::system::error_code& error) {
+void airmap::net::http::boost::Request::handle_connect(const ::boost::system::error_code& error) {
   if (error) {
-    cb_(Result(wrap_error_code(error)));
+    if (!reused_ && connect_failed_)
+      connect_failed_();
+    handle_error(error, false);
     return;
   }
 
-  cb_(Result{Response{response_.version(), response_.result_int(), {}, response_.body()}});
-}
-
-std::shared_ptr<airmap::net::http::boost::EncryptingRequest> airmap::net::http::boost::EncryptingRequest::create(
-    const Configuration& configuration) {
-  return std::shared_ptr<EncryptingRequest>{new EncryptingRequest{configuration}};
+  connection_->async_write(request_, std::bind(&Request::handle_write, shared_from_this(), std::placeholders::_1));
 }
 
-airmap::net::http::boost::EncryptingRequest::EncryptingRequest(const Configuration& configuration)
-    : log_{configuration.logger},
-      io_service_{configuration.io_service},
-      endpoint_{std::move(configuration.endpoint)},
-      ssl_context_{ssl::context::sslv23},
-      socket_{*io_service_, ssl_context_},
-      request_{std::move(configuration.request)},
-      cb_{std::move(configuration.cb)} {
-  ssl_context_.set_default_verify_paths();
-  ssl_context_.set_verify_mode(ssl::verify_peer);
-}
-
-void airmap::net::http::boost::EncryptingRequest::start() {
-  socket_.lowest_layer().async_connect(
-      endpoint_, std::bind(&EncryptingRequest::handle_connect, shared_from_this(), std::placeholders::_1));
-}
-
-void airmap::net::http::boost::EncryptingRequest::handle_connect(const ::boost::system::error_code& error) {
+void airmap::net::http::boost::Request::handle_write(const ::boost::system::error_code& error) {
+  // A failed write might have transferred parts or all of the request.
   if (error) {
-    cb_(Result(wrap_error_code(error)));
+    handle_error(error, true);
     return;
   }
-  socket_.async_handshake(ssl::stream_base::client, std::bind(&EncryptingRequest::handle_ssl_handshake,
-                                                              shared_from_this(), std::placeholders::_1));
+
+  written_  = true;
+  response_ = {};
+  connection_->async_read(response_, std::bind(&Request::handle_read, shared_from_this(), std::placeholders::_1));
 }
 
-void airmap::net::http::boost::EncryptingRequest::handle_ssl_handshake(const ::boost::system::error_code& error) {
+void airmap::net::http::boost::Request::handle_read(const ::boost::system::error_code& error) {
   if (error) {
-    cb_(Result(wrap_error_code(error)));
+    handle_error(error, true);
     return;
   }
-  ::http::async_write(socket_, request_,
-                      std::bind(&EncryptingRequest::handle_write, shared_from_this(), std::placeholders::_1));
-}
 
-void airmap::net::http::boost::EncryptingRequest::handle_write(const ::boost::system::error_code& error) {
-  if (error) {
-    cb_(Result(wrap_error_code(error)));
-    return;
+  pool_->release(connection_, response_.keep_alive());
+  connection_.reset();
+
+  // Header names are case-insensitive, we normalize them to lower case.
+  // Repeated headers are folded into a single, comma-separated value.
+  std::unordered_map<std::string, std::string> headers;
+  for (const auto& field : response_) {
+    auto& value = headers[::boost::algorithm::to_lower_copy(std::string{field.name_string()})];
+    value += value.empty() ? std::string{field.value()} : ", " + std::string{field.value()};
   }
-  ::http::async_read(socket_, buffer_, response_,
-                     std::bind(&EncryptingRequest::handle_read, shared_from_this(), std::placeholders::_1));
+
+  auto wire_bytes    = response_.body().wire_bytes;
+  auto decoded_bytes = response_.body().data.size();
+
+  cb_(Result{Response{response_.version(), response_.result_int(), std::move(headers),
+                      std::move(response_.body().data), wire_bytes, decoded_bytes}});
 }
 
-void airmap::net::http::boost::EncryptingRequest::handle_read(const ::boost::system::error_code& error) {
-  if (error) {
-    cb_(Result(wrap_error_code(error)));
+void airmap::net::http::boost::Request::handle_error(const ::boost::system::error_code& error, bool request_sent) {
+  pool_->release(connection_, false);
+  connection_.reset();
+
+  // Once the request is written, the server might have acted on it even if the
+  // connection broke down afterwards. Only idempotent requests are safe to repeat then.
+  if (reused_ && is_stale(error) && (!written_ || is_idempotent(request_.method()))) {
+    log_.debugf(component, "pooled connection turned out to be stale, retrying: %s", error.message());
+    start();
     return;
   }
 
-  cb_(Result{Response{response_.version(), response_.result_int(), {}, response_.body()}});
+  cb_(Result(wrap_error_code(error, request_sent)));
 }
@@ -15,14 +15,16 @@
 
 #include <airmap/net/http/requester.h>
 
+#include <airmap/net/http/boost/connection.h>
+#include <airmap/net/http/boost/connection_pool.h>
 #include <airmap/util/formatting_logger.h>
 
 #include <boost/asio.hpp>
-#include <boost/asio/ssl.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 
 #include <functional>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -31,74 +33,52 @@ namespace net {
 namespace http {
 namespace boost {
 
-class Request : DoNotCopyOrMove {
+/// Request runs a single request/response exchange over a connection
+/// acquired from a ConnectionPool.
+///
+/// If a connection taken from the pool turns out to be stale, i.e. the
+/// server closed it while it was idle, the exchange is transparently
+/// retried on another connection. Requests with non-idempotent methods are
+/// only retried if the connection broke down before the request was written.
+class Request : DoNotCopyOrMove, public std::enable_shared_from_this<Request> {
  public:
+  using Result   = Requester::Result;
+  using Callback = Requester::Callback;
+
   struct Configuration {
     std::shared_ptr<Logger> logger;
-    std::shared_ptr<::boost::asio::io_service> io_service;
+    std::shared_ptr<ConnectionPool> pool;
+    ConnectionPool::Priority priority;
     ::boost::asio::ip::tcp::endpoint endpoint;
     ::boost::beast::http::request<::boost::beast::http::string_body> request;
     Requester::Callback cb;
+    std::function<void()> connect_failed;  ///< Invoked if establishing a new connection to 'endpoint' fails.
   };
 
-  virtual void start() = 0;
-
- protected:
-  Request() = default;
-};
-
-class NonEncryptingRequest : public Request, public std::enable_shared_from_this<NonEncryptingRequest> {
- public:
-  using Result   = Requester::Result;
-  using Callback = Requester::Callback;
-
-  static std::shared_ptr<NonEncryptingRequest> create(const Configuration& configuration);
-
-  void start() override;
-
- private:
-  explicit NonEncryptingRequest(const Configuration& configuration);
-
-  void handle_connect(const ::boost::system::error_code& error);
-  void handle_write(const ::boost::system::error_code& error);
-  void handle_read(const ::boost::system::error_code& error);
-
-  util::FormattingLogger log_;
-  std::shared_ptr<::boost::asio::io_service> io_service_;
-  ::boost::asio::ip::tcp::endpoint endpoint_;
-  ::boost::asio::ip::tcp::socket socket_;
-  ::boost::beast::http::request<::boost::beast::http::string_body> request_;
-  ::boost::beast::http::response<::boost::beast::http::string_body> response_;
-  ::boost::beast::flat_buffer buffer_{8192};
-  Requester::Callback cb_;
-};
-
-class EncryptingRequest : public Request, public std::enable_shared_from_this<EncryptingRequest> {
- public:
-  using Result   = Requester::Result;
-  using Callback = Requester::Callback;
-
-  static std::shared_ptr<EncryptingRequest> create(const Configuration& configuration);
+  static std::shared_ptr<Request> create(const Configuration& configuration);
 
-  void start() override;
+  void start();
 
  private:
-  explicit EncryptingRequest(const Configuration& configuration);
+  explicit Request(const Configuration& configuration);
 
+  void handle_acquire(const std::shared_ptr<Connection>& connection, bool reused);
   void handle_connect(const ::boost::system::error_code& error);
-  void handle_ssl_handshake(const ::boost::system::error_code& error);
   void handle_write(const ::boost::system::error_code& error);
   void handle_read(const ::boost::system::error_code& error);
+  void handle_error(const ::boost::system::error_code& error, bool request_sent);
 
   util::FormattingLogger log_;
-  std::shared_ptr<::boost::asio::io_service> io_service_;
+  std::shared_ptr<ConnectionPool> pool_;
+  ConnectionPool::Priority priority_;
   ::boost::asio::ip::tcp::endpoint endpoint_;
-  ::boost::asio::ssl::context ssl_context_;
-  ::boost::asio::ssl::stream<::boost::asio::ip::tcp::socket> socket_;
+  std::shared_ptr<Connection> connection_;
+  bool reused_{false};
+  bool written_{false};
   ::boost::beast::http::request<::boost::beast::http::string_body> request_;
-  ::boost::beast::http::response<::boost::beast::http::string_body> response_;
-  ::boost::beast::flat_buffer buffer_{8192};
+  Connection::Response response_;
   Requester::Callback cb_;
+  std::function<void()> connect_failed_;
 };
 
 }  // namespace boost
@@ -106,4 +86,4 @@ class EncryptingRequest : public Request, public std::enable_shared_from_this<En
 }  // namespace net
 }  // namespace airmap
 
-#endif  // AIRMAP_NET_HTTP_REQUEST_H_
+#endif  // AIRMAP_NET_HTTP_BOOST_REQUEST_H_
@@ -13,9 +13,10 @@
 #include <airmap/net/http/boost/request.h>
 
 #include <airmap/net/http/boost/requester.h>
+#include <airmap/net/http/content_coding.h>
+#include <airmap/net/http/query.h>
 #include <airmap/net/http/user_agent.h>
 
-#include <iterator>
 #include <stdexcept>
 
 namespace asio = boost::asio;
@@ -23,213 +24,149 @@ namespace http = boost::beast::http;
 namespace fmt  = airmap::util::fmt;
 using tcp      = boost::asio::ip::tcp;
 
-namespace {
-
-airmap::Error wrap_error_code(const boost::system::error_code& ec) {
-  return airmap::Error{ec.message()};
-}
-
-namespace uri {
-
-template <typename CharT>
-inline CharT hex_to_letter(CharT in) {
-  if ((in >= 0) && (in < 10)) {
-    return in + '0';
-  }
-
-  if ((in >= 10) && (in < 16)) {
-    return in - 10 + 'A';
-  }
-
-  return in;
-}
-
-template <class charT, class OutputIterator>
-void encode_char(charT in, OutputIterator& out, const char* ignore = "") {
-  if (((in >= 'a') && (in <= 'z')) || ((in >= 'A') && (in <= 'Z')) || ((in >= '0') && (in <= '9')) || (in == '-') ||
-      (in == '.') || (in == '_') || (in == '~')) {
-    out++ = in;
-  } else {
-    auto first = ignore, last = ignore + std::strlen(ignore);
-    if (std::find(first, last, in) != last) {
-      out++ = in;
-    } else {
-      out++ = '%';
-      out++ = hex_to_letter((in >> 4) & 0x0f);
-      out++ = hex_to_letter(in & 0x0f);
-    }
-  }
-}
-
-template <typename InputIterator, typename OutputIterator>
-OutputIterator encode_query(InputIterator first, InputIterator last, OutputIterator out) {
-  auto it = first;
-  while (it != last) {
-    encode_char(*it, out, "/.@&%;=");
-    ++it;
-  }
-  return out;
-}
-
-std::string encode_query(const std::unordered_map<std::string, std::string>& q) {
-  std::stringstream ss;
-
-  for (auto it = q.begin(); it != q.end(); ++it) {
-    if (it != q.begin())
-      ss << "&";
-
-    auto p = it->first + "=" + it->second;
-    encode_query(p.begin(), p.end(), std::ostream_iterator<char>(ss));
-  }
-
-  return ss.str();
-}
-
-}  // namespace uri
-}  // namespace
-
-airmap::net::http::boost::Requester::RequestFactory airmap::net::http::boost::Requester::request_factory_for_protocol(
-    const std::string& protocol) {
+airmap::net::http::boost::ConnectionPool::ConnectionFactory
+airmap::net::http::boost::Requester::connection_factory_for_protocol(
+    const std::string& protocol, const std::string& host,
+    const std::shared_ptr<::boost::asio::io_service>& io_service) {
   if (protocol == "http") {
-    return non_encrypting_request_factory();
+    return non_encrypting_connection_factory(io_service);
   } else if (protocol == "https") {
-    return encrypting_request_factory();
+    return encrypting_connection_factory(host, io_service);
   }
 
   throw std::logic_error{"unsupported protocol"};
 }
 
-airmap::net::http::boost::Requester::RequestFactory airmap::net::http::boost::Requester::encrypting_request_factory() {
-  return [](const Request::Configuration& configuration) { return EncryptingRequest::create(configuration); };
+airmap::net::http::boost::ConnectionPool::ConnectionFactory
+airmap::net::http::boost::Requester::encrypting_connection_factory(
+    const std::string& host, const std::shared_ptr<::boost::asio::io_service>& io_service) {
+  return [io_service, session_cache = TlsSessionCache::create(host)]() {
+    return EncryptingConnection::create(io_service, session_cache);
+  };
 }
 
-airmap::net::http::boost::Requester::RequestFactory
-airmap::net::http::boost::Requester::non_encrypting_request_factory() {
-  return [](const Request::Configuration& configuration) { return NonEncryptingRequest::create(configuration); };
+airmap::net::http::boost::ConnectionPool::ConnectionFactory
+airmap::net::http::boost::Requester::non_encrypting_connection_factory(
+    const std::shared_ptr<::boost::asio::io_service>& io_service) {
+  return [io_service]() { return NonEncryptingConnection::create(io_service); };
+}
+
+std::shared_ptr<airmap::net::http::boost::Requester> airmap::net::http::boost::Requester::create(
+    const std::string& host, std::uint16_t port, const std::shared_ptr<Logger>& logger,
+    const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<dns::ResolverCache>& resolver_cache, const std::shared_ptr<ConnectionPool>& connection_pool) {
+  return create(host, port, logger, io_service, resolver_cache, connection_pool, Options{});
 }
 
 std::shared_ptr<airmap::net::http::boost::Requester> airmap::net::http::boost::Requester::create(
     const std::string& host, std::uint16_t port, const std::shared_ptr<Logger>& logger,
-    const std::shared_ptr<::boost::asio::io_service>& io_service, const RequestFactory& request_factory) {
-  return std::shared_ptr<Requester>{new Requester{host, port, logger, io_service, request_factory}};
+    const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<dns::ResolverCache>& resolver_cache, const std::shared_ptr<ConnectionPool>& connection_pool,
+    const Options& options) {
+  return std::shared_ptr<Requester>{
+      new Requester{host, port, logger, io_service, resolver_cache, connection_pool, options}};
 }
 
 airmap::net::http::boost::Requester::Requester(const std::string& host, std::uint16_t port,
                                                const std::shared_ptr<Logger>& logger,
                                                const std::shared_ptr<::boost::asio::io_service>& io_service,
-                                               const RequestFactory& request_factory)
+                                               const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                                               const std::shared_ptr<ConnectionPool>& connection_pool,
+                                               const Options& options)
     : log_{logger},
       io_service_{io_service},
-      resolver_{*io_service_},
+      resolver_cache_{resolver_cache},
       host_{host},
       port_{port},
-      request_factory_{request_factory} {
+      connection_pool_{connection_pool},
+      options_{options} {
+  // Headers common to all requests are assembled once and copied per request.
+  header_template_.version(11);
+  header_template_.set(::http::field::user_agent, user_agent());
+  header_template_.set(::http::field::accept, "application/json");
+  header_template_.set(::http::field::accept_encoding, content_coding::accepted());
+  header_template_.set(::http::field::host, host_);
+
+  body_header_template_ = header_template_;
+  body_header_template_.set(::http::field::content_type, "application/json");
 }
 
 void airmap::net::http::boost::Requester::delete_(const std::string& path,
                                                   std::unordered_map<std::string, std::string>&& query,
                                                   std::unordered_map<std::string, std::string>&& headers, Callback cb) {
-  ::boost::beast::http::request<::boost::beast::http::string_body> request;
-  request.method(::http::verb::delete_);
-  request.target(fmt::sprintf("%s?%s", path, uri::encode_query(query)));
-  request.set(::http::to_string(::http::field::user_agent), user_agent());
-  request.set(::http::to_string(::http::field::accept), "application/json");
-  request.set(::http::to_string(::http::field::host), host_);
-  for (const auto& pair : headers)
-    request.set(pair.first, pair.second);
-  request.prepare_payload();
-
-  resolver_.async_resolve(
-      tcp::resolver::query(host_, std::to_string(port_), tcp::resolver::query::passive),
-      [this, sp = shared_from_this(), request = std::move(request), cb = std::move(cb)](
-          const ::boost::system::error_code& ec, tcp::resolver::iterator iterator) {
-        if (ec) {
-          cb(Result(wrap_error_code(ec)));
-        } else {
-          request_factory_(Request::Configuration{log_.logger(), io_service_, *iterator, request, std::move(cb)})
-              ->start();
-        }
-      });
+  send(::http::verb::delete_, target_for(path, query), std::move(headers), nullptr, std::move(cb));
 }
 
 void airmap::net::http::boost::Requester::get(const std::string& path,
                                               std::unordered_map<std::string, std::string>&& query,
                                               std::unordered_map<std::string, std::string>&& headers, Callback cb) {
-  ::boost::beast::http::request<::boost::beast::http::string_body> request;
-  request.method(::http::verb::get);
-  request.target(fmt::sprintf("%s?%s", path, uri::encode_query(query)));
-  request.set(::http::to_string(::http::field::user_agent), user_agent());
-  request.set(::http::to_string(::http::field::accept), "application/json");
-  request.set(::http::to_string(::http::field::host), host_);
-  for (const auto& pair : headers)
-    request.set(pair.first, pair.second);
-  request.prepare_payload();
-
-  resolver_.async_resolve(
-      tcp::resolver::query(host_, std::to_string(port_), tcp::resolver::query::passive),
-      [this, sp = shared_from_this(), request = std::move(request), cb = std::move(cb)](
-          const ::boost::system::error_code& ec, tcp::resolver::iterator iterator) {
-        if (ec) {
-          cb(Result(wrap_error_code(ec)));
-        } else {
-          request_factory_(Request::Configuration{log_.logger(), io_service_, *iterator, request, std::move(cb)})
-              ->start();
-        }
-      });
+  send(::http::verb::get, target_for(path, query), std::move(headers), nullptr, std::move(cb));
 }
 
 void airmap::net::http::boost::Requester::patch(const std::string& path,
                                                 std::unordered_map<std::string, std::string>&& headers,
                                                 const std::string& body, Callback cb) {
-  ::boost::beast::http::request<::boost::beast::http::string_body> request;
-  request.method(::http::verb::patch);
-  request.target(path);
-  request.set(::http::to_string(::http::field::user_agent), user_agent());
-  request.set(::http::to_string(::http::field::accept), "application/json");
-  request.set(::http::to_string(::http::field::content_type), "application/json");
-  request.set(::http::to_string(::http::field::host), host_);
-  for (const auto& pair : headers)
-    request.set(pair.first, pair.second);
-  request.body() = std::move(body);
-  request.prepare_payload();
-
-  resolver_.async_resolve(
-      tcp::resolver::query(host_, std::to_string(port_), tcp::resolver::query::passive),
-      [this, sp = shared_from_this(), request = std::move(request), cb = std::move(cb)](
-          const ::boost::system::error_code& ec, tcp::resolver::iterator iterator) {
-        if (ec) {
-          cb(Result(wrap_error_code(ec)));
-        } else {
-          request_factory_(Request::Configuration{log_.logger(), io_service_, *iterator, request, std::move(cb)})
-              ->start();
-        }
-      });
+  send(::http::verb::patch, path, std::move(headers), &body, std::move(cb));
 }
 
 void airmap::net::http::boost::Requester::post(const std::string& path,
                                                std::unordered_map<std::string, std::string>&& headers,
                                                const std::string& body, Callback cb) {
-  ::boost::beast::http::request<::boost::beast::http::string_body> request;
-  request.method(::http::verb::post);
-  request.target(path);
-  request.set(::http::to_string(::http::field::user_agent), user_agent());
-  request.set(::http::to_string(::http::field::accept), "application/json");
-  request.set(::http::to_string(::http::field::content_type), "application/json");
-  request.set(::http::to_string(::http::field::host), host_);
+  send(::http::verb::post, path, std::move(headers), &body, std::move(cb));
+}
+
+std::string airmap::net::http::boost::Requester::target_for(const std::string& path,
+                                                            const std::unordered_map<std::string, std::string>& query) {
+  if (query.empty())
+    return path;
+
+  auto target = path + "?";
+  append_query(query, target);
+  return target;
+}
+
+void airmap::net::http::boost::Requester::send(::boost::beast::http::verb verb, const std::string& target,
+                                               std::unordered_map<std::string, std::string>&& headers,
+                                               const std::string* body, Callback cb) {
+  ::boost::beast::http::request<::boost::beast::http::string_body> request{body ? body_header_template_
+                                                                                : header_template_};
+  request.method(verb);
+  request.target(target);
   for (const auto& pair : headers)
     request.set(pair.first, pair.second);
-  request.body() = std::move(body);
+
+  if (body) {
+    request.body() = *body;
+    compress(request);
+  }
+
   request.prepare_payload();
+  dispatch(std::move(request), std::move(cb));
+}
 
-  resolver_.async_resolve(
-      tcp::resolver::query(host_, std::to_string(port_), tcp::resolver::query::passive),
-      [this, sp = shared_from_this(), request = std::move(request), cb = std::move(cb)](
-          const ::boost::system::error_code& ec, tcp::resolver::iterator iterator) {
-        if (ec) {
-          cb(Result(wrap_error_code(ec)));
-        } else {
-          request_factory_(Request::Configuration{log_.logger(), io_service_, *iterator, request, std::move(cb)})
-              ->start();
-        }
-      });
+void airmap::net::http::boost::Requester::compress(
+    ::boost::beast::http::request<::boost::beast::http::string_body>& request) const {
+  if (!options_.body_compression.enabled || request.body().size() < options_.body_compression.threshold)
+    return;
+
+  request.body() = content_coding::compress(request.body());
+  request.set(::http::to_string(::http::field::content_encoding), content_coding::gzip);
+}
+
+void airmap::net::http::boost::Requester::dispatch(
+    ::boost::beast::http::request<::boost::beast::http::string_body>&& request, Callback cb) {
+  resolver_cache_->resolve(host_, [this, sp = shared_from_this(), request = std::move(request), cb = std::move(cb)](
+                                      const dns::ResolverCache::Result& result) {
+    if (!result) {
+      // Requests failing to resolve their host never left this process.
+      cb(Result{result.error().value(Error::Value{std::string{request_sent_key}}, Error::Value{false})});
+    } else {
+      tcp::endpoint endpoint{result.value().front(), port_};
+      // The cached address might have gone stale, we look up host_ again on the next request.
+      auto connect_failed = [resolver_cache = resolver_cache_, host = host_]() { resolver_cache->invalidate(host); };
+      Request::create(Request::Configuration{log_.logger(), connection_pool_, options_.priority, endpoint, request,
+                                             std::move(cb), std::move(connect_failed)})
+          ->start();
+    }
+  });
 }
@@ -15,6 +15,8 @@
 
 #include <airmap/net/http/requester.h>
 
+#include <airmap/net/dns/resolver_cache.h>
+#include <airmap/net/http/boost/connection_pool.h>
 #include <airmap/net/http/boost/request.h>
 #include <airmap/util/formatting_logger.h>
 
@@ -27,16 +29,50 @@ namespace boost {
 
 class Requester : public http::Requester, public std::enable_shared_from_this<Requester> {
  public:
-  using RequestFactory = std::function<std::shared_ptr<Request>(const Request::Configuration&)>;
+  /// BodyCompression configures the gzip compression of request bodies.
+  ///
+  /// Servers have to opt in to accepting compressed request bodies,
+  /// which is why compression is disabled by default.
+  struct BodyCompression {
+    bool enabled{false};               ///< Request bodies are only compressed if enabled.
+    std::size_t threshold{16 * 1024};  ///< Bodies smaller than threshold bytes are sent as is.
+  };
 
-  static RequestFactory request_factory_for_protocol(const std::string& protocol);
-  static RequestFactory encrypting_request_factory();
-  static RequestFactory non_encrypting_request_factory();
+  /// Options bundles up optional behavior of a Requester.
+  struct Options {
+    /// Requests wait for a connection to the host with this priority.
+    ConnectionPool::Priority priority{ConnectionPool::Priority::normal};
+    /// Request bodies are compressed according to this configuration.
+    BodyCompression body_compression;
+  };
 
+  static ConnectionPool::ConnectionFactory connection_factory_for_protocol(
+      const std::string& protocol, const std::string& host,
+      const std::shared_ptr<::boost::asio::io_service>& io_service);
+  static ConnectionPool::ConnectionFactory encrypting_connection_factory(
+      const std::string& host, const std::shared_ptr<::boost::asio::io_service>& io_service);
+  static ConnectionPool::ConnectionFactory non_encrypting_connection_factory(
+      const std::shared_ptr<::boost::asio::io_service>& io_service);
+
+  /// create returns a new Requester talking to 'host':'port' over
+  /// connections taken from 'connection_pool', looking up 'host' in 'resolver_cache'.
+  ///
+  /// Requests advertise all content codings known to ContentDecoder and
+  /// response bodies are decoded transparently. Requests wait for connections
+  /// with normal priority and their bodies are sent as is.
+  static std::shared_ptr<Requester> create(const std::string& host, std::uint16_t port,
+                                           const std::shared_ptr<Logger>& logger,
+                                           const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                           const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                                           const std::shared_ptr<ConnectionPool>& connection_pool);
+
+  /// create returns a new Requester behaving according to 'options'.
   static std::shared_ptr<Requester> create(const std::string& host, std::uint16_t port,
                                            const std::shared_ptr<Logger>& logger,
                                            const std::shared_ptr<::boost::asio::io_service>& io_service,
-                                           const RequestFactory& request_factory);
+                                           const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                                           const std::shared_ptr<ConnectionPool>& connection_pool,
+                                           const Options& options);
 
   void delete_(const std::string& path, std::unordered_map<std::string, std::string>&& query,
                std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
@@ -50,13 +86,32 @@ class Requester : public http::Requester, public std::enable_shared_from_this<Re
  private:
   explicit Requester(const std::string& host, std::uint16_t port, const std::shared_ptr<Logger>& logger,
                      const std::shared_ptr<::boost::asio::io_service>& io_service,
-                     const RequestFactory& request_factory);
+                     const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                     const std::shared_ptr<ConnectionPool>& connection_pool, const Options& options);
+
+  // target_for returns the request target for 'path' and 'query'.
+  static std::string target_for(const std::string& path, const std::unordered_map<std::string, std::string>& query);
+
+  // send assembles a request with 'verb' for 'target' from the header templates and dispatches it.
+  // 'body' is null for requests without a body.
+  void send(::boost::beast::http::verb verb, const std::string& target,
+            std::unordered_map<std::string, std::string>&& headers, const std::string* body, Callback cb);
+
+  // compress gzips the body of 'request' according to options_.
+  void compress(::boost::beast::http::request<::boost::beast::http::string_body>& request) const;
+
+  // dispatch resolves host_ and starts 'request' on a pooled connection.
+  void dispatch(::boost::beast::http::request<::boost::beast::http::string_body>&& request, Callback cb);
+
   util::FormattingLogger log_;
   std::shared_ptr<::boost::asio::io_service> io_service_;
-  ::boost::asio::ip::tcp::resolver resolver_;
+  std::shared_ptr<dns::ResolverCache> resolver_cache_;
   std::string host_;
   std::uint16_t port_;
-  RequestFactory request_factory_;
+  std::shared_ptr<ConnectionPool> connection_pool_;
+  Options options_;
+  ::boost::beast::http::request_header<> header_template_;
+  ::boost::beast::http::request_header<> body_header_template_;
 };
 
 }  // namespace boost
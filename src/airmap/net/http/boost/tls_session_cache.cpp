@@ -0,0 +1,107 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/boost/tls_session_cache.h>
+
+namespace ssl = boost::asio::ssl;
+
+namespace {
+
+// ex_data_index returns the index of the SSL ex data slot carrying the TlsSessionCache
+// of a connection. The app data slot is taken by asio for its verify callbacks.
+int ex_data_index() {
+  static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return index;
+}
+
+}  // namespace
+
+const std::shared_ptr<::boost::asio::ssl::context>& airmap::net::http::boost::TlsSessionCache::ssl_context() {
+  static const std::shared_ptr<::ssl::context> context = []() {
+    auto context = std::make_shared<::ssl::context>(::ssl::context::sslv23);
+    context->set_default_verify_paths();
+    context->set_verify_mode(::ssl::verify_peer);
+
+    // We keep sessions ourselves, per host, and only want to be told about new ones.
+    SSL_CTX_set_session_cache_mode(context->native_handle(),
+                                   SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(context->native_handle(), &TlsSessionCache::handle_new_session);
+
+    return context;
+  }();
+
+  return context;
+}
+
+std::shared_ptr<airmap::net::http::boost::TlsSessionCache> airmap::net::http::boost::TlsSessionCache::create(
+    const std::string& host) {
+  return std::shared_ptr<TlsSessionCache>{new TlsSessionCache{host}};
+}
+
+int airmap::net::http::boost::TlsSessionCache::handle_new_session(SSL* ssl, SSL_SESSION* session) {
+  if (auto cache = static_cast<TlsSessionCache*>(SSL_get_ex_data(ssl, ex_data_index()))) {
+    cache->remember(session);
+    // We took ownership of 'session'.
+    return 1;
+  }
+
+  return 0;
+}
+
+airmap::net::http::boost::TlsSessionCache::TlsSessionCache(const std::string& host) : host_{host} {
+}
+
+airmap::net::http::boost::TlsSessionCache::~TlsSessionCache() {
+  if (session_)
+    SSL_SESSION_free(session_);
+}
+
+const std::string& airmap::net::http::boost::TlsSessionCache::host() const {
+  return host_;
+}
+
+void airmap::net::http::boost::TlsSessionCache::prepare(SSL* ssl) {
+  SSL_set_ex_data(ssl, ex_data_index(), this);
+
+  // Server name indication must not carry IP address literals.
+  ::boost::system::error_code ec;
+  ::boost::asio::ip::make_address(host_, ec);
+  if (ec)
+    SSL_set_tlsext_host_name(ssl, host_.c_str());
+
+  std::lock_guard<std::mutex> lg{guard_};
+  if (session_)
+    SSL_set_session(ssl, session_);
+}
+
+void airmap::net::http::boost::TlsSessionCache::record(SSL* ssl) {
+  if (SSL_session_reused(ssl)) {
+    ++resumed_;
+  } else {
+    ++full_;
+  }
+}
+
+std::uint64_t airmap::net::http::boost::TlsSessionCache::resumed() const {
+  return resumed_.load();
+}
+
+std::uint64_t airmap::net::http::boost::TlsSessionCache::full() const {
+  return full_.load();
+}
+
+void airmap::net::http::boost::TlsSessionCache::remember(SSL_SESSION* session) {
+  std::lock_guard<std::mutex> lg{guard_};
+  if (session_)
+    SSL_SESSION_free(session_);
+  session_ = session;
+}
@@ -0,0 +1,85 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_BOOST_TLS_SESSION_CACHE_H_
+#define AIRMAP_NET_HTTP_BOOST_TLS_SESSION_CACHE_H_
+
+#include <airmap/do_not_copy_or_move.h>
+
+#include <boost/asio/ssl.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace airmap {
+namespace net {
+namespace http {
+namespace boost {
+
+/// TlsSessionCache remembers the TLS session most recently negotiated with
+/// a host, such that new connections to the host resume it with an
+/// abbreviated handshake instead of a full one.
+///
+/// Sessions are picked up from the new-session callback of the shared
+/// ssl::context, which covers both session ids and session tickets, the
+/// latter also when delivered after the handshake as with TLS 1.3.
+class TlsSessionCache : DoNotCopyOrMove {
+ public:
+  /// ssl_context returns the process-wide client ssl::context.
+  ///
+  /// The context is set up on first use, loading the system CA store exactly once.
+  static const std::shared_ptr<::boost::asio::ssl::context>& ssl_context();
+
+  /// create returns a new TlsSessionCache instance for 'host'.
+  static std::shared_ptr<TlsSessionCache> create(const std::string& host);
+
+  ~TlsSessionCache();
+
+  /// host returns the host that sessions are cached for.
+  const std::string& host() const;
+
+  /// prepare readies 'ssl' for a client handshake with host, setting the
+  /// server name indication and the cached session, if any.
+  void prepare(SSL* ssl);
+
+  /// record accounts for the completed handshake on 'ssl'.
+  void record(SSL* ssl);
+
+  /// resumed returns the number of handshakes that resumed a cached session.
+  std::uint64_t resumed() const;
+
+  /// full returns the number of full handshakes.
+  std::uint64_t full() const;
+
+ private:
+  static int handle_new_session(SSL* ssl, SSL_SESSION* session);
+
+  explicit TlsSessionCache(const std::string& host);
+
+  void remember(SSL_SESSION* session);
+
+  std::string host_;
+  std::mutex guard_;
+  SSL_SESSION* session_{nullptr};
+  std::atomic<std::uint64_t> resumed_{0};
+  std::atomic<std::uint64_t> full_{0};
+};
+
+}  // namespace boost
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_BOOST_TLS_SESSION_CACHE_H_
@@ -0,0 +1,152 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/caching_requester.h>
+
+#include <airmap/net/http/request_key.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int ok{200};
+constexpr unsigned int not_modified{304};
+
+// find returns the value of header 'name' in 'response' or the empty string.
+std::string find(const airmap::net::http::Response& response, const std::string& name) {
+  auto it = response.headers.find(name);
+  return it == response.headers.end() ? std::string{} : it->second;
+}
+
+// Freshness summarizes the Cache-Control directives of a response.
+struct Freshness {
+  bool store{true};
+  std::chrono::seconds max_age;
+};
+
+Freshness freshness_of(const airmap::net::http::Response& response, std::chrono::seconds ttl) {
+  Freshness result{true, ttl};
+
+  std::vector<std::string> directives;
+  auto cache_control = find(response, "cache-control");
+  boost::algorithm::split(directives, cache_control, boost::algorithm::is_any_of(","));
+
+  for (auto directive : directives) {
+    boost::algorithm::trim(directive);
+    boost::algorithm::to_lower(directive);
+
+    if (directive == "no-store" || directive == "private") {
+      result.store = false;
+    } else if (directive == "no-cache") {
+      result.max_age = std::chrono::seconds{0};
+    } else if (boost::algorithm::starts_with(directive, "max-age=")) {
+      try {
+        result.max_age = std::chrono::seconds{boost::lexical_cast<std::int64_t>(directive.substr(8))};
+      } catch (const boost::bad_lexical_cast&) {
+        // Malformed directives leave the default in place.
+      }
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+airmap::net::http::CachingRequester::CachingRequester(const std::string& scope, const Microseconds& ttl,
+                                                      const Microseconds& max_stale,
+                                                      const std::shared_ptr<ResponseCache>& cache,
+                                                      const std::shared_ptr<Requester>& next)
+    : scope_{scope},
+      ttl_{static_cast<std::int64_t>(ttl.total_seconds())},
+      max_stale_{static_cast<std::int64_t>(max_stale.total_seconds())},
+      cache_{cache},
+      next_{next} {
+}
+
+void airmap::net::http::CachingRequester::delete_(const std::string& path,
+                                                  std::unordered_map<std::string, std::string>&& query,
+                                                  std::unordered_map<std::string, std::string>&& headers,
+                                                  Callback cb) {
+  next_->delete_(path, std::move(query), std::move(headers), std::move(cb));
+}
+
+void airmap::net::http::CachingRequester::get(const std::string& path,
+                                              std::unordered_map<std::string, std::string>&& query,
+                                              std::unordered_map<std::string, std::string>&& headers, Callback cb) {
+  auto key    = scope_ + " " + request_key("GET", path, query, headers);
+  auto cached = cache_->lookup(key);
+
+  if (cached) {
+    if (ResponseCache::Clock::now() < cached.get().expires) {
+      cb(Result{cached.get().response});
+      return;
+    }
+
+    auto etag          = find(cached.get().response, "etag");
+    auto last_modified = find(cached.get().response, "last-modified");
+
+    if (!etag.empty())
+      headers["If-None-Match"] = etag;
+    if (!last_modified.empty())
+      headers["If-Modified-Since"] = last_modified;
+  }
+
+  next_->get(path, std::move(query), std::move(headers),
+             [cache = cache_, ttl = ttl_, max_stale = max_stale_, key, cached, cb = std::move(cb)](
+                 const Result& result) {
+               if (!result || result.value().status >= 500) {
+                 // Stale data beats no data, in particular when offline. Entries
+                 // persisted by previous runs might be arbitrarily old, though.
+                 if (cached && !cached.get().persisted &&
+                     ResponseCache::Clock::now() - cached.get().expires <= max_stale)
+                   cb(Result{cached.get().response});
+                 else
+                   cb(result);
+                 return;
+               }
+
+               const auto& response = result.value();
+               auto freshness       = freshness_of(response, ttl);
+
+               if (response.status == not_modified && cached) {
+                 // A 304 carries updated cache directives, but no body.
+                 auto entry      = cached.get();
+                 entry.expires   = ResponseCache::Clock::now() + freshness.max_age;
+                 entry.persisted = false;
+                 cache->store(key, entry);
+                 cb(Result{entry.response});
+                 return;
+               }
+
+               if (response.status == ok && freshness.store)
+                 cache->store(key, ResponseCache::Entry{response, ResponseCache::Clock::now() + freshness.max_age});
+
+               cb(result);
+             });
+}
+
+void airmap::net::http::CachingRequester::patch(const std::string& path,
+                                                std::unordered_map<std::string, std::string>&& headers,
+                                                const std::string& body, Callback cb) {
+  next_->patch(path, std::move(headers), body, std::move(cb));
+}
+
+void airmap::net::http::CachingRequester::post(const std::string& path,
+                                               std::unordered_map<std::string, std::string>&& headers,
+                                               const std::string& body, Callback cb) {
+  next_->post(path, std::move(headers), body, std::move(cb));
+}
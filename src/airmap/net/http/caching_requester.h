@@ -0,0 +1,72 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_CACHING_REQUESTER_H_
+#define AIRMAP_NET_HTTP_CACHING_REQUESTER_H_
+
+#include <airmap/date_time.h>
+#include <airmap/net/http/requester.h>
+#include <airmap/net/http/response_cache.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// CachingRequester answers get requests from a ResponseCache and hands off all other requests.
+///
+/// Fresh entries are returned without touching the network. Stale entries are
+/// revalidated with the origin using their ETag or Last-Modified validators.
+/// If the origin cannot be reached or fails with a server error, stale entries
+/// are returned instead, such that cached data remains available while offline.
+/// Entries are only served this way for max_stale past their expiry, and never
+/// if they have been loaded from the disk tier, i.e., stored by a previous run.
+///
+/// Freshness follows Cache-Control max-age, falling back to a configured ttl.
+/// Responses marked no-store are never cached, responses marked no-cache
+/// are revalidated on every request.
+///
+/// Requests are keyed by scope and request_key, which covers path, query and
+/// headers. Callers presenting different credentials never share entries.
+class CachingRequester : public Requester {
+ public:
+  /// CachingRequester initializes a new instance, storing responses under 'scope' in 'cache'
+  /// and handing off requests to 'next'. Responses without Cache-Control max-age stay fresh for 'ttl'.
+  /// Stale responses stand in for failed requests for at most 'max_stale' past their expiry.
+  explicit CachingRequester(const std::string& scope, const Microseconds& ttl, const Microseconds& max_stale,
+                            const std::shared_ptr<ResponseCache>& cache, const std::shared_ptr<Requester>& next);
+
+  void delete_(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+               std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void get(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+           std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void patch(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+             Callback cb) override;
+  void post(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+            Callback cb) override;
+
+ private:
+  std::string scope_;
+  std::chrono::seconds ttl_;
+  std::chrono::seconds max_stale_;
+  std::shared_ptr<ResponseCache> cache_;
+  std::shared_ptr<Requester> next_;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_CACHING_REQUESTER_H_
@@ -0,0 +1,89 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/coalescing_requester.h>
+
+#include <airmap/net/http/request_key.h>
+
+airmap::net::http::CoalescingRequester::CoalescingRequester(const std::shared_ptr<Requester>& next) : next_{next} {
+}
+
+std::size_t airmap::net::http::CoalescingRequester::in_flight() {
+  std::lock_guard<std::mutex> lg{guard_};
+  return in_flight_.size();
+}
+
+void airmap::net::http::CoalescingRequester::delete_(const std::string& path,
+                                                     std::unordered_map<std::string, std::string>&& query,
+                                                     std::unordered_map<std::string, std::string>&& headers,
+                                                     Callback cb) {
+  next_->delete_(path, std::move(query), std::move(headers), std::move(cb));
+}
+
+void airmap::net::http::CoalescingRequester::get(const std::string& path,
+                                                 std::unordered_map<std::string, std::string>&& query,
+                                                 std::unordered_map<std::string, std::string>&& headers, Callback cb) {
+  auto key = request_key("GET", path, query, headers);
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    auto it = in_flight_.find(key);
+    if (it != in_flight_.end()) {
+      it->second.emplace_back(std::move(cb));
+      return;
+    }
+    in_flight_[key].emplace_back(std::move(cb));
+  }
+
+  // The lock must not be held while handing off, as 'next' might complete synchronously.
+  next_->get(path, std::move(query), std::move(headers),
+             [sp = shared_from_this(), key](const Result& result) { sp->complete(key, result); });
+}
+
+void airmap::net::http::CoalescingRequester::patch(const std::string& path,
+                                                   std::unordered_map<std::string, std::string>&& headers,
+                                                   const std::string& body, Callback cb) {
+  next_->patch(path, std::move(headers), body, std::move(cb));
+}
+
+void airmap::net::http::CoalescingRequester::post(const std::string& path,
+                                                  std::unordered_map<std::string, std::string>&& headers,
+                                                  const std::string& body, Callback cb) {
+  next_->post(path, std::move(headers), body, std::move(cb));
+}
+
+void airmap::net::http::CoalescingRequester::complete(const std::string& key, const Result& result) {
+  std::vector<Callback> callbacks;
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    auto it = in_flight_.find(key);
+    if (it == in_flight_.end())
+      return;
+    callbacks.swap(it->second);
+    in_flight_.erase(it);
+  }
+
+  if (callbacks.size() == 1 || !result) {
+    for (const auto& cb : callbacks)
+      cb(result);
+    return;
+  }
+
+  auto response = result.value();
+  if (!response.memo)
+    response.memo = std::make_shared<Memo>();
+
+  Result shared{std::move(response)};
+  for (const auto& cb : callbacks)
+    cb(shared);
+}
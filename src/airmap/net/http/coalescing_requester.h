@@ -0,0 +1,67 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_COALESCING_REQUESTER_H_
+#define AIRMAP_NET_HTTP_COALESCING_REQUESTER_H_
+
+#include <airmap/net/http/requester.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// CoalescingRequester collapses identical get requests in flight into a single request.
+///
+/// Requests are identical if they agree in method, path, query and headers. In
+/// particular, requests issued with different credentials are never coalesced.
+/// Callers issuing a request while an identical one is in flight are attached
+/// to it, and all of them receive the very same response. The response carries
+/// a Memo, such that jsend_parsing_request_callback parses its body only once.
+///
+/// All other requests are handed off to the next Requester unchanged.
+class CoalescingRequester : public Requester, public std::enable_shared_from_this<CoalescingRequester> {
+ public:
+  /// CoalescingRequester initializes a new instance, handing off requests to 'next'.
+  explicit CoalescingRequester(const std::shared_ptr<Requester>& next);
+
+  /// in_flight returns the number of distinct requests currently in flight.
+  std::size_t in_flight();
+
+  void delete_(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+               std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void get(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+           std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void patch(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+             Callback cb) override;
+  void post(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+            Callback cb) override;
+
+ private:
+  // complete hands out 'result' to all callbacks waiting for the request identified by 'key'.
+  void complete(const std::string& key, const Result& result);
+
+  std::shared_ptr<Requester> next_;
+  std::mutex guard_;
+  std::unordered_map<std::string, std::vector<Callback>> in_flight_;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_COALESCING_REQUESTER_H_
@@ -0,0 +1,232 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/content_coding.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <zlib.h>
+
+#if defined(AIRMAP_ENABLE_BROTLI)
+#include <brotli/decode.h>
+#endif  // AIRMAP_ENABLE_BROTLI
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+// Decoded output is produced in chunks of this size.
+constexpr std::size_t chunk_size{16 * 1024};
+
+// Window bits selecting the zlib (RFC 1950), gzip (RFC 1952) and raw deflate (RFC 1951) formats.
+// Inflating with auto_window_bits accepts both the zlib and the gzip format.
+constexpr int zlib_window_bits{15};
+constexpr int gzip_window_bits{15 + 16};
+constexpr int auto_window_bits{15 + 32};
+constexpr int raw_window_bits{-15};
+
+class IdentityDecoder : public airmap::net::http::ContentDecoder {
+ public:
+  explicit IdentityDecoder(std::size_t max_size) : max_size_{max_size} {
+  }
+
+  bool decode(const char* data, std::size_t size, std::string& out) override {
+    out.append(data, size);
+    return out.size() <= max_size_;
+  }
+
+  bool finish() override {
+    return true;
+  }
+
+ private:
+  std::size_t max_size_;
+};
+
+// ZlibDecoder decodes the gzip and deflate content codings.
+//
+// 'deflate' is specified as the zlib format, but a fair share of servers
+// send raw deflate data instead. We tell the two apart from the first byte,
+// which carries the compression method 8 for the zlib format.
+class ZlibDecoder : public airmap::net::http::ContentDecoder {
+ public:
+  explicit ZlibDecoder(bool gzip, std::size_t max_size) : gzip_{gzip}, max_size_{max_size} {
+  }
+
+  ~ZlibDecoder() {
+    if (initialized_)
+      inflateEnd(&stream_);
+  }
+
+  bool decode(const char* data, std::size_t size, std::string& out) override {
+    if (size == 0)
+      return true;
+
+    if (!initialized_) {
+      auto window_bits = auto_window_bits;
+      if (!gzip_)
+        window_bits = (static_cast<unsigned char>(data[0]) & 0x0f) == 8 ? zlib_window_bits : raw_window_bits;
+      if (inflateInit2(&stream_, window_bits) != Z_OK)
+        return false;
+      initialized_ = true;
+    }
+
+    stream_.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream_.avail_in = static_cast<uInt>(size);
+
+    while (stream_.avail_in > 0) {
+      if (done_) {
+        // gzip allows for multiple members, which decode to their concatenation.
+        if (!gzip_ || inflateReset(&stream_) != Z_OK)
+          return false;
+        done_ = false;
+      }
+
+      auto offset = out.size();
+      out.resize(offset + chunk_size);
+      stream_.next_out  = reinterpret_cast<Bytef*>(&out[offset]);
+      stream_.avail_out = static_cast<uInt>(chunk_size);
+
+      auto rc = inflate(&stream_, Z_NO_FLUSH);
+      out.resize(offset + chunk_size - stream_.avail_out);
+
+      if (out.size() > max_size_)
+        return false;
+
+      if (rc == Z_STREAM_END)
+        done_ = true;
+      else if (rc != Z_OK && rc != Z_BUF_ERROR)
+        return false;
+    }
+
+    return true;
+  }
+
+  bool finish() override {
+    return done_;
+  }
+
+ private:
+  bool gzip_;
+  std::size_t max_size_;
+  bool initialized_{false};
+  bool done_{false};
+  z_stream stream_{};
+};
+
+#if defined(AIRMAP_ENABLE_BROTLI)
+
+class BrotliDecoder : public airmap::net::http::ContentDecoder {
+ public:
+  explicit BrotliDecoder(std::size_t max_size)
+      : max_size_{max_size}, state_{BrotliDecoderCreateInstance(nullptr, nullptr, nullptr)} {
+    if (!state_)
+      throw std::bad_alloc{};
+  }
+
+  ~BrotliDecoder() {
+    BrotliDecoderDestroyInstance(state_);
+  }
+
+  bool decode(const char* data, std::size_t size, std::string& out) override {
+    auto next_in  = reinterpret_cast<const std::uint8_t*>(data);
+    auto avail_in = size;
+
+    while (true) {
+      auto offset = out.size();
+      out.resize(offset + chunk_size);
+      auto next_out  = reinterpret_cast<std::uint8_t*>(&out[offset]);
+      auto avail_out = chunk_size;
+
+      auto rc = BrotliDecoderDecompressStream(state_, &avail_in, &next_in, &avail_out, &next_out, nullptr);
+      out.resize(offset + chunk_size - avail_out);
+
+      if (out.size() > max_size_)
+        return false;
+
+      switch (rc) {
+        case BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT:
+          continue;
+        case BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT:
+          return true;
+        case BROTLI_DECODER_RESULT_SUCCESS:
+          return avail_in == 0;
+        default:
+          return false;
+      }
+    }
+  }
+
+  bool finish() override {
+    return BrotliDecoderIsFinished(state_) == BROTLI_TRUE;
+  }
+
+ private:
+  std::size_t max_size_;
+  BrotliDecoderState* state_;
+};
+
+#endif  // AIRMAP_ENABLE_BROTLI
+
+}  // namespace
+
+const std::string& airmap::net::http::content_coding::accepted() {
+#if defined(AIRMAP_ENABLE_BROTLI)
+  static const std::string value{"gzip, deflate, br"};
+#else
+  static const std::string value{"gzip, deflate"};
+#endif  // AIRMAP_ENABLE_BROTLI
+  return value;
+}
+
+std::string airmap::net::http::content_coding::compress(const std::string& in) {
+  z_stream stream{};
+
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzip_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    throw std::runtime_error{"failed to initialize deflate stream"};
+
+  std::string out(deflateBound(&stream, in.size()), '\0');
+
+  stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  stream.avail_in  = static_cast<uInt>(in.size());
+  stream.next_out  = reinterpret_cast<Bytef*>(&out[0]);
+  stream.avail_out = static_cast<uInt>(out.size());
+
+  auto rc = ::deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  if (rc != Z_STREAM_END)
+    throw std::runtime_error{"failed to compress"};
+
+  return out;
+}
+
+std::unique_ptr<airmap::net::http::ContentDecoder> airmap::net::http::ContentDecoder::create(
+    const std::string& coding, std::size_t max_size) {
+  auto c = ::boost::algorithm::to_lower_copy(::boost::algorithm::trim_copy(coding));
+
+  if (c.empty() || c == content_coding::identity)
+    return std::unique_ptr<ContentDecoder>{new IdentityDecoder{max_size}};
+  if (c == content_coding::gzip || c == "x-gzip")
+    return std::unique_ptr<ContentDecoder>{new ZlibDecoder{true, max_size}};
+  if (c == content_coding::deflate)
+    return std::unique_ptr<ContentDecoder>{new ZlibDecoder{false, max_size}};
+#if defined(AIRMAP_ENABLE_BROTLI)
+  if (c == content_coding::brotli)
+    return std::unique_ptr<ContentDecoder>{new BrotliDecoder{max_size}};
+#endif  // AIRMAP_ENABLE_BROTLI
+
+  return nullptr;
+}
@@ -0,0 +1,70 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_CONTENT_CODING_H_
+#define AIRMAP_NET_HTTP_CONTENT_CODING_H_
+
+#include <airmap/do_not_copy_or_move.h>
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace airmap {
+namespace net {
+namespace http {
+namespace content_coding {
+
+static constexpr const char* identity{"identity"};
+static constexpr const char* gzip{"gzip"};
+static constexpr const char* deflate{"deflate"};
+static constexpr const char* brotli{"br"};
+
+/// accepted returns the value of an Accept-Encoding header
+/// listing all content codings understood by ContentDecoder.
+const std::string& accepted();
+
+/// compress returns 'in' compressed to the gzip format.
+std::string compress(const std::string& in);
+
+}  // namespace content_coding
+
+/// ContentDecoder incrementally decodes a body transferred with a content coding.
+class ContentDecoder : DoNotCopyOrMove {
+ public:
+  /// create returns a decoder for 'coding', as found in a Content-Encoding header,
+  /// or nullptr if 'coding' is not supported. The empty coding refers to identity.
+  ///
+  /// Decoding stops once 'out' grows beyond 'max_size' bytes, protecting
+  /// against small bodies that decompress to huge amounts of data.
+  static std::unique_ptr<ContentDecoder> create(const std::string& coding,
+                                                std::size_t max_size = std::numeric_limits<std::size_t>::max());
+
+  virtual ~ContentDecoder() = default;
+
+  /// decode decodes 'size' bytes at 'data', appending the result to 'out'.
+  /// Returns false if the input is corrupt or if 'out' exceeds the maximum size.
+  virtual bool decode(const char* data, std::size_t size, std::string& out) = 0;
+
+  /// finish returns false if the input ended before the encoded stream was complete.
+  virtual bool finish() = 0;
+
+ protected:
+  ContentDecoder() = default;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_CONTENT_CODING_H_
@@ -37,7 +37,13 @@ Requester::Callback jsend_parsing_request_callback(const std::function<void(cons
         case Response::Classification::success:
         case Response::Classification::client_error:
         case Response::Classification::server_error:
-          next(jsend::parse_to_outcome<T>(response.body));
+          // Responses shared by coalesced requests carry a memo, parsing their body once for all callbacks.
+          if (response.memo)
+            next(response.memo->memoize<Outcome<T, Error>>([&response]() {
+              return jsend::parse_to_outcome<T>(response.body);
+            }));
+          else
+            next(jsend::parse_to_outcome<T>(response.body));
           break;
         default:
           next(Outcome<T, Error>{Error{"networking error"}
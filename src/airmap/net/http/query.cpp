@@ -0,0 +1,56 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/query.h>
+
+namespace {
+
+// unescaped returns true if 'c' is sent as is in a query, either because it is
+// unreserved or because the API expects it unencoded.
+constexpr bool unescaped(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.' ||
+         c == '_' || c == '~' || c == '/' || c == '@' || c == '&' || c == '%' || c == ';' || c == '=';
+}
+
+// append_encoded percent-encodes 'in' and appends the result to 'out'.
+void append_encoded(const std::string& in, std::string& out) {
+  static constexpr const char hex[] = "0123456789ABCDEF";
+
+  for (unsigned char c : in) {
+    if (unescaped(c)) {
+      out.push_back(c);
+    } else {
+      out.push_back('%');
+      out.push_back(hex[c >> 4]);
+      out.push_back(hex[c & 0x0f]);
+    }
+  }
+}
+
+}  // namespace
+
+void airmap::net::http::append_query(const std::unordered_map<std::string, std::string>& query, std::string& out) {
+  // Reserving for the unescaped size avoids reallocations in the common case.
+  auto size = out.size() + query.size();
+  for (const auto& pair : query)
+    size += pair.first.size() + pair.second.size() + 1;
+  out.reserve(size);
+
+  for (auto it = query.begin(); it != query.end(); ++it) {
+    if (it != query.begin())
+      out.push_back('&');
+
+    append_encoded(it->first, out);
+    out.push_back('=');
+    append_encoded(it->second, out);
+  }
+}
@@ -0,0 +1,33 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_QUERY_H_
+#define AIRMAP_NET_HTTP_QUERY_H_
+
+#include <string>
+#include <unordered_map>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// append_query percent-encodes 'query' as "key=value" pairs separated by '&' and appends the result to 'out'.
+///
+/// Besides unreserved characters, '/', '@', '&', '%', ';' and '=' are sent as is,
+/// as the API expects them unencoded.
+void append_query(const std::unordered_map<std::string, std::string>& query, std::string& out);
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_QUERY_H_
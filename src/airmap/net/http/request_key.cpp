@@ -0,0 +1,58 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/request_key.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cstdio>
+#include <map>
+
+namespace {
+
+// escape percent-encodes all characters of 's' that delimit the parts of a key.
+std::string escape(const std::string& s) {
+  std::string result;
+  result.reserve(s.size());
+
+  for (auto c : s) {
+    if (c == '%' || c == '&' || c == '=' || c == '?' || c == '\n') {
+      char buffer[4];
+      std::snprintf(buffer, sizeof(buffer), "%%%02X", static_cast<unsigned char>(c));
+      result += buffer;
+    } else {
+      result += c;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+std::string airmap::net::http::request_key(const std::string& method, const std::string& path,
+                                           const std::unordered_map<std::string, std::string>& query,
+                                           const std::unordered_map<std::string, std::string>& headers) {
+  // Sorting makes the key independent of the iteration order of the maps.
+  std::map<std::string, std::string> sorted_query{query.begin(), query.end()};
+  std::map<std::string, std::string> sorted_headers;
+  for (const auto& pair : headers)
+    sorted_headers[::boost::algorithm::to_lower_copy(pair.first)] = pair.second;
+
+  auto key = method + " " + escape(path) + "?";
+  for (const auto& pair : sorted_query)
+    key += escape(pair.first) + "=" + escape(pair.second) + "&";
+  for (const auto& pair : sorted_headers)
+    key += "\n" + escape(pair.first) + ": " + escape(pair.second);
+
+  return key;
+}
@@ -0,0 +1,36 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_REQUEST_KEY_H_
+#define AIRMAP_NET_HTTP_REQUEST_KEY_H_
+
+#include <string>
+#include <unordered_map>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// request_key returns a key identifying a request with 'method', 'path', 'query' and 'headers'.
+///
+/// Two requests share a key if and only if they agree in all of these, independent of
+/// the iteration order of 'query' and 'headers' and of the case of header names. In
+/// particular, requests issued with different credentials never share a key.
+std::string request_key(const std::string& method, const std::string& path,
+                        const std::unordered_map<std::string, std::string>& query,
+                        const std::unordered_map<std::string, std::string>& headers);
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_REQUEST_KEY_H_
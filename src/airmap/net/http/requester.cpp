@@ -22,6 +22,12 @@ namespace {
 constexpr const char* component{"airmap::Daemon"};
 }  // namespace
 
+bool airmap::net::http::request_sent(const Error& error) {
+  auto it = error.values().find(Error::Value{std::string{request_sent_key}});
+  // Errors without an explicit marker might have happened anywhere, we assume the worst.
+  return it == error.values().end() || it->second.type() != Error::Value::Type::boolean || it->second.boolean();
+}
+
 airmap::net::http::RoutingRequester::RoutingRequester(const std::string& route, const std::shared_ptr<Requester>& next)
     : route_{route}, next_{next} {
 }
@@ -80,7 +86,8 @@ void airmap::net::http::LoggingRequester::delete_(const std::string& path,
     if (result) {
       auto r = log_.debug(component);
       r << "successfully finished delete request " << uuid << " in " << duration.total_milliseconds() << " [ms]\n"
-        << "  version: " << result.value().version << " status: " << result.value().status << "\n";
+        << "  version: " << result.value().version << " status: " << result.value().status << "\n"
+        << "  bytes on wire: " << result.value().wire_bytes << " decoded: " << result.value().decoded_bytes << "\n";
       if (!result.value().headers.empty()) {
         r << "  headers:\n";
         for (const auto& pair : result.value().headers)
@@ -121,7 +128,8 @@ void airmap::net::http::LoggingRequester::get(const std::string& path,
     if (result) {
       auto r = log_.debug(component);
       r << "successfully finished get request " << uuid << " in " << duration.total_milliseconds() << " [ms]\n"
-        << "  version: " << result.value().version << " status: " << result.value().status << "\n";
+        << "  version: " << result.value().version << " status: " << result.value().status << "\n"
+        << "  bytes on wire: " << result.value().wire_bytes << " decoded: " << result.value().decoded_bytes << "\n";
       if (!result.value().headers.empty()) {
         r << "  headers:\n";
         for (const auto& pair : result.value().headers)
@@ -160,7 +168,8 @@ void airmap::net::http::LoggingRequester::patch(const std::string& path,
     if (result) {
       auto r = log_.debug(component);
       r << "successfully finished patch request " << uuid << " in " << duration.total_milliseconds() << " [ms]\n"
-        << "  version: " << result.value().version << " status: " << result.value().status << "\n";
+        << "  version: " << result.value().version << " status: " << result.value().status << "\n"
+        << "  bytes on wire: " << result.value().wire_bytes << " decoded: " << result.value().decoded_bytes << "\n";
       if (!result.value().headers.empty()) {
         r << "  headers:\n";
         for (const auto& pair : result.value().headers)
@@ -199,7 +208,8 @@ void airmap::net::http::LoggingRequester::post(const std::string& path,
     if (result) {
       auto r = log_.debug(component);
       r << "successfully finished post request " << uuid << " in " << duration.total_milliseconds() << " [ms]\n"
-        << "  version: " << result.value().version << " status: " << result.value().status << "\n";
+        << "  version: " << result.value().version << " status: " << result.value().status << "\n"
+        << "  bytes on wire: " << result.value().wire_bytes << " decoded: " << result.value().decoded_bytes << "\n";
       if (!result.value().headers.empty()) {
         r << "  headers:\n";
         for (const auto& pair : result.value().headers)
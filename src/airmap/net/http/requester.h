@@ -53,6 +53,14 @@ class Requester : DoNotCopyOrMove {
   Requester() = default;
 };
 
+/// request_sent_key names the boolean Error::Value attached to transport errors, telling
+/// whether the failed request might have reached the server.
+constexpr const char* request_sent_key{"request-sent"};
+
+/// request_sent returns false if 'error' is known to have occured before the request
+/// was handed to the server, in which case retrying the request is safe for all verbs.
+bool request_sent(const Error& error);
+
 // RoutingRequester prefixes incoming paths and hands them off to the next Requester implementation.
 class RoutingRequester : public Requester {
  public:
@@ -13,13 +13,38 @@
 #ifndef AIRMAP_NET_HTTP_RESPONSE_H_
 #define AIRMAP_NET_HTTP_RESPONSE_H_
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
 
 namespace airmap {
 namespace net {
 namespace http {
 
+/// Memo caches values decoded from a response body by their type, such that a
+/// response handed out to multiple callbacks is decoded only once.
+class Memo {
+ public:
+  /// memoize returns the value of type T computed by 'f', invoking 'f' only for the first caller.
+  template <typename T, typename F>
+  const T& memoize(F&& f) {
+    std::lock_guard<std::mutex> lg{guard_};
+
+    auto it = values_.find(typeid(T));
+    if (it == values_.end())
+      it = values_.emplace(typeid(T), std::make_shared<T>(f())).first;
+
+    return *std::static_pointer_cast<T>(it->second);
+  }
+
+ private:
+  std::mutex guard_;
+  std::unordered_map<std::type_index, std::shared_ptr<void>> values_;
+};
+
 struct Response {
   // Classification enumerates all known classes of response statuses.
   enum class Classification {
@@ -36,8 +61,11 @@ struct Response {
 
   unsigned int version;
   unsigned int status;
-  std::unordered_map<std::string, std::string> headers;
+  std::unordered_map<std::string, std::string> headers;  // Header names are lower case.
   std::string body;
+  std::uint64_t wire_bytes;     // The size of the body as transferred, before decoding any content coding.
+  std::uint64_t decoded_bytes;  // The size of the body after decoding.
+  std::shared_ptr<Memo> memo{};  // Shared by all callbacks receiving this response, might be null.
 };
 
 }  // namespace http
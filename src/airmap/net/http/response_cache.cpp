@@ -0,0 +1,293 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/response_cache.h>
+
+#include <nlohmann/json.hpp>
+
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// size_of approximates the memory occupied by 'entry' stored for 'key'.
+std::size_t size_of(const std::string& key, const airmap::net::http::ResponseCache::Entry& entry) {
+  auto result = key.size() + entry.response.body.size();
+  for (const auto& pair : entry.response.headers)
+    result += pair.first.size() + pair.second.size();
+  return result;
+}
+
+// digest_of returns the hex-encoded SHA-256 digest of 'key', or the empty string on failure.
+std::string digest_of(const std::string& key) {
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int size = 0;
+
+  if (EVP_Digest(key.data(), key.size(), md, &size, EVP_sha256(), nullptr) != 1)
+    return std::string{};
+
+  std::ostringstream ss;
+  for (unsigned int i = 0; i < size; i++)
+    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(md[i]);
+  return ss.str();
+}
+
+}  // namespace
+
+std::shared_ptr<airmap::net::http::ResponseCache> airmap::net::http::ResponseCache::create(
+    const Configuration& configuration) {
+  return std::shared_ptr<ResponseCache>{new ResponseCache{configuration}};
+}
+
+airmap::net::http::ResponseCache::ResponseCache(const Configuration& configuration) : configuration_{configuration} {
+  if (configuration_.directory)
+    writer_ = std::thread{[this]() { write(); }};
+}
+
+airmap::net::http::ResponseCache::~ResponseCache() {
+  {
+    std::lock_guard<std::mutex> lg{writes_guard_};
+    stopping_ = true;
+  }
+
+  writes_cv_.notify_all();
+
+  if (writer_.joinable())
+    writer_.join();
+}
+
+airmap::Optional<airmap::net::http::ResponseCache::Entry> airmap::net::http::ResponseCache::lookup(
+    const std::string& key) {
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+  }
+
+  if (!configuration_.directory)
+    return Optional<Entry>{};
+
+  // We read from disk without holding guard_, keeping other callers from waiting for us.
+  auto entry = load(key);
+  if (!entry)
+    return entry;
+
+  std::lock_guard<std::mutex> lg{guard_};
+
+  // The entry might have been stored while we were reading it from disk.
+  auto it = index_.find(key);
+  if (it != index_.end())
+    return it->second->second;
+
+  insert(key, entry.get());
+  return entry;
+}
+
+void airmap::net::http::ResponseCache::store(const std::string& key, const Entry& entry) {
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    insert(key, entry);
+  }
+
+  if (configuration_.directory) {
+    {
+      std::lock_guard<std::mutex> lg{writes_guard_};
+      writes_.emplace_back(key, entry);
+    }
+    writes_cv_.notify_one();
+  }
+}
+
+std::size_t airmap::net::http::ResponseCache::size() const {
+  std::lock_guard<std::mutex> lg{guard_};
+  return bytes_;
+}
+
+void airmap::net::http::ResponseCache::insert(const std::string& key, const Entry& entry) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    bytes_ -= size_of(key, it->second->second);
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+
+  auto size = size_of(key, entry);
+  // Entries exceeding the limit on their own would flush the entire cache.
+  if (size > configuration_.max_bytes)
+    return;
+
+  lru_.emplace_front(key, entry);
+  index_[key] = lru_.begin();
+  bytes_ += size;
+
+  while (bytes_ > configuration_.max_bytes) {
+    bytes_ -= size_of(lru_.back().first, lru_.back().second);
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+airmap::platform::Path airmap::net::http::ResponseCache::file_for(const std::string& digest) const {
+  return configuration_.directory.get() / (digest + ".json");
+}
+
+airmap::Optional<airmap::net::http::ResponseCache::Entry> airmap::net::http::ResponseCache::load(
+    const std::string& key) const {
+  auto digest = digest_of(key);
+  if (digest.empty())
+    return Optional<Entry>{};
+
+  std::ifstream in{file_for(digest)};
+  if (!in)
+    return Optional<Entry>{};
+
+  try {
+    nlohmann::json j;
+    in >> j;
+
+    if (j.at("key").get<std::string>() != digest)
+      return Optional<Entry>{};
+
+    Entry entry;
+    entry.response.version       = j.at("version").get<unsigned int>();
+    entry.response.status        = j.at("status").get<unsigned int>();
+    entry.response.headers       = j.at("headers").get<std::unordered_map<std::string, std::string>>();
+    entry.response.body          = j.at("body").get<std::string>();
+    entry.response.wire_bytes    = j.at("wire_bytes").get<std::uint64_t>();
+    entry.response.decoded_bytes = entry.response.body.size();
+    entry.expires                = Clock::time_point{std::chrono::seconds{j.at("expires").get<std::int64_t>()}};
+    entry.persisted              = true;
+
+    return entry;
+  } catch (const std::exception&) {
+    // Corrupt files are dropped silently, they are overwritten eventually.
+    return Optional<Entry>{};
+  }
+}
+
+void airmap::net::http::ResponseCache::write() {
+  prune();
+
+  std::unique_lock<std::mutex> ul{writes_guard_};
+
+  while (true) {
+    writes_cv_.wait(ul, [this]() { return stopping_ || !writes_.empty(); });
+
+    // Pending writes are finished before stopping.
+    if (writes_.empty())
+      return;
+
+    auto write = std::move(writes_.front());
+    writes_.pop_front();
+
+    ul.unlock();
+    persist(write.first, write.second);
+    ul.lock();
+  }
+}
+
+void airmap::net::http::ResponseCache::persist(const std::string& key, const Entry& entry) {
+  std::error_code ec;
+  fs::create_directories(configuration_.directory.get(), ec);
+  if (ec)
+    return;
+
+  auto digest = digest_of(key);
+  if (digest.empty())
+    return;
+
+  nlohmann::json j;
+  j["key"]        = digest;
+  j["version"]    = entry.response.version;
+  j["status"]     = entry.response.status;
+  j["headers"]    = entry.response.headers;
+  j["body"]       = entry.response.body;
+  j["wire_bytes"] = entry.response.wire_bytes;
+  j["expires"]    = std::chrono::duration_cast<std::chrono::seconds>(entry.expires.time_since_epoch()).count();
+
+  auto file = file_for(digest);
+  auto tmp  = file;
+  tmp += ".tmp";
+
+  {
+    std::ofstream out{tmp};
+    out << j;
+    if (!out)
+      return;
+  }
+
+  // An entry replacing a previous one for the same key frees up the previous one's space.
+  auto previous = fs::file_size(file, ec);
+  if (ec) {
+    previous = 0;
+    ec.clear();
+  }
+
+  // Renaming keeps readers from ever seeing partially written entries.
+  fs::rename(tmp, file, ec);
+  if (ec)
+    return;
+
+  auto size = fs::file_size(file, ec);
+  if (ec)
+    size = 0;
+
+  disk_bytes_ = disk_bytes_ - std::min<std::uintmax_t>(previous, disk_bytes_) + size;
+  if (disk_bytes_ > configuration_.max_disk_bytes)
+    prune();
+}
+
+void airmap::net::http::ResponseCache::prune() {
+  std::vector<std::tuple<fs::file_time_type, std::uintmax_t, fs::path>> files;
+  std::uintmax_t total = 0;
+
+  std::error_code ec;
+  for (fs::directory_iterator it{configuration_.directory.get(), ec}, end; !ec && it != end; it.increment(ec)) {
+    if (it->path().extension() != ".json")
+      continue;
+
+    auto size = it->file_size(ec);
+    auto time = it->last_write_time(ec);
+    if (ec) {
+      ec.clear();
+      continue;
+    }
+
+    files.emplace_back(time, size, it->path());
+    total += size;
+  }
+
+  std::sort(files.begin(), files.end());
+
+  for (const auto& file : files) {
+    if (total <= configuration_.max_disk_bytes)
+      break;
+    if (fs::remove(std::get<2>(file), ec))
+      total -= std::get<1>(file);
+  }
+
+  disk_bytes_ = total;
+}
@@ -0,0 +1,116 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_RESPONSE_CACHE_H_
+#define AIRMAP_NET_HTTP_RESPONSE_CACHE_H_
+
+#include <airmap/do_not_copy_or_move.h>
+#include <airmap/net/http/response.h>
+#include <airmap/optional.h>
+#include <airmap/platform/path.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// ResponseCache holds responses keyed by the requests they answer.
+///
+/// Entries live in an in-memory LRU bounded by the size of their bodies and
+/// headers. If configured with a directory, entries are written through to
+/// disk and survive restarts: memory misses fall back to the disk tier.
+/// Writing and pruning the disk tier happens on a dedicated thread, callers
+/// never wait for it. Keys are only ever persisted as their SHA-256 digest,
+/// as they might carry credentials.
+/// All functions are safe to call from multiple threads.
+class ResponseCache : DoNotCopyOrMove {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  /// Entry is a cached response together with its freshness.
+  struct Entry {
+    Response response;          ///< The cached response.
+    Clock::time_point expires;  ///< The response is fresh until this point in time.
+    bool persisted{false};      ///< The entry has been loaded from the disk tier.
+  };
+
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::size_t max_bytes{16 * 1024 * 1024};       ///< Upper bound on the size of entries held in memory.
+    Optional<platform::Path> directory;            ///< Entries are persisted to this directory, if set.
+    std::size_t max_disk_bytes{64 * 1024 * 1024};  ///< Upper bound on the size of entries persisted to disk.
+  };
+
+  /// create returns a new ResponseCache instance, pruning the disk tier to its configured size.
+  static std::shared_ptr<ResponseCache> create(const Configuration& configuration);
+
+  /// ~ResponseCache finishes all pending writes to the disk tier.
+  ~ResponseCache();
+
+  /// lookup returns the entry stored for 'key', fresh or not.
+  Optional<Entry> lookup(const std::string& key);
+
+  /// store stores 'entry' for 'key', replacing any previous entry.
+  void store(const std::string& key, const Entry& entry);
+
+  /// size returns the number of bytes held in memory.
+  std::size_t size() const;
+
+ private:
+  using Lru = std::list<std::pair<std::string, Entry>>;
+
+  explicit ResponseCache(const Configuration& configuration);
+
+  // insert adds 'entry' to the in-memory tier, evicting the least recently used entries. Requires guard_ to be held.
+  void insert(const std::string& key, const Entry& entry);
+  // file_for returns the path of the file persisting the entry for the key with 'digest'.
+  platform::Path file_for(const std::string& digest) const;
+  // load reads the entry for 'key' from the disk tier.
+  Optional<Entry> load(const std::string& key) const;
+  // write persists the entries handed to store until the cache is destroyed. Runs on writer_.
+  void write();
+  // persist writes 'entry' for 'key' to the disk tier. Runs on writer_.
+  void persist(const std::string& key, const Entry& entry);
+  // prune removes the least recently written files until the disk tier fits its configured size. Runs on writer_.
+  void prune();
+
+  Configuration configuration_;
+
+  mutable std::mutex guard_;
+  Lru lru_;
+  std::unordered_map<std::string, Lru::iterator> index_;
+  std::size_t bytes_{0};
+
+  std::mutex writes_guard_;
+  std::condition_variable writes_cv_;
+  std::deque<std::pair<std::string, Entry>> writes_;
+  bool stopping_{false};
+  std::size_t disk_bytes_{0};
+  std::thread writer_;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_RESPONSE_CACHE_H_
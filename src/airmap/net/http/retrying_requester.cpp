@@ -0,0 +1,265 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/net/http/retrying_requester.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int too_many_requests{429};
+constexpr unsigned int bad_gateway{502};
+constexpr unsigned int service_unavailable{503};
+constexpr unsigned int gateway_timeout{504};
+
+// Upper bound on the number of latency samples considered for hedging.
+constexpr std::size_t max_latency_samples{128};
+
+// failed returns true if 'result' carries a transport error or a server-side failure.
+bool failed(const airmap::net::http::Requester::Result& result) {
+  return !result || result.value().status >= 500;
+}
+
+// retry_after returns the delay requested by the Retry-After header of 'response',
+// or zero if the header is missing or carries a date.
+std::chrono::seconds retry_after(const airmap::net::http::Response& response) {
+  auto it = response.headers.find("retry-after");
+  if (it == response.headers.end())
+    return std::chrono::seconds{0};
+
+  try {
+    return std::chrono::seconds{boost::lexical_cast<std::uint32_t>(it->second)};
+  } catch (const boost::bad_lexical_cast&) {
+    return std::chrono::seconds{0};
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<airmap::net::http::RetryingRequester> airmap::net::http::RetryingRequester::create(
+    const Configuration& configuration, const std::shared_ptr<Context>& context,
+    const std::shared_ptr<Requester>& next) {
+  return std::shared_ptr<RetryingRequester>{new RetryingRequester{configuration, context, next}};
+}
+
+airmap::net::http::RetryingRequester::RetryingRequester(const Configuration& configuration,
+                                                        const std::shared_ptr<Context>& context,
+                                                        const std::shared_ptr<Requester>& next)
+    : configuration_{configuration},
+      context_{context},
+      next_{next},
+      budget_{configuration.budget_capacity},
+      random_{std::random_device{}()} {
+}
+
+void airmap::net::http::RetryingRequester::delete_(const std::string& path,
+                                                   std::unordered_map<std::string, std::string>&& query,
+                                                   std::unordered_map<std::string, std::string>&& headers,
+                                                   Callback cb) {
+  auto exchange        = std::make_shared<Exchange>();
+  exchange->idempotent = true;
+  exchange->hedgeable  = false;
+  exchange->send = [next = next_, path, query = std::move(query), headers = std::move(headers)](const Callback& cb) {
+    next->delete_(path, std::unordered_map<std::string, std::string>{query},
+                  std::unordered_map<std::string, std::string>{headers}, cb);
+  };
+  exchange->cb = std::move(cb);
+  start(exchange);
+}
+
+void airmap::net::http::RetryingRequester::get(const std::string& path,
+                                               std::unordered_map<std::string, std::string>&& query,
+                                               std::unordered_map<std::string, std::string>&& headers, Callback cb) {
+  auto exchange        = std::make_shared<Exchange>();
+  exchange->idempotent = true;
+  exchange->hedgeable  = configuration_.hedge;
+  exchange->send = [next = next_, path, query = std::move(query), headers = std::move(headers)](const Callback& cb) {
+    next->get(path, std::unordered_map<std::string, std::string>{query},
+              std::unordered_map<std::string, std::string>{headers}, cb);
+  };
+  exchange->cb = std::move(cb);
+  start(exchange);
+}
+
+void airmap::net::http::RetryingRequester::patch(const std::string& path,
+                                                 std::unordered_map<std::string, std::string>&& headers,
+                                                 const std::string& body, Callback cb) {
+  auto exchange        = std::make_shared<Exchange>();
+  exchange->idempotent = false;
+  exchange->hedgeable  = false;
+  exchange->send       = [next = next_, path, headers = std::move(headers), body](const Callback& cb) {
+    next->patch(path, std::unordered_map<std::string, std::string>{headers}, body, cb);
+  };
+  exchange->cb = std::move(cb);
+  start(exchange);
+}
+
+void airmap::net::http::RetryingRequester::post(const std::string& path,
+                                                std::unordered_map<std::string, std::string>&& headers,
+                                                const std::string& body, Callback cb) {
+  auto exchange        = std::make_shared<Exchange>();
+  exchange->idempotent = false;
+  exchange->hedgeable  = false;
+  exchange->send       = [next = next_, path, headers = std::move(headers), body](const Callback& cb) {
+    next->post(path, std::unordered_map<std::string, std::string>{headers}, body, cb);
+  };
+  exchange->cb = std::move(cb);
+  start(exchange);
+}
+
+void airmap::net::http::RetryingRequester::start(const std::shared_ptr<Exchange>& exchange) {
+  Clock::duration delay{Clock::duration::zero()};
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    budget_ = std::min(configuration_.budget_capacity, budget_ + configuration_.budget_ratio);
+  }
+
+  if (exchange->hedgeable)
+    delay = hedge_delay();
+
+  attempt(exchange);
+
+  if (delay > Clock::duration::zero()) {
+    context_->schedule_in(
+        [sp = shared_from_this(), exchange]() { sp->handle_hedge_timeout(exchange); },
+        microseconds(std::chrono::duration_cast<std::chrono::microseconds>(delay).count()));
+  }
+}
+
+void airmap::net::http::RetryingRequester::attempt(const std::shared_ptr<Exchange>& exchange) {
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    exchange->attempts++;
+    exchange->outstanding++;
+  }
+
+  exchange->send([sp = shared_from_this(), exchange, started = Clock::now()](const Result& result) {
+    sp->handle_result(exchange, started, result);
+  });
+}
+
+void airmap::net::http::RetryingRequester::handle_result(const std::shared_ptr<Exchange>& exchange,
+                                                         Clock::time_point started, const Result& result) {
+  auto retry = retryable(*exchange, result);
+
+  std::unique_lock<std::mutex> ul{guard_};
+  exchange->outstanding--;
+
+  if (exchange->done)
+    return;
+
+  if (result) {
+    latencies_.push_back(Clock::now() - started);
+    if (latencies_.size() > max_latency_samples)
+      latencies_.pop_front();
+  }
+
+  // Another attempt is still in flight and might well succeed, it reports the outcome of the exchange.
+  if ((retry || failed(result)) && exchange->outstanding > 0)
+    return;
+
+  if (retry && exchange->attempts < configuration_.max_attempts) {
+    ul.unlock();
+
+    if (withdraw()) {
+      context_->schedule_in([sp = shared_from_this(), exchange]() { sp->attempt(exchange); },
+                            backoff_for(*exchange, result));
+      return;
+    }
+
+    ul.lock();
+  }
+
+  exchange->done = true;
+  ul.unlock();
+
+  exchange->cb(result);
+}
+
+void airmap::net::http::RetryingRequester::handle_hedge_timeout(const std::shared_ptr<Exchange>& exchange) {
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    if (exchange->done || exchange->attempts > 1)
+      return;
+  }
+
+  if (withdraw())
+    attempt(exchange);
+}
+
+bool airmap::net::http::RetryingRequester::retryable(const Exchange& exchange, const Result& result) const {
+  if (!result)
+    return exchange.idempotent || !request_sent(result.error());
+
+  if (!exchange.idempotent)
+    return false;
+
+  switch (result.value().status) {
+    case too_many_requests:
+    case bad_gateway:
+    case service_unavailable:
+    case gateway_timeout:
+      return true;
+    default:
+      break;
+  }
+
+  return false;
+}
+
+bool airmap::net::http::RetryingRequester::withdraw() {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  if (budget_ < 1.)
+    return false;
+
+  budget_ -= 1.;
+  return true;
+}
+
+airmap::Microseconds airmap::net::http::RetryingRequester::backoff_for(const Exchange& exchange,
+                                                                       const Result& result) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  // attempts counts the first attempt, too, which is why the backoff starts at initial_backoff.
+  auto limit   = configuration_.max_backoff.total_microseconds();
+  auto ceiling = configuration_.initial_backoff.total_microseconds();
+  for (std::uint32_t i = 1; i < exchange.attempts && ceiling < limit; i++)
+    ceiling *= 2;
+
+  std::uniform_int_distribution<std::uint64_t> jitter{0, std::min(ceiling, limit)};
+  auto delay = jitter(random_);
+
+  if (result) {
+    auto requested = std::chrono::duration_cast<std::chrono::microseconds>(retry_after(result.value())).count();
+    delay          = std::max<std::uint64_t>(delay, std::min<std::uint64_t>(requested, limit));
+  }
+
+  return microseconds(delay);
+}
+
+airmap::net::http::RetryingRequester::Clock::duration airmap::net::http::RetryingRequester::hedge_delay() {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  if (latencies_.size() < std::max<std::size_t>(configuration_.hedge_min_samples, 1))
+    return Clock::duration::zero();
+
+  std::vector<Clock::duration> sorted{latencies_.begin(), latencies_.end()};
+  auto index = std::min(sorted.size() - 1, static_cast<std::size_t>(configuration_.hedge_quantile * sorted.size()));
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+  return sorted[index];
+}
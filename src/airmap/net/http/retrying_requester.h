@@ -0,0 +1,129 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_HTTP_RETRYING_REQUESTER_H_
+#define AIRMAP_NET_HTTP_RETRYING_REQUESTER_H_
+
+#include <airmap/context.h>
+#include <airmap/date_time.h>
+#include <airmap/net/http/requester.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+
+namespace airmap {
+namespace net {
+namespace http {
+
+/// RetryingRequester retries failed requests with exponential backoff and,
+/// optionally, hedges get requests that take unusually long.
+///
+/// Requests are retried if they failed in transport or the server answered
+/// with 429, 502, 503 or 504. get and delete requests are idempotent and retried
+/// in all these cases. patch and post requests are only retried if they failed
+/// before being handed to the server (see request_sent).
+///
+/// Delays between attempts are drawn uniformly from [0, backoff], with backoff
+/// doubling for every attempt ("full jitter"). A Retry-After header sent by the
+/// server raises the delay accordingly.
+///
+/// Retries and hedges draw from a budget that every request tops up by a fraction,
+/// such that an outage does not multiply the load on the servers.
+///
+/// If hedging is enabled, a second get request fires once the first one took longer
+/// than the configured quantile of recently observed latencies. The first successful
+/// response to arrive wins, failures are only reported once no other attempt is in flight.
+class RetryingRequester : public Requester, public std::enable_shared_from_this<RetryingRequester> {
+ public:
+  /// Configuration bundles up construction time parameters.
+  struct Configuration {
+    std::uint32_t max_attempts{3};                    ///< Attempts per request, including the first one.
+    Microseconds initial_backoff{milliseconds(200)};  ///< Upper bound on the delay before the first retry.
+    Microseconds max_backoff{seconds(10)};            ///< Upper bound on the delay before any retry.
+    double budget_ratio{0.2};                         ///< Retries earned by every request.
+    double budget_capacity{10.};                      ///< Upper bound on retries saved up.
+    bool hedge{false};                                ///< Hedge get requests if true.
+    double hedge_quantile{0.95};                      ///< Latency quantile after which a hedge fires.
+    std::size_t hedge_min_samples{20};                ///< Number of latency samples required before hedging.
+  };
+
+  /// create returns a new RetryingRequester instance, scheduling timers on 'context'
+  /// and handing off requests to 'next'.
+  static std::shared_ptr<RetryingRequester> create(const Configuration& configuration,
+                                                   const std::shared_ptr<Context>& context,
+                                                   const std::shared_ptr<Requester>& next);
+
+  void delete_(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+               std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void get(const std::string& path, std::unordered_map<std::string, std::string>&& query,
+           std::unordered_map<std::string, std::string>&& headers, Callback cb) override;
+  void patch(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+             Callback cb) override;
+  void post(const std::string& path, std::unordered_map<std::string, std::string>&& headers, const std::string& body,
+            Callback cb) override;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Exchange tracks all attempts made on behalf of a single request.
+  struct Exchange {
+    bool idempotent;
+    bool hedgeable;
+    std::function<void(const Callback&)> send;
+    Callback cb;
+    std::uint32_t attempts{0};
+    std::uint32_t outstanding{0};
+    bool done{false};
+  };
+
+  explicit RetryingRequester(const Configuration& configuration, const std::shared_ptr<Context>& context,
+                             const std::shared_ptr<Requester>& next);
+
+  // start deposits into the budget and runs the first attempt of 'exchange'.
+  void start(const std::shared_ptr<Exchange>& exchange);
+  // attempt hands off 'exchange' to next_, once more.
+  void attempt(const std::shared_ptr<Exchange>& exchange);
+  // handle_result processes 'result' of an attempt of 'exchange' issued at 'started'.
+  void handle_result(const std::shared_ptr<Exchange>& exchange, Clock::time_point started, const Result& result);
+  // handle_hedge_timeout fires another attempt if 'exchange' is still waiting for its first attempt.
+  void handle_hedge_timeout(const std::shared_ptr<Exchange>& exchange);
+
+  // retryable returns true if 'result' warrants another attempt of 'exchange'.
+  bool retryable(const Exchange& exchange, const Result& result) const;
+  // withdraw takes a single retry from the budget, returning false if the budget is exhausted.
+  bool withdraw();
+  // backoff_for returns the delay before the next attempt of 'exchange', following 'result'.
+  Microseconds backoff_for(const Exchange& exchange, const Result& result);
+  // hedge_delay returns the delay before hedging, or zero if not enough latencies were observed yet.
+  Clock::duration hedge_delay();
+
+  Configuration configuration_;
+  std::shared_ptr<Context> context_;
+  std::shared_ptr<Requester> next_;
+
+  std::mutex guard_;
+  double budget_;
+  std::mt19937 random_;
+  std::deque<Clock::duration> latencies_;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_HTTP_RETRYING_REQUESTER_H_
@@ -25,11 +25,26 @@ namespace uuids = boost::uuids;
 
 airmap::net::mqtt::boost::Broker::Broker(const std::string& host, std::uint16_t port,
                                          const std::shared_ptr<Logger>& logger,
-                                         const std::shared_ptr<::boost::asio::io_service>& io_service)
-    : logger_{logger}, io_service_{io_service}, host_{host}, port_{port} {
+                                         const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                         const std::shared_ptr<dns::ResolverCache>& resolver_cache)
+    : logger_{logger}, io_service_{io_service}, resolver_cache_{resolver_cache}, host_{host}, port_{port} {
 }
 
 void airmap::net::mqtt::boost::Broker::connect(const Credentials& credentials, const ConnectCallback& cb) {
+  resolver_cache_->resolve(host_, [sp = shared_from_this(), credentials, cb](const dns::ResolverCache::Result& result) {
+    if (!result) {
+      cb(ConnectResult{result.error()});
+    } else {
+      sp->connect_resolved(credentials, cb);
+    }
+  });
+}
+
+void airmap::net::mqtt::boost::Broker::connect_resolved(const Credentials& credentials, const ConnectCallback& cb) {
+  // The client has to know about host_ rather than a resolved address: the TLS
+  // handshake announces it via SNI and verifies the broker's certificate against it.
+  // The client does not accept a separate address to connect to, with that we only
+  // rely on the cache to fail fast and drop its entry if connecting fails.
   auto client = ::mqtt::make_tls_client(*io_service_, host_, std::to_string(port_));
   client->set_clean_session(true);
   client->set_default_verify_paths();
@@ -50,8 +65,9 @@ void airmap::net::mqtt::boost::Broker::connect(const Credentials& credentials, c
         return ::mqtt::connect_return_code::accepted == rc;
       });
 
-  client->connect([cb](const auto& ec) {
+  client->connect([resolver_cache = resolver_cache_, host = host_, cb](const auto& ec) {
     if (ec) {
+      resolver_cache->invalidate(host);
       cb(ConnectResult{Error{ec.message()}});
     }
   });
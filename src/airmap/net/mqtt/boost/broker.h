@@ -16,6 +16,7 @@
 #include <airmap/net/mqtt/broker.h>
 
 #include <airmap/logger.h>
+#include <airmap/net/dns/resolver_cache.h>
 
 #include <boost/asio.hpp>
 
@@ -26,15 +27,20 @@ namespace net {
 namespace mqtt {
 namespace boost {
 
-class Broker : public mqtt::Broker {
+class Broker : public mqtt::Broker, public std::enable_shared_from_this<Broker> {
  public:
   explicit Broker(const std::string& host, std::uint16_t port, const std::shared_ptr<Logger>& logger,
-                  const std::shared_ptr<::boost::asio::io_service>& io_service);
+                  const std::shared_ptr<::boost::asio::io_service>& io_service,
+                  const std::shared_ptr<dns::ResolverCache>& resolver_cache);
   void connect(const Credentials& credentials, const ConnectCallback& cb);
 
  private:
+  // connect_resolved establishes a session with the broker once host_ is known to resolve.
+  void connect_resolved(const Credentials& credentials, const ConnectCallback& cb);
+
   std::shared_ptr<Logger> logger_;
   std::shared_ptr<::boost::asio::io_service> io_service_;
+  std::shared_ptr<dns::ResolverCache> resolver_cache_;
   std::string host_;
   std::uint16_t port_;
 };
@@ -14,6 +14,8 @@
 
 #include <mqtt/str_connect_return_code.hpp>
 
+#include <stdexcept>
+
 namespace asio = boost::asio;
 
 namespace {
@@ -35,6 +37,11 @@ std::shared_ptr<airmap::net::mqtt::boost::Client> airmap::net::mqtt::boost::Clie
   return std::shared_ptr<Client>(new Client{logger, io_service, mqtt_client})->finalize();
 }
 
+airmap::net::mqtt::boost::Client::~Client() {
+  // The last reference might go away on any thread, while mqtt_client_ must only be touched on the io_service.
+  io_service_->post([mqtt_client = mqtt_client_]() { mqtt_client->disconnect(); });
+}
+
 airmap::net::mqtt::boost::Client::Client(const std::shared_ptr<Logger>& logger,
                                          const std::shared_ptr<asio::io_service>& io_service,
                                          const std::shared_ptr<TlsClient>& mqtt_client)
@@ -101,6 +108,9 @@ std::shared_ptr<airmap::net::mqtt::boost::Client> airmap::net::mqtt::boost::Clie
 
 std::unique_ptr<airmap::net::mqtt::Client::Subscription> airmap::net::mqtt::boost::Client::subscribe(
     const std::string& topic, QualityOfService qos, PublishCallback cb) {
+  if (!TopicMap::is_valid_filter(topic))
+    throw std::invalid_argument{"invalid mqtt topic filter: " + topic};
+
   auto translated = ::mqtt::qos::exactly_once;
 
   switch (qos) {
@@ -115,9 +125,18 @@ std::unique_ptr<airmap::net::mqtt::Client::Subscription> airmap::net::mqtt::boos
       break;
   }
 
-  auto id  = mqtt_client_->async_subscribe(topic, translated);
-  auto itt = topic_map_.emplace(topic, cb);
-  subscription_map_.emplace(id, itt);
+  SubscriptionId id;
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+
+    if (topic_map_.count(topic) == 0)
+      mqtt_client_->async_subscribe(topic, translated);
+
+    id = next_subscription_id_++;
+    topic_map_.insert(topic, id, cb);
+    subscription_map_.emplace(id, topic);
+  }
 
   std::weak_ptr<Client> wp{shared_from_this()};
   std::unique_ptr<airmap::net::mqtt::Client::Subscription> result{new Subscription{[wp, id]() {
@@ -131,18 +150,29 @@ std::unique_ptr<airmap::net::mqtt::Client::Subscription> airmap::net::mqtt::boos
 void airmap::net::mqtt::boost::Client::handle_publish(std::uint8_t, ::boost::optional<std::uint16_t>, std::string topic,
                                                       std::string contents) {
   log_.debugf(component, "received publish from mqtt broker for topic %s: size of contents %d", topic, contents.size());
-  auto range = topic_map_.equal_range(topic);
-  for (auto it = range.first; it != range.second; ++it) {
-    it->second(topic, contents);
+
+  // Handlers are invoked without holding the lock, as they might (un-)subscribe.
+  std::vector<PublishCallback> handlers;
+
+  {
+    std::lock_guard<std::mutex> lg{guard_};
+    topic_map_.match(topic, [&handlers](const PublishCallback& handler) { handlers.push_back(handler); });
   }
+
+  for (const auto& handler : handlers)
+    handler(topic, contents);
 }
 
 void airmap::net::mqtt::boost::Client::unsubscribe(SubscriptionId subscription_id) {
+  std::lock_guard<std::mutex> lg{guard_};
   auto it = subscription_map_.find(subscription_id);
 
   if (it != subscription_map_.end()) {
-    mqtt_client_->async_unsubscribe(it->second->first);
-    topic_map_.erase(it->second);
+    auto topic = it->second;
+    topic_map_.erase(topic, subscription_id);
     subscription_map_.erase(it);
+
+    if (topic_map_.count(topic) == 0)
+      mqtt_client_->async_unsubscribe(topic);
   }
 }
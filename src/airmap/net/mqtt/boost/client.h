@@ -14,6 +14,7 @@
 #define AIRMAP_NET_MQTT_BOOST_CLIENT_H_
 
 #include <airmap/net/mqtt/client.h>
+#include <airmap/net/mqtt/topic_trie.h>
 
 #include <airmap/logger.h>
 #include <airmap/util/formatting_logger.h>
@@ -24,8 +25,10 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace airmap {
 namespace net {
@@ -51,16 +54,23 @@ class Client : public mqtt::Client, public std::enable_shared_from_this<Client>
                                         const std::shared_ptr<::boost::asio::io_service>& io_service,
                                         const std::shared_ptr<TlsClient>& mqtt_client);
 
+  /// ~Client disconnects from the broker, on the thread running 'io_service'.
+  ~Client();
+
   // From airmap::net::mqtt::Client
+  //
+  // Subscriptions to the same topic share a single subscription with the broker,
+  // which is only cancelled once the last of them is gone. Subscriptions might be
+  // placed and cancelled from any thread. 'topic' might contain the wildcards '+'
+  // and '#', throws std::invalid_argument if it is not a valid topic filter.
   std::unique_ptr<mqtt::Client::Subscription> subscribe(const std::string& topic, QualityOfService qos,
                                                         PublishCallback cb) override;
 
  private:
-  using Topic            = std::string;
-  using TopicMap         = std::unordered_multimap<Topic, PublishCallback>;
-  using TopicMapIterator = typename TopicMap::iterator;
-  using SubscriptionId   = std::uint8_t;
-  using SubscriptionMap  = std::unordered_map<SubscriptionId, TopicMapIterator>;
+  using Topic           = std::string;
+  using TopicMap        = TopicTrie<PublishCallback>;
+  using SubscriptionId  = TopicMap::Id;
+  using SubscriptionMap = std::unordered_map<SubscriptionId, Topic>;
 
   /// Initializes the Client instance with mqtt_client
   explicit Client(const std::shared_ptr<Logger>& logger, const std::shared_ptr<::boost::asio::io_service>& io_service,
@@ -73,6 +83,8 @@ class Client : public mqtt::Client, public std::enable_shared_from_this<Client>
   util::FormattingLogger log_;
   std::shared_ptr<::boost::asio::io_service> io_service_;
   std::shared_ptr<TlsClient> mqtt_client_;
+  std::mutex guard_;
+  SubscriptionId next_subscription_id_{0};
   SubscriptionMap subscription_map_;
   TopicMap topic_map_;
 };
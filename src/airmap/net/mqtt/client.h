@@ -44,7 +44,8 @@ class Client : DoNotCopyOrMove {
   };
 
   /// subscribe subscribes the caller to 'topic', with 'qos', invoking cb
-  /// for incoming publishs of 'topic'.
+  /// for incoming publishs of 'topic'. 'topic' might be a filter containing
+  /// the wildcards '+' and '#', in which case cb is invoked for all matching topics.
   virtual std::unique_ptr<Subscription> subscribe(const std::string& topic, QualityOfService qos,
                                                   PublishCallback cb) = 0;
 
@@ -0,0 +1,190 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_NET_MQTT_TOPIC_TRIE_H_
+#define AIRMAP_NET_MQTT_TOPIC_TRIE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace airmap {
+namespace net {
+namespace mqtt {
+
+/// TopicTrie maps mqtt topic filters to values, matching topics against all filters in a single walk.
+///
+/// Filters follow the mqtt rules: levels are separated by '/', '+' matches exactly
+/// one level and '#' as the last level matches any number of levels, including
+/// the parent level. Wildcards in the first level do not match topics starting
+/// with '$'. Matching a topic visits at most three children per level, such that
+/// its cost depends on the depth of the topic, not on the number of filters.
+///
+/// Multiple values might be inserted for the same filter, distinguished by an Id.
+/// TopicTrie is not thread-safe.
+template <typename Value>
+class TopicTrie {
+ public:
+  using Id = std::uint64_t;
+
+  /// is_valid_filter returns true if 'filter' is a valid mqtt topic filter.
+  static bool is_valid_filter(std::string_view filter) {
+    if (filter.empty())
+      return false;
+
+    for (std::size_t begin = 0;;) {
+      auto end   = filter.find('/', begin);
+      auto level = filter.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+
+      if (level.find_first_of("+#") != std::string_view::npos && level != "+" && level != "#")
+        return false;
+      if (level == "#" && end != std::string_view::npos)
+        return false;
+      if (end == std::string_view::npos)
+        return true;
+
+      begin = end + 1;
+    }
+  }
+
+  /// insert registers 'value' with 'filter' under 'id'.
+  void insert(std::string_view filter, Id id, Value value) {
+    auto node = &root_;
+
+    for_each_level(filter, [&node](std::string_view level) {
+      auto it = node->children.find(level);
+      if (it == node->children.end())
+        it = node->children.emplace(std::string{level}, std::make_unique<Node>()).first;
+      node = it->second.get();
+    });
+
+    node->values.emplace(id, std::move(value));
+  }
+
+  /// erase removes the value registered with 'filter' under 'id', pruning
+  /// nodes that are no longer needed. Returns false if no such value exists.
+  bool erase(std::string_view filter, Id id) {
+    return erase(root_, filter, 0, id);
+  }
+
+  /// count returns the number of values registered with exactly 'filter'.
+  std::size_t count(std::string_view filter) const {
+    auto node = &root_;
+
+    for_each_level(filter, [&node](std::string_view level) {
+      if (!node)
+        return;
+      auto it = node->children.find(level);
+      node    = it == node->children.end() ? nullptr : it->second.get();
+    });
+
+    return node ? node->values.size() : 0;
+  }
+
+  /// empty returns true if no values are registered.
+  bool empty() const {
+    return root_.children.empty() && root_.values.empty();
+  }
+
+  /// match invokes 'f' with every value registered with a filter matching 'topic'.
+  void match(std::string_view topic, const std::function<void(const Value&)>& f) const {
+    match(root_, topic, 0, !topic.empty() && topic.front() == '$', f);
+  }
+
+ private:
+  struct Node {
+    // std::less<> enables looking up levels without materializing them as std::string.
+    std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+    std::unordered_map<Id, Value> values;
+  };
+
+  template <typename F>
+  static void for_each_level(std::string_view topic, F&& f) {
+    for (std::size_t begin = 0;;) {
+      auto end = topic.find('/', begin);
+      if (end == std::string_view::npos) {
+        f(topic.substr(begin));
+        return;
+      }
+      f(topic.substr(begin, end - begin));
+      begin = end + 1;
+    }
+  }
+
+  static void emit(const Node& node, const std::function<void(const Value&)>& f) {
+    for (const auto& pair : node.values)
+      f(pair.second);
+  }
+
+  // match visits all nodes matching the level of 'topic' starting at 'begin'. 'begin' equals
+  // npos if all levels of 'topic' have been consumed.
+  static void match(const Node& node, std::string_view topic, std::size_t begin, bool shielded,
+                    const std::function<void(const Value&)>& f) {
+    if (!shielded) {
+      auto it = node.children.find("#");
+      if (it != node.children.end())
+        emit(*it->second, f);
+    }
+
+    if (begin == std::string_view::npos) {
+      emit(node, f);
+      return;
+    }
+
+    auto end   = topic.find('/', begin);
+    auto level = topic.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+    auto next  = end == std::string_view::npos ? std::string_view::npos : end + 1;
+
+    auto it = node.children.find(level);
+    if (it != node.children.end())
+      match(*it->second, topic, next, false, f);
+
+    if (!shielded && level != "+") {
+      it = node.children.find("+");
+      if (it != node.children.end())
+        match(*it->second, topic, next, false, f);
+    }
+  }
+
+  static bool erase(Node& node, std::string_view filter, std::size_t begin, Id id) {
+    if (begin == std::string_view::npos)
+      return node.values.erase(id) > 0;
+
+    auto end   = filter.find('/', begin);
+    auto level = filter.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+    auto next  = end == std::string_view::npos ? std::string_view::npos : end + 1;
+
+    auto it = node.children.find(level);
+    if (it == node.children.end())
+      return false;
+
+    auto result = erase(*it->second, filter, next, id);
+    if (it->second->children.empty() && it->second->values.empty())
+      node.children.erase(it);
+
+    return result;
+  }
+
+  Node root_;
+};
+
+}  // namespace mqtt
+}  // namespace net
+}  // namespace airmap
+
+#endif  // AIRMAP_NET_MQTT_TOPIC_TRIE_H_
@@ -14,60 +14,261 @@
 
 #include <airmap/util/fmt.h>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+
 namespace fmt = airmap::util::fmt;
 
-std::shared_ptr<airmap::net::udp::boost::Sender::Session> airmap::net::udp::boost::Sender::Session::create(
-    const std::shared_ptr<::boost::asio::io_service>& io_service, const ::boost::asio::ip::udp::endpoint& endpoint,
-    const std::string& message, const Callback& cb) {
-  return std::shared_ptr<Session>{new Session{io_service, endpoint, message, cb}};
-}
+namespace {
 
-airmap::net::udp::boost::Sender::Session::Session(const std::shared_ptr<::boost::asio::io_service>& io_service,
-                                                  const ::boost::asio::ip::udp::endpoint& endpoint,
-                                                  const std::string& message, const Callback& cb)
-    : io_service_{io_service},
-      endpoint_{endpoint},
-      socket_{*io_service_, ::boost::asio::ip::udp::endpoint{::boost::asio::ip::udp::v4(), 0}},
-      message_{message},
-      cb_{cb} {
-}
+// max_datagrams_per_syscall limits the number of datagrams handed to a single
+// invocation of sendmmsg, bounding the scratch space we keep on the stack.
+constexpr std::size_t max_datagrams_per_syscall{32};
 
-void airmap::net::udp::boost::Sender::Session::start() {
-  socket_.async_send_to(
-      ::boost::asio::buffer(message_), endpoint_,
-      std::bind(&Session::handle_write, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+airmap::net::udp::Sender::Result make_error_result(const std::string& message) {
+  return airmap::net::udp::Sender::Result{std::make_exception_ptr(std::runtime_error{message})};
 }
 
-void airmap::net::udp::boost::Sender::Session::handle_write(const ::boost::system::error_code& ec,
-                                                            std::size_t transferred) {
+airmap::net::udp::Sender::Result make_result(const ::boost::system::error_code& ec, std::size_t transferred,
+                                             std::size_t size) {
   if (ec) {
-    cb_(Result{
-        std::make_exception_ptr(std::runtime_error{fmt::sprintf("failed to send udp packet: %s", ec.message())})});
-  } else if (transferred != message_.size()) {
-    cb_(Result{std::make_exception_ptr(std::runtime_error{"failed to send udp packet"})});
-  } else {
-    cb_(Result{Empty{}});
+    return make_error_result(fmt::sprintf("failed to send udp packet: %s", ec.message()));
+  } else if (transferred != size) {
+    return make_error_result("failed to send udp packet");
   }
+
+  return airmap::net::udp::Sender::Result{airmap::net::udp::Sender::Empty{}};
+}
+
+}  // namespace
+
+std::shared_ptr<airmap::net::udp::boost::Sender> airmap::net::udp::boost::Sender::create(
+    const std::string& host, std::uint16_t port, const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<dns::ResolverCache>& resolver_cache) {
+  return create(host, port, io_service, resolver_cache, Configuration{});
 }
 
 std::shared_ptr<airmap::net::udp::boost::Sender> airmap::net::udp::boost::Sender::create(
-    const std::string& host, std::uint16_t port, const std::shared_ptr<::boost::asio::io_service>& io_service) {
-  return std::shared_ptr<Sender>{new Sender{host, port, io_service}};
+    const std::string& host, std::uint16_t port, const std::shared_ptr<::boost::asio::io_service>& io_service,
+    const std::shared_ptr<dns::ResolverCache>& resolver_cache, const Configuration& configuration) {
+  return std::shared_ptr<Sender>{new Sender{host, port, io_service, resolver_cache, configuration}};
 }
 
 airmap::net::udp::boost::Sender::Sender(const std::string& host, std::uint16_t port,
-                                        const std::shared_ptr<::boost::asio::io_service>& io_service)
-    : host_{host}, port_{port}, io_service_{io_service}, resolver_{*io_service_} {
+                                        const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                        const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                                        const Configuration& configuration)
+    : host_{host},
+      port_{port},
+      io_service_{io_service},
+      resolver_cache_{resolver_cache},
+      configuration_{configuration},
+      socket_{*io_service_} {
+  configuration_.batch_size  = std::max<std::size_t>(configuration_.batch_size, 1);
+  configuration_.max_pending = std::max(configuration_.max_pending, configuration_.batch_size);
 }
 
 void airmap::net::udp::boost::Sender::send(const std::string& message, const Callback& cb) {
-  auto query = ::boost::asio::ip::udp::resolver::query{host_, std::to_string(port_),
-                                                       ::boost::asio::ip::udp::resolver::query::passive};
-  resolver_.async_resolve(query, [this, sp = shared_from_this(), message, cb](const auto& ec, auto iterator) {
-    if (ec) {
-      cb(Result{std::make_exception_ptr(std::runtime_error{fmt::sprintf("failed to resolve host: %s", ec.message())})});
+  std::unique_lock<std::mutex> ul{guard_};
+
+  if (state_ == State::connected && !refreshing_ &&
+      std::chrono::steady_clock::now() - resolved_at_ > configuration_.resolve_ttl) {
+    // We keep on sending to the current endpoint while refreshing it.
+    refreshing_ = true;
+    resolve();
+  }
+
+  if (state_ != State::connected || configuration_.batch_size > 1) {
+    const auto needs_flush = state_ == State::connected && pending_size_ == 0;
+    const auto enqueued    = enqueue(message, cb);
+
+    if (state_ == State::unresolved) {
+      state_ = State::resolving;
+      resolve();
+    }
+
+    ul.unlock();
+
+    if (!enqueued) {
+      cb(make_error_result("failed to send udp packet: too many pending packets"));
+    } else if (needs_flush) {
+      io_service_->post([sp = shared_from_this()]() { sp->flush(); });
+    }
+    return;
+  }
+
+  // Sending on a connected, non-blocking datagram socket hands the message
+  // over to the kernel right away. With that, we neither copy 'message' nor
+  // do we have to keep it alive after returning.
+  ::boost::system::error_code ec;
+  auto transferred = socket_.send(::boost::asio::buffer(message), 0, ec);
+
+  if (ec && ec != ::boost::asio::error::would_block) {
+    // Make sure that we resolve the endpoint again on the next send,
+    // bypassing the address cached for host_.
+    state_ = State::unresolved;
+    resolver_cache_->invalidate(host_);
+  }
+
+  ul.unlock();
+
+  cb(make_result(ec, transferred, message.size()));
+}
+
+void airmap::net::udp::boost::Sender::resolve() {
+  // The resolver cache never invokes us synchronously, with that it is safe to call with guard_ held.
+  resolver_cache_->resolve(
+      host_, [sp = shared_from_this()](const dns::ResolverCache::Result& result) { sp->handle_resolve(result); });
+}
+
+void airmap::net::udp::boost::Sender::handle_resolve(const dns::ResolverCache::Result& result) {
+  std::unique_lock<std::mutex> ul{guard_};
+
+  refreshing_ = false;
+
+  if (!result) {
+    if (state_ == State::connected) {
+      // We failed to refresh the endpoint but keep on using the one
+      // we know about and retry after resolve_ttl.
+      resolved_at_ = std::chrono::steady_clock::now();
+      return;
+    }
+    state_ = State::unresolved;
+  } else {
+    const ::boost::asio::ip::udp::endpoint endpoint{result.value().front(), port_};
+    ::boost::system::error_code error;
+
+    if (socket_.is_open() && socket_.local_endpoint(error).protocol() != endpoint.protocol())
+      socket_.close(error);
+
+    if (!socket_.is_open()) {
+      socket_.open(endpoint.protocol(), error);
+      if (!error)
+        socket_.non_blocking(true, error);
+    }
+
+    if (!error)
+      socket_.connect(endpoint, error);
+
+    if (error) {
+      state_ = State::unresolved;
+      resolver_cache_->invalidate(host_);
+    } else {
+      state_       = State::connected;
+      resolved_at_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  const auto needs_flush = pending_size_ > 0;
+  ul.unlock();
+
+  // Pending datagrams are either sent out now or failed if we
+  // could not connect to the remote endpoint.
+  if (needs_flush)
+    flush();
+}
+
+bool airmap::net::udp::boost::Sender::enqueue(const std::string& message, const Callback& cb) {
+  if (pending_size_ == configuration_.max_pending)
+    return false;
+
+  // We reuse the slots of previously sent datagrams, including
+  // the capacity of their message buffers.
+  if (pending_size_ == pending_.size())
+    pending_.emplace_back();
+
+  pending_[pending_size_].message.assign(message);
+  pending_[pending_size_].cb = cb;
+  ++pending_size_;
+
+  return true;
+}
+
+void airmap::net::udp::boost::Sender::flush() {
+  std::lock_guard<std::mutex> fl{flush_guard_};
+
+  std::size_t size{0};
+  bool connected{false};
+
+  {
+    // handle_resolve closes and reopens socket_, and we only touch it with guard_ held.
+    // Sending on the non-blocking socket never blocks, callbacks are invoked after
+    // releasing guard_ as they might send again.
+    std::lock_guard<std::mutex> lg{guard_};
+    std::swap(pending_, flushing_);
+    std::swap(pending_size_, size);
+    connected = state_ == State::connected;
+
+    if (connected && send_pending(size)) {
+      state_ = State::unresolved;
+      resolver_cache_->invalidate(host_);
+    }
+  }
+
+  for (std::size_t i = 0; i < size; i++) {
+    auto& datagram = flushing_[i];
+
+    if (!connected) {
+      datagram.cb(make_error_result(fmt::sprintf("failed to resolve host: %s", host_)));
     } else {
-      Session::create(io_service_, *iterator, message, cb)->start();
+      datagram.cb(make_result(datagram.ec, datagram.transferred, datagram.message.size()));
+    }
+
+    // We are done with the callback and release all resources it holds on to.
+    datagram.cb = nullptr;
+  }
+}
+
+bool airmap::net::udp::boost::Sender::send_pending(std::size_t size) {
+  bool failed{false};
+
+  for (std::size_t offset = 0; offset < size;) {
+    const auto count = std::min({size - offset, configuration_.batch_size, max_datagrams_per_syscall});
+
+#if defined(__linux__)
+    std::array<::iovec, max_datagrams_per_syscall> iovecs;
+    std::array<::mmsghdr, max_datagrams_per_syscall> headers;
+
+    for (std::size_t i = 0; i < count; i++) {
+      auto& datagram                = flushing_[offset + i];
+      iovecs[i].iov_base            = &datagram.message[0];
+      iovecs[i].iov_len             = datagram.message.size();
+      headers[i]                    = ::mmsghdr{};
+      headers[i].msg_hdr.msg_iov    = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
     }
-  });
+
+    const auto sent = ::sendmmsg(socket_.native_handle(), headers.data(), count, 0);
+    const ::boost::system::error_code ec{sent < 0 ? errno : 0, ::boost::system::system_category()};
+
+    for (std::size_t i = 0; i < count; i++) {
+      auto& datagram = flushing_[offset + i];
+      if (ec || static_cast<int>(i) >= sent) {
+        datagram.ec          = ec ? ec : ::boost::asio::error::would_block;
+        datagram.transferred = 0;
+      } else {
+        datagram.ec          = ec;
+        datagram.transferred = headers[i].msg_len;
+      }
+    }
+
+    failed = failed || (ec && ec != ::boost::asio::error::would_block);
+#else
+    for (std::size_t i = 0; i < count; i++) {
+      auto& datagram       = flushing_[offset + i];
+      datagram.transferred = socket_.send(::boost::asio::buffer(datagram.message), 0, datagram.ec);
+      failed               = failed || (datagram.ec && datagram.ec != ::boost::asio::error::would_block);
+    }
+#endif  // __linux__
+
+    offset += count;
+  }
+
+  return failed;
 }
@@ -15,55 +15,92 @@
 
 #include <airmap/net/udp/sender.h>
 
+#include <airmap/net/dns/resolver_cache.h>
+
 #include <boost/asio.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace airmap {
 namespace net {
 namespace udp {
 namespace boost {
 
+/// Sender sends datagrams to a single remote endpoint over one long-lived, connected socket.
+///
+/// The remote endpoint is resolved once and refreshed after Configuration::resolve_ttl has
+/// elapsed or whenever sending to it fails. While connected, messages are handed to the kernel
+/// directly from the caller-owned buffer, i.e., callers are free to reuse the buffer as soon as
+/// send returns.
 class Sender : public udp::Sender, public std::enable_shared_from_this<Sender> {
  public:
+  /// Configuration bundles up tuning parameters of a Sender instance.
+  struct Configuration {
+    std::chrono::seconds resolve_ttl{30};  ///< Endpoints are looked up in the resolver cache again after resolve_ttl.
+    std::size_t batch_size{1};    ///< Maximum number of datagrams sent with a single syscall, 1 disables batching.
+    std::size_t max_pending{64};  ///< Maximum number of datagrams queued while the endpoint is being resolved.
+  };
+
   static std::shared_ptr<Sender> create(const std::string& host, std::uint16_t port,
-                                        const std::shared_ptr<::boost::asio::io_service>& io_service);
+                                        const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                        const std::shared_ptr<dns::ResolverCache>& resolver_cache);
+  static std::shared_ptr<Sender> create(const std::string& host, std::uint16_t port,
+                                        const std::shared_ptr<::boost::asio::io_service>& io_service,
+                                        const std::shared_ptr<dns::ResolverCache>& resolver_cache,
+                                        const Configuration& configuration);
 
   // From udp::Sender
   void send(const std::string& message, const Callback& cb) override;
 
  private:
-  class Session : public std::enable_shared_from_this<Session> {
-   public:
-    static std::shared_ptr<Session> create(const std::shared_ptr<::boost::asio::io_service>& io_service,
-                                           const ::boost::asio::ip::udp::endpoint& endpoint, const std::string& message,
-                                           const Callback& cb);
-
-    void start();
-
-   private:
-    explicit Session(const std::shared_ptr<::boost::asio::io_service>& io_service,
-                     const ::boost::asio::ip::udp::endpoint& endpoint, const std::string& message, const Callback& cb);
+  enum class State { unresolved, resolving, connected };
 
-    void handle_write(const ::boost::system::error_code& error, std::size_t transferred);
-
-    std::shared_ptr<::boost::asio::io_service> io_service_;
-    ::boost::asio::ip::udp::endpoint endpoint_;
-    ::boost::asio::ip::udp::socket socket_;
-    std::string message_;
-    Callback cb_;
+  // Datagram models a message queued for sending.
+  struct Datagram {
+    std::string message;
+    Callback cb;
+    ::boost::system::error_code ec;
+    std::size_t transferred{0};
   };
 
   explicit Sender(const std::string& host, std::uint16_t port,
-                  const std::shared_ptr<::boost::asio::io_service>& io_service);
+                  const std::shared_ptr<::boost::asio::io_service>& io_service,
+                  const std::shared_ptr<dns::ResolverCache>& resolver_cache, const Configuration& configuration);
+
+  // resolve starts resolving the remote endpoint. Has to be called with guard_ held.
+  void resolve();
+  void handle_resolve(const dns::ResolverCache::Result& result);
+
+  // enqueue copies 'message' to the queue of pending datagrams. Has to be called with guard_ held.
+  bool enqueue(const std::string& message, const Callback& cb);
+  // flush sends out all pending datagrams.
+  void flush();
+  // send_pending sends the first 'size' datagrams in flushing_, recording the outcome
+  // with every datagram. Returns true if sending failed. Has to be called with guard_ held.
+  bool send_pending(std::size_t size);
 
   std::string host_;
   std::uint16_t port_;
   std::shared_ptr<::boost::asio::io_service> io_service_;
-  ::boost::asio::ip::udp::resolver resolver_;
+  std::shared_ptr<dns::ResolverCache> resolver_cache_;
+  Configuration configuration_;
+  ::boost::asio::ip::udp::socket socket_;
+
+  std::mutex guard_;
+  State state_{State::unresolved};
+  bool refreshing_{false};
+  std::chrono::steady_clock::time_point resolved_at_;
+  std::vector<Datagram> pending_;
+  std::size_t pending_size_{0};
+
+  std::mutex flush_guard_;
+  std::vector<Datagram> flushing_;
 };
 
 }  // namespace boost
@@ -27,9 +27,10 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
-#include <sstream>
+#include <cstring>
 
 namespace base64 = boost::beast::detail::base64;
 namespace fmt    = airmap::util::fmt;
@@ -53,180 +54,316 @@ bool init_once() {
 
 }  // namespace openssl
 
-class Buffer {
- public:
-  template <typename T>
-  Buffer& add(const T& value) {
-    return add(reinterpret_cast<const char*>(&value), sizeof(value));
-  }
+template <typename Message>
+void append(std::string& buffer, airmap::Telemetry::Update::Type type, const Message& message) {
+  const auto size   = message.ByteSizeLong();
+  const auto offset = buffer.size();
+
+  // resize stays within the reserved capacity of 'buffer' for all but the very
+  // first packets of a flight, and we serialize directly into the resized region.
+  buffer.resize(offset + 2 * sizeof(std::uint16_t) + size);
+
+  auto data                 = reinterpret_cast<std::uint8_t*>(&buffer[offset]);
+  const std::uint16_t tag[] = {htons(static_cast<std::uint16_t>(type)), htons(static_cast<std::uint16_t>(size))};
+  std::memcpy(data, tag, sizeof(tag));
+  message.SerializeWithCachedSizesToArray(data + sizeof(tag));
+}
 
-  Buffer& add(const std::string& s) {
-    return add(s.c_str(), s.size());
+// visit hands the protobuf representation of 'update' to 'f'.
+template <typename F>
+void visit(const airmap::Telemetry::Update& update, F&& f) {
+  switch (update.type()) {
+    case airmap::Telemetry::Update::Type::position: {
+      airmap::telemetry::Position position;
+      position.set_timestamp(update.position().timestamp);
+      position.set_latitude(update.position().latitude);
+      position.set_longitude(update.position().longitude);
+      position.set_altitude_agl(update.position().altitude_gl);
+      position.set_altitude_msl(update.position().altitude_msl);
+      position.set_horizontal_accuracy(update.position().horizontal_accuracy);
+      f(position);
+      break;
+    }
+    case airmap::Telemetry::Update::Type::speed: {
+      airmap::telemetry::Speed speed;
+      speed.set_timestamp(update.speed().timestamp);
+      speed.set_velocity_x(update.speed().velocity_x);
+      speed.set_velocity_y(update.speed().velocity_y);
+      speed.set_velocity_z(update.speed().velocity_z);
+      f(speed);
+      break;
+    }
+    case airmap::Telemetry::Update::Type::attitude: {
+      airmap::telemetry::Attitude attitude;
+      attitude.set_timestamp(update.attitude().timestamp);
+      attitude.set_yaw(update.attitude().yaw);
+      attitude.set_pitch(update.attitude().pitch);
+      attitude.set_roll(update.attitude().roll);
+      f(attitude);
+      break;
+    }
+    case airmap::Telemetry::Update::Type::barometer: {
+      airmap::telemetry::Barometer barometer;
+      barometer.set_timestamp(update.barometer().timestamp);
+      barometer.set_pressure(update.barometer().pressure);
+      f(barometer);
+      break;
+    }
   }
+}
+
+namespace telemetry {
 
-  Buffer& add(const std::vector<std::uint8_t>& v) {
-    return add(reinterpret_cast<const char*>(v.data()), v.size());
+constexpr std::uint8_t encryption_type{1};
+
+}  // namespace telemetry
+
+// KeyBuffer holds decoded key material, cleansing it when going out of scope.
+class KeyBuffer {
+ public:
+  explicit KeyBuffer(std::size_t size) : data_(size, 0) {
   }
 
-  Buffer& add(const char* value, std::size_t size) {
-    buffer_.insert(buffer_.end(), value, value + size);
-    return *this;
+  ~KeyBuffer() {
+    OPENSSL_cleanse(data_.data(), data_.size());
   }
 
-  const std::string& get() const {
-    return buffer_;
+  unsigned char* data() {
+    return data_.data();
   }
 
  private:
-  std::string buffer_;
+  std::vector<unsigned char> data_;
 };
 
-namespace telemetry {
-
-constexpr std::uint8_t encryption_type{1};
-
-}  // namespace telemetry
-}  // namespace
+class OpenSSLAES256EncryptorSession : public airmap::rest::detail::AES256Encryptor::Session {
+ public:
+  explicit OpenSSLAES256EncryptorSession(const std::string& key);
 
-const unsigned int airmap::rest::detail::AES256Encryptor::block_size_in_bytes   = 16;
-const unsigned int airmap::rest::detail::AES256Encryptor::key_size_in_bytes     = 32;
-const bool airmap::rest::detail::OpenSSLAES256Encryptor::is_openssl_initialized = openssl::init_once();
+  void encrypt(const std::string& message, const std::string& iv, std::string& cipher) override;
 
-airmap::rest::detail::OpenSSLAES256Encryptor::OpenSSLAES256Encryptor() {
-}
+ private:
+  std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)> ctx_;
+};
 
-std::string airmap::rest::detail::OpenSSLAES256Encryptor::create_shared_secret() {
-  std::string iv(block_size_in_bytes, 0);
-  if (RAND_bytes(reinterpret_cast<unsigned char*>(&iv[0]), iv.size()) != 1) {
-    // We are very vocal about an error here. RAND_bytes reproting an
-    // error indicates insufficient entropy to create a cryptographically
-    // strong blob of bytes. Better safe than sorry and bail out.
-    throw std::runtime_error{ERR_error_string(ERR_get_error(), nullptr)};
+OpenSSLAES256EncryptorSession::OpenSSLAES256EncryptorSession(const std::string& key)
+    : ctx_{EVP_CIPHER_CTX_new(), ::EVP_CIPHER_CTX_free} {
+  if (not ctx_) {
+    throw std::runtime_error{"failed to create encryption context"};
   }
-  return iv;
-}
 
-std::string airmap::rest::detail::OpenSSLAES256Encryptor::encrypt(const std::string& message, const std::string& key,
-                                                                  const std::string& iv) {
-  const size_t decoded_size = boost::beast::detail::base64::decoded_size(key.size());
-  std::vector<unsigned char> decoded_key(decoded_size);
-  auto res = boost::beast::detail::base64::decode(decoded_key.data(), key.data(), key.size());
-  if(res.first > decoded_size || res.second != key.size())
-  {
+  KeyBuffer decoded_key(base64::decoded_size(key.size()));
+  auto res = base64::decode(decoded_key.data(), key.data(), key.size());
+  // Decoding stops at padding, and only padding might follow.
+  if (key.find_first_not_of('=', res.second) != std::string::npos) {
     throw std::runtime_error{"failed to decode encryption key"};
   }
 
-  std::shared_ptr<EVP_CIPHER_CTX> ctx{EVP_CIPHER_CTX_new(), ::EVP_CIPHER_CTX_free};
-  if (not ctx) {
-    throw std::runtime_error{"failed to create encryption context"};
+  // Keys decoding to more than key_size_in_bytes are truncated, shorter ones are rejected.
+  if (res.first < airmap::rest::detail::AES256Encryptor::key_size_in_bytes) {
+    throw std::runtime_error{"encryption key is too short"};
   }
 
-  if (EVP_EncryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr,
-                         const_cast<const unsigned char*>(decoded_key.data()),
-                         reinterpret_cast<const unsigned char*>(iv.data())) != 1) {
+  // We set up the cipher and expand the key exactly once. Every call to encrypt
+  // reinitializes the context with a new iv only, keeping the expanded key.
+  if (EVP_EncryptInit_ex(ctx_.get(), EVP_aes_256_cbc(), nullptr, decoded_key.data(), nullptr) != 1) {
+    throw std::runtime_error{"failed to initialize encryption context"};
+  }
+}
+
+void OpenSSLAES256EncryptorSession::encrypt(const std::string& message, const std::string& iv, std::string& cipher) {
+  if (EVP_EncryptInit_ex(ctx_.get(), nullptr, nullptr, nullptr, reinterpret_cast<const unsigned char*>(iv.data())) !=
+      1) {
     throw std::runtime_error{"failed to initialize encryption context"};
   }
 
   const auto payload_size = static_cast<int>(message.size());
   auto payload_data       = reinterpret_cast<const unsigned char*>(message.data());
 
-  std::string cipher(payload_size + block_size_in_bytes, '0');
+  cipher.resize(payload_size + airmap::rest::detail::AES256Encryptor::block_size_in_bytes);
 
   const auto cipher_size = static_cast<int>(cipher.size());
   auto cipher_data_begin = reinterpret_cast<unsigned char*>(&cipher[0]);
   auto cipher_data       = cipher_data_begin;
   auto available         = cipher_size;
 
-  if (EVP_EncryptUpdate(ctx.get(), cipher_data, &available, payload_data, payload_size) != 1) {
+  if (EVP_EncryptUpdate(ctx_.get(), cipher_data, &available, payload_data, payload_size) != 1) {
     throw std::runtime_error{"failed to update encryption context for data"};
   }
 
   cipher_data = cipher_data + available;
   available   = cipher_size - available;
 
-  if (EVP_EncryptFinal_ex(ctx.get(), cipher_data, &available) != 1) {
+  if (EVP_EncryptFinal_ex(ctx_.get(), cipher_data, &available) != 1) {
     throw std::runtime_error{"failed to finalize encryption"};
   }
 
   cipher_data = cipher_data + available;
 
-  return std::string{cipher.begin(), cipher.begin() + std::distance(cipher_data_begin, cipher_data)};
+  cipher.resize(std::distance(cipher_data_begin, cipher_data));
+}
+
+}  // namespace
+
+const unsigned int airmap::rest::detail::AES256Encryptor::block_size_in_bytes   = 16;
+const unsigned int airmap::rest::detail::AES256Encryptor::key_size_in_bytes     = 32;
+const bool airmap::rest::detail::OpenSSLAES256Encryptor::is_openssl_initialized = openssl::init_once();
+
+airmap::rest::detail::OpenSSLAES256Encryptor::OpenSSLAES256Encryptor() {
+}
+
+std::unique_ptr<airmap::rest::detail::AES256Encryptor::Session>
+airmap::rest::detail::OpenSSLAES256Encryptor::create_session(const std::string& key) {
+  return std::make_unique<OpenSSLAES256EncryptorSession>(key);
+}
+
+void airmap::rest::detail::OpenSSLAES256Encryptor::create_shared_secret(std::string& iv) {
+  iv.resize(block_size_in_bytes);
+  if (RAND_bytes(reinterpret_cast<unsigned char*>(&iv[0]), iv.size()) != 1) {
+    // We are very vocal about an error here. RAND_bytes reproting an
+    // error indicates insufficient entropy to create a cryptographically
+    // strong blob of bytes. Better safe than sorry and bail out.
+    throw std::runtime_error{ERR_error_string(ERR_get_error(), nullptr)};
+  }
+}
+
+std::string airmap::rest::detail::OpenSSLAES256Encryptor::create_shared_secret() {
+  std::string iv;
+  create_shared_secret(iv);
+  return iv;
+}
+
+std::string airmap::rest::detail::OpenSSLAES256Encryptor::encrypt(const std::string& message, const std::string& key,
+                                                                  const std::string& iv) {
+  std::string cipher;
+  OpenSSLAES256EncryptorSession{key}.encrypt(message, iv, cipher);
+  return cipher;
+}
+
+airmap::rest::detail::PacketBuilder::PacketBuilder(const std::string& flight_id, std::size_t capacity) {
+  payload_.reserve(capacity);
+  packet_.reserve(capacity + flight_id.size() + 2 * AES256Encryptor::block_size_in_bytes);
+
+  const std::uint32_t counter{0};
+  const auto flight_id_size = static_cast<std::uint8_t>(flight_id.size());
+
+  packet_.append(reinterpret_cast<const char*>(&counter), sizeof(counter));
+  packet_.append(reinterpret_cast<const char*>(&flight_id_size), sizeof(flight_id_size));
+  packet_.append(flight_id);
+  packet_.append(reinterpret_cast<const char*>(&::telemetry::encryption_type), sizeof(::telemetry::encryption_type));
+
+  header_size_ = packet_.size();
+}
+
+airmap::rest::detail::PacketBuilder& airmap::rest::detail::PacketBuilder::reset() {
+  payload_.clear();
+  return *this;
+}
+
+std::size_t airmap::rest::detail::PacketBuilder::encoded_size(const airmap::Telemetry::Update& update) {
+  std::size_t result{0};
+  visit(update, [&result](const auto& message) { result = 2 * sizeof(std::uint16_t) + message.ByteSizeLong(); });
+  return result;
+}
+
+std::size_t airmap::rest::detail::PacketBuilder::packet_size(std::size_t flight_id_size, std::size_t payload_size) {
+  // CBC with PKCS#7 padding always adds between 1 and block_size_in_bytes bytes.
+  const auto cipher_size = (payload_size / AES256Encryptor::block_size_in_bytes + 1) *
+                           AES256Encryptor::block_size_in_bytes;
+  return sizeof(std::uint32_t) + sizeof(std::uint8_t) + flight_id_size + sizeof(::telemetry::encryption_type) +
+         AES256Encryptor::block_size_in_bytes + cipher_size;
+}
+
+airmap::rest::detail::PacketBuilder& airmap::rest::detail::PacketBuilder::add(
+    const airmap::Telemetry::Update& update) {
+  visit(update, [this, &update](const auto& message) { append(payload_, update.type(), message); });
+  return *this;
+}
+
+const std::string& airmap::rest::detail::PacketBuilder::payload() const {
+  return payload_;
+}
+
+const std::string& airmap::rest::detail::PacketBuilder::finalize(std::uint32_t counter, const std::string& iv,
+                                                                 const std::string& cipher) {
+  counter = htonl(counter);
+  packet_.resize(header_size_);
+  packet_.replace(0, sizeof(counter), reinterpret_cast<const char*>(&counter), sizeof(counter));
+  packet_.append(iv).append(cipher);
+  return packet_;
+}
+
+airmap::rest::Telemetry::Session::Session(const std::string& flight_id) : packet_builder{flight_id} {
+}
+
+airmap::rest::Telemetry::Session::~Session() {
+  OPENSSL_cleanse(&key[0], key.size());
 }
 
 airmap::rest::Telemetry::Telemetry(const std::shared_ptr<detail::AES256Encryptor>& encryptor,
-                                   const std::shared_ptr<net::udp::Sender>& sender)
-    : sender_{sender}, encryptor_{encryptor} {
+                                   const std::shared_ptr<net::udp::Sender>& sender, std::size_t max_sessions)
+    : sender_{sender}, encryptor_{encryptor}, max_sessions_{std::max<std::size_t>(max_sessions, 1)} {
+}
+
+std::size_t airmap::rest::Telemetry::sessions() {
+  std::lock_guard<std::mutex> lg{guard_};
+  return sessions_.size();
 }
 
 void airmap::rest::Telemetry::submit_updates(const Flight& flight, const std::string& key,
                                              const std::initializer_list<Update>& updates) {
-  static std::uint32_t counter{1};
-
-  Buffer payload;
-
-  for (const auto& update : updates) {
-    switch (update.type()) {
-      case Update::Type::position: {
-        airmap::telemetry::Position position;
-        position.set_timestamp(update.position().timestamp);
-        position.set_latitude(update.position().latitude);
-        position.set_longitude(update.position().longitude);
-        position.set_altitude_agl(update.position().altitude_gl);
-        position.set_altitude_msl(update.position().altitude_msl);
-        position.set_horizontal_accuracy(update.position().horizontal_accuracy);
-        auto message = position.SerializeAsString();
-        payload.add<std::uint16_t>(htons(static_cast<std::uint16_t>(Telemetry::Update::Type::position)))
-            .add<std::uint16_t>(htons(message.size()))
-            .add(message);
-        break;
-      }
-      case Update::Type::speed: {
-        airmap::telemetry::Speed speed;
-        speed.set_timestamp(update.speed().timestamp);
-        speed.set_velocity_x(update.speed().velocity_x);
-        speed.set_velocity_y(update.speed().velocity_y);
-        speed.set_velocity_z(update.speed().velocity_z);
-        auto message = speed.SerializeAsString();
-        payload.add<std::uint16_t>(htons(static_cast<std::uint16_t>(Telemetry::Update::Type::speed)))
-            .add<std::uint16_t>(htons(message.size()))
-            .add(message);
-        break;
-      }
-      case Update::Type::attitude: {
-        airmap::telemetry::Attitude attitude;
-        attitude.set_timestamp(update.attitude().timestamp);
-        attitude.set_yaw(update.attitude().yaw);
-        attitude.set_pitch(update.attitude().pitch);
-        attitude.set_roll(update.attitude().roll);
-        auto message = attitude.SerializeAsString();
-        payload.add<std::uint16_t>(htons(static_cast<std::uint16_t>(Telemetry::Update::Type::attitude)))
-            .add<std::uint16_t>(htons(message.size()))
-            .add(message);
-        break;
-      }
-      case Update::Type::barometer: {
-        airmap::telemetry::Barometer barometer;
-        barometer.set_timestamp(update.barometer().timestamp);
-        barometer.set_pressure(update.barometer().pressure);
-        auto message = barometer.SerializeAsString();
-        payload.add<std::uint16_t>(htons(static_cast<std::uint16_t>(Telemetry::Update::Type::barometer)))
-            .add<std::uint16_t>(htons(message.size()))
-            .add(message);
-        break;
-      }
+  submit_updates(flight, key, updates.begin(), updates.end());
+}
+
+void airmap::rest::Telemetry::submit_updates(const Flight& flight, const std::string& key,
+                                             const std::vector<Update>& updates) {
+  submit_updates(flight, key, updates.data(), updates.data() + updates.size());
+}
+
+void airmap::rest::Telemetry::end_session(const Flight& flight) {
+  std::lock_guard<std::mutex> lg{guard_};
+  sessions_.erase(flight.id);
+}
+
+void airmap::rest::Telemetry::submit_updates(const Flight& flight, const std::string& key, const Update* begin,
+                                             const Update* end) {
+  std::lock_guard<std::mutex> lg{guard_};
+
+  auto& session = this->session(flight.id);
+
+  // The key only changes when flight communications are restarted. We
+  // decode it and set up the encryption context only in that case.
+  if (!session.encryptor || session.key != key) {
+    session.encryptor = encryptor_->create_session(key);
+    OPENSSL_cleanse(&session.key[0], session.key.size());
+    session.key = key;
+  }
+
+  auto& builder = session.packet_builder.reset();
+  for (; begin != end; ++begin)
+    builder.add(*begin);
+
+  encryptor_->create_shared_secret(session.iv);
+  session.encryptor->encrypt(builder.payload(), session.iv, session.cipher);
+
+  sender_->send(builder.finalize(counter_++, session.iv, session.cipher), [](const auto&) {});
+}
+
+airmap::rest::Telemetry::Session& airmap::rest::Telemetry::session(const std::string& flight_id) {
+  auto it = sessions_.find(flight_id);
+
+  if (it == sessions_.end()) {
+    // Flights usually end without telling us. We release the state of the flight
+    // that submitted least recently, which is cheap to set up again if needed.
+    if (sessions_.size() >= max_sessions_) {
+      sessions_.erase(std::min_element(sessions_.begin(), sessions_.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second->last_used < rhs.second->last_used;
+      }));
     }
+
+    it = sessions_.emplace(flight_id, std::make_unique<Session>(flight_id)).first;
   }
 
-  auto iv  = encryptor_->create_shared_secret();
-  auto msg = encryptor_->encrypt(payload.get(), key, iv);
-
-  Buffer packet;
-  sender_->send(packet.add<std::uint32_t>(htonl(counter++))
-                    .add<std::uint8_t>(flight.id.size())
-                    .add(flight.id)
-                    .add<std::uint8_t>(::telemetry::encryption_type)
-                    .add(iv)
-                    .add(msg)
-                    .get(),
-                [](const auto&) {});
+  it->second->last_used = ++uses_;
+  return *it->second;
 }
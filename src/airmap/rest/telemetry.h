@@ -17,7 +17,13 @@
 
 #include <airmap/net/udp/sender.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace airmap {
 namespace rest {
@@ -28,6 +34,24 @@ class AES256Encryptor : public DoNotCopyOrMove {
   static const unsigned int block_size_in_bytes;
   static const unsigned int key_size_in_bytes;
 
+  /// Session encrypts messages with a fixed key, decoded and set up exactly once.
+  class Session : public DoNotCopyOrMove {
+   public:
+    /// encrypt encrypts 'message' with 'iv', replacing the contents of 'cipher'
+    /// with the encrypted message. The capacity of 'cipher' is reused across calls.
+    virtual void encrypt(const std::string& message, const std::string& iv, std::string& cipher) = 0;
+
+   protected:
+    Session() = default;
+  };
+
+  /// create_session returns a new Session encrypting with the base64-encoded 'key'.
+  /// Throws std::runtime_error if 'key' does not decode to at least key_size_in_bytes.
+  virtual std::unique_ptr<Session> create_session(const std::string& key) = 0;
+
+  /// create_shared_secret replaces the contents of 'iv' with a new, random initialization vector.
+  virtual void create_shared_secret(std::string& iv) = 0;
+
   virtual std::string create_shared_secret()                                                             = 0;
   virtual std::string encrypt(const std::string& message, const std::string& key, const std::string& iv) = 0;
 
@@ -40,23 +64,93 @@ class OpenSSLAES256Encryptor : public AES256Encryptor {
   static const bool is_openssl_initialized;
 
   OpenSSLAES256Encryptor();
+  std::unique_ptr<Session> create_session(const std::string& key) override;
+  void create_shared_secret(std::string& iv) override;
   std::string create_shared_secret() override;
   std::string encrypt(const std::string& message, const std::string& key, const std::string& iv) override;
 };
 
+/// PacketBuilder assembles the wire representation of telemetry packets for a single flight.
+///
+/// Buffers are reserved up front and reused across packets. Updates are serialized in place
+/// into the payload buffer and the per-flight part of the packet header is only written once.
+class PacketBuilder : public DoNotCopyOrMove {
+ public:
+  static constexpr std::size_t default_capacity{1024};
+
+  /// encoded_size returns the number of bytes that 'update' occupies in the payload.
+  static std::size_t encoded_size(const airmap::Telemetry::Update& update);
+  /// packet_size returns the size of a packet for a flight id of 'flight_id_size' bytes
+  /// carrying a payload of 'payload_size' bytes, including iv and encryption padding.
+  static std::size_t packet_size(std::size_t flight_id_size, std::size_t payload_size);
+
+  /// PacketBuilder initializes a new instance for the flight identified by 'flight_id',
+  /// reserving 'capacity' bytes for both payload and packet.
+  explicit PacketBuilder(const std::string& flight_id, std::size_t capacity = default_capacity);
+
+  /// reset clears the payload, keeping the reserved capacity.
+  PacketBuilder& reset();
+  /// add serializes 'update' and appends it to the payload.
+  PacketBuilder& add(const airmap::Telemetry::Update& update);
+  /// payload returns the unencrypted payload assembled so far.
+  const std::string& payload() const;
+  /// finalize returns the complete packet consisting of the header for 'counter',
+  /// the initialization vector 'iv' and the encrypted payload 'cipher'.
+  const std::string& finalize(std::uint32_t counter, const std::string& iv, const std::string& cipher);
+
+ private:
+  std::size_t header_size_;
+  std::string payload_;
+  std::string packet_;
+};
+
 }  // namespace detail
 
 class Telemetry : public airmap::Telemetry {
  public:
+  static constexpr std::size_t default_max_sessions{256};
+
+  /// Telemetry initializes a new instance, keeping state for at most 'max_sessions' flights.
+  /// If exceeded, the state of the flight that submitted least recently is released.
   explicit Telemetry(const std::shared_ptr<detail::AES256Encryptor>& encryptor,
-                     const std::shared_ptr<net::udp::Sender>& sender);
+                     const std::shared_ptr<net::udp::Sender>& sender,
+                     std::size_t max_sessions = default_max_sessions);
+
+  /// sessions returns the number of flights that state is kept for.
+  std::size_t sessions();
 
   void submit_updates(const Flight& flight, const std::string& key,
                       const std::initializer_list<Update>& updates) override;
+  void submit_updates(const Flight& flight, const std::string& key, const std::vector<Update>& updates) override;
+  void end_session(const Flight& flight) override;
 
  private:
+  /// Session bundles up all state required to submit updates for a single flight.
+  struct Session {
+    explicit Session(const std::string& flight_id);
+    // ~Session cleanses the key.
+    ~Session();
+
+    std::string key;
+    std::uint64_t last_used{0};
+    std::unique_ptr<detail::AES256Encryptor::Session> encryptor;
+    detail::PacketBuilder packet_builder;
+    std::string iv;
+    std::string cipher;
+  };
+
+  void submit_updates(const Flight& flight, const std::string& key, const Update* begin, const Update* end);
+  // session returns the Session for 'flight_id', creating it and releasing the least
+  // recently used one if needed. Requires guard_ to be held.
+  Session& session(const std::string& flight_id);
+
   std::shared_ptr<net::udp::Sender> sender_;
   std::shared_ptr<detail::AES256Encryptor> encryptor_;
+  std::size_t max_sessions_;
+  std::mutex guard_;
+  std::uint32_t counter_{1};
+  std::uint64_t uses_{0};
+  std::unordered_map<std::string, std::unique_ptr<Session>> sessions_;
 };
 
 }  // namespace rest
@@ -22,7 +22,6 @@
 
 namespace fmt = airmap::util::fmt;
 namespace ph  = std::placeholders;
-using json    = nlohmann::json;
 
 namespace {
 constexpr const char* component{"rest::Traffic::Monitor"};
@@ -62,7 +61,7 @@ void airmap::rest::Traffic::Monitor::unsubscribe(const std::shared_ptr<Subscribe
 }
 
 void airmap::rest::Traffic::Monitor::handle_publish(const std::string& topic, const std::string& contents) {
-  std::vector<Update> update = json::parse(contents)["traffic"];
+  codec::json::decode_traffic_payload(contents, updates_);
 
   Traffic::Update::Type type{Traffic::Update::Type::unknown};
 
@@ -73,7 +72,7 @@ void airmap::rest::Traffic::Monitor::handle_publish(const std::string& topic, co
   }
 
   for (const auto& subscriber : subscribers_) {
-    subscriber->handle_update(type, update);
+    subscriber->handle_update(type, updates_);
   }
 }
 
@@ -46,6 +46,7 @@ class Traffic : public airmap::Traffic {
     std::unique_ptr<net::mqtt::Client::Subscription> sa_sub_;
     std::unique_ptr<net::mqtt::Client::Subscription> alert_sub_;
     std::set<std::shared_ptr<Subscriber>> subscribers_;
+    std::vector<Update> updates_;  // Reused across publishs, keeping its storage.
     std::uint8_t sa_subscription_id_;
   };
 
@@ -47,3 +47,12 @@ const airmap::Telemetry::Attitude& airmap::Telemetry::Update::attitude() const {
 const airmap::Telemetry::Barometer& airmap::Telemetry::Update::barometer() const {
   return data_.barometer;
 }
+
+void airmap::Telemetry::submit_updates(const Flight& flight, const std::string& key,
+                                       const std::vector<Update>& updates) {
+  for (const auto& update : updates)
+    submit_updates(flight, key, {update});
+}
+
+void airmap::Telemetry::end_session(const Flight&) {
+}
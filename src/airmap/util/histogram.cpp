@@ -0,0 +1,42 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <airmap/util/histogram.h>
+
+#include <algorithm>
+
+airmap::util::Histogram::Histogram(const std::vector<std::uint64_t>& upper_bounds)
+    : upper_bounds_{upper_bounds}, counts_(upper_bounds.size() + 1, 0) {
+}
+
+void airmap::util::Histogram::add(std::uint64_t sample) {
+  auto it = std::lower_bound(upper_bounds_.begin(), upper_bounds_.end(), sample);
+  ++counts_[std::distance(upper_bounds_.begin(), it)];
+  ++total_;
+  sum_ += sample;
+}
+
+const std::vector<std::uint64_t>& airmap::util::Histogram::upper_bounds() const {
+  return upper_bounds_;
+}
+
+const std::vector<std::uint64_t>& airmap::util::Histogram::counts() const {
+  return counts_;
+}
+
+std::uint64_t airmap::util::Histogram::total() const {
+  return total_;
+}
+
+std::uint64_t airmap::util::Histogram::sum() const {
+  return sum_;
+}
@@ -0,0 +1,57 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_UTIL_HISTOGRAM_H_
+#define AIRMAP_UTIL_HISTOGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace airmap {
+namespace util {
+
+/// Histogram counts samples in buckets with fixed upper bounds.
+///
+/// Bucket i counts all samples s with upper_bounds[i-1] < s <= upper_bounds[i].
+/// Samples exceeding the last bound are counted in a trailing overflow bucket.
+class Histogram {
+ public:
+  /// Histogram initializes a new instance with buckets bounded by 'upper_bounds',
+  /// which must be sorted in ascending order.
+  explicit Histogram(const std::vector<std::uint64_t>& upper_bounds);
+
+  /// add counts 'sample' in its bucket.
+  void add(std::uint64_t sample);
+
+  /// upper_bounds returns the upper bounds of all buckets but the overflow bucket.
+  const std::vector<std::uint64_t>& upper_bounds() const;
+
+  /// counts returns the number of samples per bucket, including the overflow bucket.
+  const std::vector<std::uint64_t>& counts() const;
+
+  /// total returns the number of samples added to the histogram.
+  std::uint64_t total() const;
+
+  /// sum returns the sum of all samples added to the histogram.
+  std::uint64_t sum() const;
+
+ private:
+  std::vector<std::uint64_t> upper_bounds_;
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t total_{0};
+  std::uint64_t sum_{0};
+};
+
+}  // namespace util
+}  // namespace airmap
+
+#endif  // AIRMAP_UTIL_HISTOGRAM_H_
@@ -0,0 +1,86 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef AIRMAP_UTIL_SPSC_RING_H_
+#define AIRMAP_UTIL_SPSC_RING_H_
+
+#include <airmap/do_not_copy_or_move.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace airmap {
+namespace util {
+
+/// SpscRing is a bounded, lock-free queue connecting exactly one producer
+/// thread with exactly one consumer thread.
+///
+/// The capacity is rounded up to the next power of two. Elements are
+/// consumed in place, without copying them out of the ring.
+template <typename T>
+class SpscRing : DoNotCopyOrMove {
+ public:
+  /// SpscRing initializes a new instance with room for at least 'capacity' elements.
+  explicit SpscRing(std::size_t capacity) : storage_(round_up(capacity)), mask_{storage_.size() - 1} {
+  }
+
+  /// try_push appends 'value' and returns true, or returns false if the ring is full.
+  /// Must only be called from the producer thread.
+  bool try_push(const T& value) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == storage_.size())
+      return false;
+
+    storage_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// consume hands up to 'max' elements to 'f' in FIFO order and returns the number
+  /// of consumed elements. Must only be called from the consumer thread.
+  template <typename F>
+  std::size_t consume(F&& f, std::size_t max) {
+    auto head      = head_.load(std::memory_order_relaxed);
+    auto available = tail_.load(std::memory_order_acquire) - head;
+    auto count     = available < max ? available : max;
+
+    for (std::size_t i = 0; i < count; i++)
+      f(storage_[(head + i) & mask_]);
+
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  /// empty returns true if the ring does not contain any elements.
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static std::size_t round_up(std::size_t capacity) {
+    std::size_t result = 1;
+    while (result < capacity)
+      result <<= 1;
+    return result;
+  }
+
+  std::vector<T> storage_;
+  std::size_t mask_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+}  // namespace util
+}  // namespace airmap
+
+#endif  // AIRMAP_UTIL_SPSC_RING_H_
@@ -0,0 +1,238 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE caching_requester
+
+#include <airmap/net/http/caching_requester.h>
+#include <airmap/net/http/response_cache.h>
+
+#include <mock/http_requester.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using airmap::net::http::CachingRequester;
+using airmap::net::http::Requester;
+using airmap::net::http::Response;
+using airmap::net::http::ResponseCache;
+using StringMap = mock::HttpRequester::StringMap;
+
+Response make_response(unsigned int status, const std::string& body, const StringMap& headers = StringMap{}) {
+  return Response{11, status, headers, body, body.size(), body.size()};
+}
+
+// Fixture wires up a CachingRequester with a mocked requester, recording the callbacks of pending requests.
+struct Fixture {
+  std::shared_ptr<CachingRequester> make_requester(const std::shared_ptr<ResponseCache>& cache) {
+    return std::make_shared<CachingRequester>("https://api.airmap.com:443", airmap::Microseconds{airmap::minutes(5)},
+                                              airmap::Microseconds{airmap::minutes(10)}, cache, next);
+  }
+
+  // get issues a get request of 'path' and returns a pointer to the result, set once the request completes.
+  std::shared_ptr<Requester::Result> get(const std::string& path, StringMap query = StringMap{},
+                                         StringMap headers = StringMap{}) {
+    auto result = std::make_shared<Requester::Result>(airmap::Error{"pending"});
+    requester->get(path, std::move(query), std::move(headers),
+                   [result](const Requester::Result& r) { *result = r; });
+    return result;
+  }
+
+  // complete completes the oldest pending request with 'result'.
+  void complete(const Requester::Result& result) {
+    BOOST_REQUIRE(!pending.empty());
+    auto cb = pending.front();
+    pending.erase(pending.begin());
+    cb(result);
+  }
+
+  std::shared_ptr<mock::HttpRequester> next{std::make_shared<mock::HttpRequester>()};
+  std::vector<Requester::Callback> pending;
+  std::vector<StringMap> headers;
+  std::unique_ptr<trompeloeil::expectation> expectation{
+      NAMED_ALLOW_CALL(*next, get(mock::_, mock::_, mock::_, mock::_))
+          .LR_SIDE_EFFECT(headers.push_back(_3))
+          .LR_SIDE_EFFECT(pending.push_back(_4))};
+  std::shared_ptr<ResponseCache> cache{ResponseCache::create(ResponseCache::Configuration{})};
+  std::shared_ptr<CachingRequester> requester{make_requester(cache)};
+};
+
+// Directory creates an empty, temporary directory and removes it again.
+struct Directory {
+  Directory() : path{std::filesystem::temp_directory_path() / "airmap-caching-requester-test"} {
+    std::filesystem::remove_all(path);
+  }
+
+  ~Directory() {
+    std::filesystem::remove_all(path);
+  }
+
+  std::filesystem::path path;
+};
+
+// expire moves the entry for 'key' in 'cache' 'age' into the past.
+void expire(const std::shared_ptr<ResponseCache>& cache, const std::string& key, std::chrono::seconds age) {
+  auto entry = cache->lookup(key);
+  BOOST_REQUIRE(entry);
+  entry.get().expires = ResponseCache::Clock::now() - age;
+  cache->store(key, entry.get());
+}
+
+// key_of_status is the key of the response to a get request of /status without query and headers.
+constexpr const char* key_of_status{"https://api.airmap.com:443 GET /status?"};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(fresh_responses_are_served_from_the_cache, Fixture) {
+  auto first = get("/status");
+  complete(Requester::Result{make_response(200, "ok")});
+
+  auto second = get("/status");
+
+  BOOST_CHECK(pending.empty());
+  BOOST_REQUIRE(*second);
+  BOOST_CHECK_EQUAL("ok", second->value().body);
+  BOOST_CHECK_EQUAL(1u, headers.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(responses_are_not_shared_across_credentials, Fixture) {
+  get("/status", StringMap{}, StringMap{{"Authorization", "Bearer first"}});
+  complete(Requester::Result{make_response(200, "first")});
+
+  auto other = get("/status", StringMap{}, StringMap{{"Authorization", "Bearer second"}});
+  BOOST_CHECK_EQUAL(1u, pending.size());
+  complete(Requester::Result{make_response(200, "second")});
+
+  auto same = get("/status", StringMap{}, StringMap{{"authorization", "Bearer first"}});
+  BOOST_CHECK(pending.empty());
+  BOOST_REQUIRE(*same);
+  BOOST_CHECK_EQUAL("first", same->value().body);
+
+  get("/status", StringMap{}, StringMap{{"X-API-Key", "key"}});
+  BOOST_CHECK_EQUAL(1u, pending.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(query_values_are_escaped_in_keys, Fixture) {
+  get("/search", StringMap{{"a", "1&b=2"}});
+  complete(Requester::Result{make_response(200, "escaped")});
+
+  get("/search", StringMap{{"a", "1"}, {"b", "2"}});
+  BOOST_CHECK_EQUAL(1u, pending.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(stale_responses_are_revalidated_with_their_validators, Fixture) {
+  get("/status");
+  complete(Requester::Result{make_response(200, "ok", StringMap{{"etag", "\"v1\""}})});
+  expire(cache, key_of_status, std::chrono::seconds{1});
+
+  auto result = get("/status");
+  BOOST_REQUIRE_EQUAL(2u, headers.size());
+  BOOST_CHECK_EQUAL("\"v1\"", headers.back().at("If-None-Match"));
+
+  complete(Requester::Result{make_response(304, "")});
+  BOOST_REQUIRE(*result);
+  BOOST_CHECK_EQUAL("ok", result->value().body);
+}
+
+BOOST_FIXTURE_TEST_CASE(stale_responses_stand_in_for_failures_up_to_max_stale, Fixture) {
+  get("/status");
+  complete(Requester::Result{make_response(200, "ok")});
+
+  expire(cache, key_of_status, std::chrono::seconds{60});
+  auto stale = get("/status");
+  complete(Requester::Result{airmap::Error{"offline"}});
+  BOOST_REQUIRE(*stale);
+  BOOST_CHECK_EQUAL("ok", stale->value().body);
+
+  expire(cache, key_of_status, std::chrono::seconds{11 * 60});
+  auto too_stale = get("/status");
+  complete(Requester::Result{make_response(503, "unavailable")});
+  BOOST_REQUIRE(*too_stale);
+  BOOST_CHECK_EQUAL(503u, too_stale->value().status);
+}
+
+BOOST_AUTO_TEST_CASE(persisted_responses_are_served_fresh_but_never_stale) {
+  Directory directory;
+  ResponseCache::Configuration configuration;
+  configuration.directory = directory.path;
+
+  {
+    Fixture fixture;
+    fixture.cache     = ResponseCache::create(configuration);
+    fixture.requester = fixture.make_requester(fixture.cache);
+    fixture.get("/status");
+    fixture.complete(Requester::Result{make_response(200, "persisted")});
+  }
+
+  Fixture fixture;
+  fixture.cache     = ResponseCache::create(configuration);
+  fixture.requester = fixture.make_requester(fixture.cache);
+
+  auto fresh = fixture.get("/status");
+  BOOST_CHECK(fixture.pending.empty());
+  BOOST_REQUIRE(*fresh);
+  BOOST_CHECK_EQUAL("persisted", fresh->value().body);
+
+  // Expiring the entry writes it through, restart once more to read it from disk again.
+  expire(fixture.cache, key_of_status, std::chrono::seconds{1});
+  fixture.cache.reset();
+  fixture.requester.reset();
+  fixture.cache     = ResponseCache::create(configuration);
+  fixture.requester = fixture.make_requester(fixture.cache);
+
+  auto stale = fixture.get("/status");
+  fixture.complete(Requester::Result{airmap::Error{"offline"}});
+  BOOST_CHECK(!*stale);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_evicts_least_recently_used_entries) {
+  ResponseCache::Configuration configuration;
+  configuration.max_bytes = 100;
+  auto cache              = ResponseCache::create(configuration);
+
+  cache->store("a", ResponseCache::Entry{make_response(200, std::string(40, 'a')), ResponseCache::Clock::now()});
+  cache->store("b", ResponseCache::Entry{make_response(200, std::string(40, 'b')), ResponseCache::Clock::now()});
+  BOOST_CHECK(cache->lookup("a"));
+  cache->store("c", ResponseCache::Entry{make_response(200, std::string(40, 'c')), ResponseCache::Clock::now()});
+
+  BOOST_CHECK(cache->lookup("a"));
+  BOOST_CHECK(!cache->lookup("b"));
+  BOOST_CHECK(cache->lookup("c"));
+  BOOST_CHECK_EQUAL(82u, cache->size());
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_never_writes_keys_to_disk) {
+  Directory directory;
+  ResponseCache::Configuration configuration;
+  configuration.directory = directory.path;
+
+  ResponseCache::create(configuration)
+      ->store("Authorization: secret", ResponseCache::Entry{make_response(200, "body"), ResponseCache::Clock::now()});
+
+  std::size_t files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator{directory.path}) {
+    std::ifstream in{entry.path()};
+    std::string content{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    BOOST_CHECK(content.find("secret") == std::string::npos);
+    files++;
+  }
+
+  BOOST_CHECK_EQUAL(1u, files);
+}
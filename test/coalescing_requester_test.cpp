@@ -0,0 +1,143 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE coalescing_requester
+
+#include <airmap/net/http/coalescing_requester.h>
+
+#include <mock/http_requester.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using airmap::net::http::CoalescingRequester;
+using airmap::net::http::Requester;
+using airmap::net::http::Response;
+using StringMap = mock::HttpRequester::StringMap;
+
+// Fixture wires up a CoalescingRequester with a mocked requester, recording the callbacks of pending requests.
+struct Fixture {
+  // get issues a get request and records its results in 'results'.
+  void get(const std::string& path, StringMap query = StringMap{}, StringMap headers = StringMap{}) {
+    requester->get(path, std::move(query), std::move(headers),
+                   [this](const Requester::Result& result) { results.push_back(result); });
+  }
+
+  // complete completes the oldest pending request with 'result'.
+  void complete(const Requester::Result& result) {
+    BOOST_REQUIRE(!pending.empty());
+    auto cb = pending.front();
+    pending.erase(pending.begin());
+    cb(result);
+  }
+
+  std::shared_ptr<mock::HttpRequester> next{std::make_shared<mock::HttpRequester>()};
+  std::vector<Requester::Callback> pending;
+  std::vector<Requester::Result> results;
+  std::unique_ptr<trompeloeil::expectation> expectation{
+      NAMED_ALLOW_CALL(*next, get(mock::_, mock::_, mock::_, mock::_)).LR_SIDE_EFFECT(pending.push_back(_4))};
+  std::shared_ptr<CoalescingRequester> requester{std::make_shared<CoalescingRequester>(next)};
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(identical_requests_join_the_request_in_flight, Fixture) {
+  get("/status", StringMap{{"latitude", "1"}, {"longitude", "2"}});
+  get("/status", StringMap{{"longitude", "2"}, {"latitude", "1"}});
+  get("/status", StringMap{{"latitude", "1"}, {"longitude", "2"}});
+
+  BOOST_CHECK_EQUAL(1u, pending.size());
+  BOOST_CHECK_EQUAL(1u, requester->in_flight());
+
+  complete(Requester::Result{Response{11, 200, {}, "ok", 2, 2}});
+
+  BOOST_REQUIRE_EQUAL(3u, results.size());
+  for (const auto& result : results) {
+    BOOST_REQUIRE(result);
+    BOOST_CHECK_EQUAL("ok", result.value().body);
+    // All callers share a single memo, such that the body is decoded only once.
+    BOOST_CHECK(result.value().memo);
+    BOOST_CHECK(result.value().memo == results.front().value().memo);
+  }
+  BOOST_CHECK_EQUAL(0u, requester->in_flight());
+}
+
+BOOST_FIXTURE_TEST_CASE(requests_with_different_credentials_are_not_coalesced, Fixture) {
+  get("/status", StringMap{}, StringMap{{"Authorization", "Bearer first"}});
+  get("/status", StringMap{}, StringMap{{"Authorization", "Bearer second"}});
+  get("/status", StringMap{}, StringMap{{"X-API-Key", "key"}});
+  get("/status");
+
+  BOOST_CHECK_EQUAL(4u, pending.size());
+  BOOST_CHECK_EQUAL(4u, requester->in_flight());
+
+  complete(Requester::Result{Response{11, 200, {}, "first", 5, 5}});
+
+  BOOST_REQUIRE_EQUAL(1u, results.size());
+  BOOST_CHECK_EQUAL("first", results.front().value().body);
+  BOOST_CHECK_EQUAL(3u, requester->in_flight());
+}
+
+BOOST_FIXTURE_TEST_CASE(requests_differing_in_path_or_query_are_not_coalesced, Fixture) {
+  get("/status");
+  get("/advisories");
+  get("/status", StringMap{{"a", "1&b=2"}});
+  get("/status", StringMap{{"a", "1"}, {"b", "2"}});
+
+  BOOST_CHECK_EQUAL(4u, pending.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(errors_fan_out_to_all_joined_callers, Fixture) {
+  get("/status");
+  get("/status");
+
+  complete(Requester::Result{airmap::Error{"offline"}});
+
+  BOOST_REQUIRE_EQUAL(2u, results.size());
+  for (const auto& result : results) {
+    BOOST_REQUIRE(!result);
+    BOOST_CHECK_EQUAL("offline", result.error().message());
+  }
+
+  // A request issued after the failed one is handed off again.
+  get("/status");
+  BOOST_CHECK_EQUAL(1u, pending.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(requests_completing_synchronously_are_not_joined, Fixture) {
+  auto next     = std::make_shared<mock::HttpRequester>();
+  auto calls    = 0;
+  auto expected = NAMED_ALLOW_CALL(*next, get(mock::_, mock::_, mock::_, mock::_))
+                      .LR_SIDE_EFFECT(calls++)
+                      .SIDE_EFFECT(_4(Requester::Result{Response{11, 200, {}, "ok", 2, 2}}));
+  requester = std::make_shared<CoalescingRequester>(next);
+
+  get("/status");
+  get("/status");
+
+  BOOST_CHECK_EQUAL(2, calls);
+  BOOST_CHECK_EQUAL(2u, results.size());
+  BOOST_CHECK_EQUAL(0u, requester->in_flight());
+}
+
+BOOST_FIXTURE_TEST_CASE(other_verbs_are_handed_off_unchanged, Fixture) {
+  REQUIRE_CALL(*next, post(mock::_, mock::_, mock::_, mock::_));
+  REQUIRE_CALL(*next, post(mock::_, mock::_, mock::_, mock::_));
+
+  requester->post("/flights", StringMap{}, "{}", [](const Requester::Result&) {});
+  requester->post("/flights", StringMap{}, "{}", [](const Requester::Result&) {});
+}
@@ -0,0 +1,162 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE connection_pool
+
+#include <airmap/net/http/boost/connection_pool.h>
+
+#include <boost/asio.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace asio = boost::asio;
+
+namespace {
+
+using airmap::net::http::boost::Connection;
+using airmap::net::http::boost::ConnectionPool;
+using Priority = ConnectionPool::Priority;
+
+// IdleConnection never carries any exchange, it only tracks whether it is open.
+class IdleConnection : public Connection {
+ public:
+  void async_connect(const asio::ip::tcp::endpoint&, const Handler&) override {
+  }
+
+  void async_write(Request&, const Handler&) override {
+  }
+
+  void async_read(Response&, const Handler&) override {
+  }
+
+  void close() override {
+    open_ = false;
+  }
+
+  bool is_open() const override {
+    return open_;
+  }
+
+ private:
+  bool open_{true};
+};
+
+// Fixture holds the only connection of a pool, queues acquisitions behind it and
+// records the order in which they are served. Every served acquisition releases
+// its connection right away, handing it on to the next one.
+struct Fixture {
+  std::shared_ptr<ConnectionPool> make_pool(std::size_t max_consecutive_grants) {
+    ConnectionPool::Configuration configuration;
+    configuration.max_connections        = 1;
+    configuration.max_consecutive_grants = max_consecutive_grants;
+    return ConnectionPool::create(configuration, io_service,
+                                  []() -> std::shared_ptr<Connection> { return std::make_shared<IdleConnection>(); });
+  }
+
+  void hold() {
+    pool->acquire(Priority::normal, [this](const std::shared_ptr<Connection>& c, bool) { held = c; });
+    run();
+  }
+
+  void queue(Priority priority, const std::string& name) {
+    pool->acquire(priority, [this, name](const std::shared_ptr<Connection>& c, bool) {
+      served.push_back(name);
+      pool->release(c, true);
+    });
+  }
+
+  void release_and_run() {
+    pool->release(held, true);
+    held.reset();
+    run();
+  }
+
+  // The pool's idle timer keeps the io_service busy, we only run the handlers that are ready.
+  void run() {
+    io_service->reset();
+    io_service->poll();
+  }
+
+  std::shared_ptr<asio::io_service> io_service{std::make_shared<asio::io_service>()};
+  std::shared_ptr<ConnectionPool> pool{make_pool(8)};
+  std::shared_ptr<Connection> held;
+  std::vector<std::string> served;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(waiting_acquisitions_are_served_by_priority_and_arrival, Fixture) {
+  hold();
+  queue(Priority::low, "low");
+  queue(Priority::normal, "normal 1");
+  queue(Priority::high, "high 1");
+  queue(Priority::normal, "normal 2");
+  queue(Priority::high, "high 2");
+
+  BOOST_CHECK_EQUAL(1u, pool->active());
+  release_and_run();
+
+  BOOST_CHECK((std::vector<std::string>{"high 1", "high 2", "normal 1", "normal 2", "low"} == served));
+  BOOST_CHECK_EQUAL(0u, pool->active());
+  BOOST_CHECK_EQUAL(1u, pool->idle());
+}
+
+BOOST_FIXTURE_TEST_CASE(lower_priorities_are_served_after_max_consecutive_grants, Fixture) {
+  pool = make_pool(2);
+
+  hold();
+  queue(Priority::low, "low");
+  for (const auto& name : {"high 1", "high 2", "high 3", "high 4"})
+    queue(Priority::high, name);
+  release_and_run();
+
+  BOOST_CHECK((std::vector<std::string>{"high 1", "high 2", "low", "high 3", "high 4"} == served));
+}
+
+BOOST_FIXTURE_TEST_CASE(aging_serves_the_longest_waiting_lower_priority, Fixture) {
+  pool = make_pool(1);
+
+  hold();
+  queue(Priority::normal, "normal");
+  queue(Priority::low, "low");
+  queue(Priority::high, "high 1");
+  queue(Priority::high, "high 2");
+  queue(Priority::high, "high 3");
+  release_and_run();
+
+  BOOST_CHECK((std::vector<std::string>{"high 1", "normal", "high 2", "low", "high 3"} == served));
+}
+
+BOOST_FIXTURE_TEST_CASE(statistics_account_for_waiting_acquisitions_per_priority, Fixture) {
+  hold();
+  queue(Priority::low, "low 1");
+  queue(Priority::low, "low 2");
+  queue(Priority::high, "high");
+
+  auto statistics = pool->statistics();
+  BOOST_REQUIRE_EQUAL(3u, statistics.size());
+  BOOST_CHECK(Priority::high == statistics[0].priority);
+  BOOST_CHECK_EQUAL(1u, statistics[0].waiting);
+  BOOST_CHECK_EQUAL(0u, statistics[1].waiting);
+  BOOST_CHECK_EQUAL(2u, statistics[2].waiting);
+
+  release_and_run();
+
+  statistics = pool->statistics();
+  BOOST_CHECK_EQUAL(1u, statistics[0].wait_times.total());
+  BOOST_CHECK_EQUAL(1u, statistics[1].wait_times.total());
+  BOOST_CHECK_EQUAL(2u, statistics[2].wait_times.total());
+  BOOST_CHECK_EQUAL(0u, statistics[2].waiting);
+}
@@ -0,0 +1,203 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE content_coding
+
+#include <airmap/net/http/boost/decoding_body.h>
+#include <airmap/net/http/content_coding.h>
+
+#include <boost/beast/http.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace content_coding = airmap::net::http::content_coding;
+namespace http           = boost::beast::http;
+
+using ContentDecoder = airmap::net::http::ContentDecoder;
+using DecodingBody   = airmap::net::http::boost::DecodingBody;
+
+namespace {
+
+// deflate compresses 'in' to the format selected by 'window_bits'.
+std::string deflate(const std::string& in, int window_bits) {
+  z_stream stream{};
+  BOOST_REQUIRE_EQUAL(Z_OK,
+                      deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY));
+
+  std::string out(deflateBound(&stream, in.size()), '\0');
+  stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  stream.avail_in  = static_cast<uInt>(in.size());
+  stream.next_out  = reinterpret_cast<Bytef*>(&out[0]);
+  stream.avail_out = static_cast<uInt>(out.size());
+
+  BOOST_REQUIRE_EQUAL(Z_STREAM_END, ::deflate(&stream, Z_FINISH));
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  return out;
+}
+
+// payload returns a compressible text of 'size' bytes.
+std::string payload(std::size_t size) {
+  std::string result;
+  for (std::size_t i = 0; result.size() < size; i++)
+    result += "{\"id\":" + std::to_string(i) + ",\"name\":\"airspace\"},";
+  result.resize(size);
+  return result;
+}
+
+// decode feeds 'in' to a decoder for 'coding' in chunks of 'chunk' bytes.
+bool decode(const std::string& coding, const std::string& in, std::string& out, std::size_t chunk = 1024,
+            std::size_t max_size = std::numeric_limits<std::size_t>::max()) {
+  auto decoder = ContentDecoder::create(coding, max_size);
+  BOOST_REQUIRE(decoder);
+
+  for (std::size_t offset = 0; offset < in.size(); offset += chunk) {
+    if (!decoder->decode(in.data() + offset, std::min(chunk, in.size() - offset), out))
+      return false;
+  }
+
+  return decoder->finish();
+}
+
+// parse runs a response with 'body' encoded as 'coding' through a Beast parser reading into a DecodingBody.
+http::response<DecodingBody> parse(const std::string& coding, const std::string& body, boost::system::error_code& ec) {
+  std::string message = "HTTP/1.1 200 OK\r\nContent-Encoding: " + coding +
+                        "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+
+  http::response_parser<DecodingBody> parser;
+  parser.body_limit(message.size());
+  parser.eager(true);
+  parser.put(boost::asio::buffer(message), ec);
+  if (!ec)
+    BOOST_CHECK(parser.is_done());
+  return parser.release();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(compressed_bodies_decode_to_the_original) {
+  auto original   = payload(100 * 1024);
+  auto compressed = content_coding::compress(original);
+
+  BOOST_CHECK_LT(compressed.size(), original.size());
+
+  std::string out;
+  BOOST_CHECK(decode(content_coding::gzip, compressed, out));
+  BOOST_CHECK(original == out);
+}
+
+BOOST_AUTO_TEST_CASE(bodies_fed_byte_by_byte_decode_to_the_original) {
+  auto original = payload(4 * 1024);
+
+  std::string out;
+  BOOST_CHECK(decode(content_coding::gzip, content_coding::compress(original), out, 1));
+  BOOST_CHECK(original == out);
+}
+
+BOOST_AUTO_TEST_CASE(empty_bodies_compress_and_decode) {
+  std::string out;
+  BOOST_CHECK(decode(content_coding::gzip, content_coding::compress(std::string{}), out));
+  BOOST_CHECK(out.empty());
+}
+
+BOOST_AUTO_TEST_CASE(deflate_accepts_both_the_zlib_and_the_raw_format) {
+  auto original = payload(8 * 1024);
+
+  std::string zlib;
+  BOOST_CHECK(decode(content_coding::deflate, deflate(original, 15), zlib));
+  BOOST_CHECK(original == zlib);
+
+  std::string raw;
+  BOOST_CHECK(decode(content_coding::deflate, deflate(original, -15), raw));
+  BOOST_CHECK(original == raw);
+}
+
+BOOST_AUTO_TEST_CASE(multi_member_gzip_bodies_decode_to_the_concatenation) {
+  auto compressed = content_coding::compress("first") + content_coding::compress("second");
+
+  std::string out;
+  BOOST_CHECK(decode(content_coding::gzip, compressed, out));
+  BOOST_CHECK_EQUAL("firstsecond", out);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_bodies_fail_to_decode) {
+  auto compressed = content_coding::compress(payload(1024));
+  compressed[compressed.size() / 2] ^= 0xff;
+  compressed[compressed.size() / 2 + 1] ^= 0xff;
+
+  std::string out;
+  BOOST_CHECK(!decode(content_coding::gzip, compressed, out));
+}
+
+BOOST_AUTO_TEST_CASE(truncated_bodies_fail_to_finish) {
+  auto compressed = content_coding::compress(payload(1024));
+  compressed.resize(compressed.size() / 2);
+
+  std::string out;
+  BOOST_CHECK(!decode(content_coding::gzip, compressed, out));
+}
+
+BOOST_AUTO_TEST_CASE(decoding_stops_beyond_max_size) {
+  auto compressed = content_coding::compress(std::string(16 * 1024 * 1024, '\0'));
+
+  std::string out;
+  BOOST_CHECK(!decode(content_coding::gzip, compressed, out, compressed.size(), 1024 * 1024));
+  BOOST_CHECK_LE(out.size(), 1024u * 1024u + 64u * 1024u);
+
+  std::string identity;
+  BOOST_CHECK(!decode(content_coding::identity, std::string(1025, 'a'), identity, 1024, 1024));
+}
+
+BOOST_AUTO_TEST_CASE(decoders_are_selected_by_coding) {
+  BOOST_CHECK(ContentDecoder::create(""));
+  BOOST_CHECK(ContentDecoder::create(content_coding::identity));
+  BOOST_CHECK(ContentDecoder::create(" GZIP "));
+  BOOST_CHECK(ContentDecoder::create("x-gzip"));
+  BOOST_CHECK(ContentDecoder::create(content_coding::deflate));
+  BOOST_CHECK(!ContentDecoder::create("compress"));
+  BOOST_CHECK(content_coding::accepted().find(content_coding::gzip) != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(decoding_body_decodes_responses_and_counts_wire_bytes) {
+  auto original   = payload(64 * 1024);
+  auto compressed = content_coding::compress(original);
+
+  boost::system::error_code ec;
+  auto response = parse(content_coding::gzip, compressed, ec);
+
+  BOOST_REQUIRE(!ec);
+  BOOST_CHECK(original == response.body().data);
+  BOOST_CHECK_EQUAL(compressed.size(), response.body().wire_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(decoding_body_fails_responses_decoding_beyond_the_maximum_size) {
+  auto compressed = content_coding::compress(std::string(DecodingBody::max_decoded_size + 1, '\0'));
+
+  boost::system::error_code ec;
+  parse(content_coding::gzip, compressed, ec);
+
+  BOOST_CHECK(ec == boost::system::errc::message_size);
+}
+
+BOOST_AUTO_TEST_CASE(decoding_body_fails_responses_with_unsupported_codings) {
+  boost::system::error_code ec;
+  parse("compress", "abc", ec);
+
+  BOOST_CHECK(ec == boost::system::errc::not_supported);
+}
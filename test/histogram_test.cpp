@@ -0,0 +1,52 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE histogram
+
+#include <airmap/util/histogram.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using Histogram = airmap::util::Histogram;
+
+BOOST_AUTO_TEST_CASE(histogram_starts_out_empty) {
+  Histogram histogram{{10, 100}};
+
+  BOOST_CHECK((std::vector<std::uint64_t>{10, 100} == histogram.upper_bounds()));
+  BOOST_CHECK((std::vector<std::uint64_t>{0, 0, 0} == histogram.counts()));
+  BOOST_CHECK_EQUAL(0u, histogram.total());
+  BOOST_CHECK_EQUAL(0u, histogram.sum());
+}
+
+BOOST_AUTO_TEST_CASE(histogram_counts_samples_in_buckets_with_inclusive_upper_bounds) {
+  Histogram histogram{{10, 100}};
+
+  for (auto sample : {0, 10, 11, 100, 101, 1000})
+    histogram.add(sample);
+
+  BOOST_CHECK((std::vector<std::uint64_t>{2, 2, 2} == histogram.counts()));
+  BOOST_CHECK_EQUAL(6u, histogram.total());
+  BOOST_CHECK_EQUAL(1222u, histogram.sum());
+}
+
+BOOST_AUTO_TEST_CASE(histogram_without_bounds_counts_everything_in_the_overflow_bucket) {
+  Histogram histogram{{}};
+
+  histogram.add(0);
+  histogram.add(42);
+
+  BOOST_CHECK((std::vector<std::uint64_t>{2} == histogram.counts()));
+  BOOST_CHECK_EQUAL(42u, histogram.sum());
+}
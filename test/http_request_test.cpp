@@ -0,0 +1,188 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE http_request
+
+#include <airmap/logger.h>
+#include <airmap/net/http/boost/connection_pool.h>
+#include <airmap/net/http/boost/request.h>
+
+#include <boost/asio.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace asio = boost::asio;
+namespace http = boost::beast::http;
+
+namespace {
+
+using airmap::net::http::boost::Connection;
+using airmap::net::http::boost::ConnectionPool;
+using airmap::net::http::boost::Request;
+
+// Exchange scripts the outcome of a single request/response exchange.
+struct Exchange {
+  boost::system::error_code write;
+  boost::system::error_code read;
+};
+
+// ScriptedConnection plays back a fixed sequence of exchanges.
+class ScriptedConnection : public Connection {
+ public:
+  ScriptedConnection(const std::shared_ptr<asio::io_service>& io_service, std::vector<Exchange> exchanges)
+      : io_service_{io_service}, exchanges_{std::move(exchanges)} {
+  }
+
+  void async_connect(const asio::ip::tcp::endpoint&, const Handler& handler) override {
+    open_   = !connect;
+    auto ec = connect;
+    io_service_->post([handler, ec]() { handler(ec); });
+  }
+
+  void async_write(Request&, const Handler& handler) override {
+    writes++;
+    auto ec = exchanges_.at(next_).write;
+    io_service_->post([handler, ec]() { handler(ec); });
+  }
+
+  void async_read(Response& response, const Handler& handler) override {
+    auto ec = exchanges_.at(next_++).read;
+    if (!ec) {
+      response.result(http::status::ok);
+      response.keep_alive(true);
+    }
+    io_service_->post([handler, ec]() { handler(ec); });
+  }
+
+  void close() override {
+    open_ = false;
+  }
+
+  bool is_open() const override {
+    return open_;
+  }
+
+  boost::system::error_code connect;
+  std::size_t writes{0};
+
+ private:
+  std::shared_ptr<asio::io_service> io_service_;
+  std::vector<Exchange> exchanges_;
+  std::size_t next_{0};
+  bool open_{false};
+};
+
+struct Fixture {
+  // Sets up a pool whose first connection serves one exchange and then turns
+  // out to be stale with 'stale', and whose second connection serves one exchange.
+  void script(const Exchange& stale) {
+    connections.push_back(std::make_shared<ScriptedConnection>(io_service, std::vector<Exchange>{{}, stale}));
+    connections.push_back(std::make_shared<ScriptedConnection>(io_service, std::vector<Exchange>{{}}));
+  }
+
+  std::shared_ptr<ConnectionPool> make_pool() {
+    ConnectionPool::Configuration configuration;
+    configuration.max_connections = 1;
+    return ConnectionPool::create(configuration, io_service,
+                                  [this]() -> std::shared_ptr<Connection> { return connections.at(created++); });
+  }
+
+  Request::Result run(http::verb verb) {
+    Request::Configuration configuration;
+    configuration.connect_failed = [this]() { connect_failures++; };
+    configuration.logger   = airmap::create_null_logger();
+    configuration.pool     = pool;
+    configuration.priority = ConnectionPool::Priority::normal;
+    configuration.request  = http::request<http::string_body>{verb, "/", 11};
+
+    Request::Result result{airmap::Error{"not finished"}};
+    bool finished    = false;
+    configuration.cb = [&result, &finished](const Request::Result& r) {
+      result   = r;
+      finished = true;
+    };
+
+    // The pool's idle timer keeps the io_service busy, we only run until the request finished.
+    Request::create(configuration)->start();
+    io_service->reset();
+    while (!finished && io_service->run_one()) {
+    }
+    return result;
+  }
+
+  std::shared_ptr<asio::io_service> io_service{std::make_shared<asio::io_service>()};
+  std::vector<std::shared_ptr<ScriptedConnection>> connections;
+  std::size_t created{0};
+  std::size_t connect_failures{0};
+  std::shared_ptr<ConnectionPool> pool{make_pool()};
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(idempotent_request_is_retried_if_the_pooled_connection_breaks_after_writing, Fixture) {
+  script(Exchange{{}, asio::error::eof});
+
+  BOOST_REQUIRE(run(http::verb::get));
+  auto result = run(http::verb::get);
+
+  BOOST_CHECK(result);
+  BOOST_CHECK_EQUAL(2u, created);
+  BOOST_CHECK_EQUAL(2u, connections[0]->writes);
+  BOOST_CHECK_EQUAL(1u, connections[1]->writes);
+}
+
+BOOST_FIXTURE_TEST_CASE(non_idempotent_request_is_not_retried_once_written, Fixture) {
+  script(Exchange{{}, asio::error::eof});
+
+  BOOST_REQUIRE(run(http::verb::post));
+  auto result = run(http::verb::post);
+
+  BOOST_REQUIRE(!result);
+  BOOST_CHECK(airmap::net::http::request_sent(result.error()));
+  BOOST_CHECK_EQUAL(1u, created);
+  BOOST_CHECK_EQUAL(2u, connections[0]->writes);
+}
+
+BOOST_FIXTURE_TEST_CASE(non_idempotent_request_is_retried_if_writing_fails, Fixture) {
+  script(Exchange{asio::error::broken_pipe, {}});
+
+  BOOST_REQUIRE(run(http::verb::post));
+  auto result = run(http::verb::post);
+
+  BOOST_CHECK(result);
+  BOOST_CHECK_EQUAL(2u, created);
+  BOOST_CHECK_EQUAL(1u, connections[1]->writes);
+}
+
+BOOST_FIXTURE_TEST_CASE(failing_to_connect_is_reported_and_fails_the_request, Fixture) {
+  connections.push_back(std::make_shared<ScriptedConnection>(io_service, std::vector<Exchange>{}));
+  connections.back()->connect = asio::error::connection_refused;
+
+  auto result = run(http::verb::get);
+
+  BOOST_REQUIRE(!result);
+  BOOST_CHECK(!airmap::net::http::request_sent(result.error()));
+  BOOST_CHECK_EQUAL(1u, connect_failures);
+}
+
+BOOST_FIXTURE_TEST_CASE(failing_pooled_connections_are_not_reported_as_connect_failures, Fixture) {
+  script(Exchange{asio::error::broken_pipe, {}});
+
+  BOOST_REQUIRE(run(http::verb::get));
+  BOOST_REQUIRE(run(http::verb::get));
+
+  BOOST_CHECK_EQUAL(0u, connect_failures);
+}
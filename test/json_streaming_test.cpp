@@ -0,0 +1,102 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE json_streaming
+
+#include <airmap/codec/json/streaming.h>
+#include <airmap/jsend.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+using ArrayStreamer = airmap::codec::json::ArrayStreamer;
+
+namespace {
+
+// Collector records the elements handed to a sink, serialized.
+struct Collector {
+  ArrayStreamer::Sink sink() {
+    return [this](const nlohmann::json& element) { elements.push_back(element.dump()); };
+  }
+
+  std::vector<std::string> elements;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(streamer_hands_elements_of_a_top_level_array_to_the_sink) {
+  Collector collector;
+  ArrayStreamer streamer;
+  streamer.stream(ArrayStreamer::Path{}, collector.sink());
+
+  auto document = streamer.parse(R"_([1, "two", {"three": [3]}, [4]])_");
+
+  BOOST_CHECK(document.is_array());
+  BOOST_CHECK(document.empty());
+  BOOST_CHECK((std::vector<std::string>{"1", R"_("two")_", R"_({"three":[3]})_", "[4]"} == collector.elements));
+}
+
+BOOST_AUTO_TEST_CASE(streamer_follows_the_path_of_object_keys) {
+  Collector collector;
+  ArrayStreamer streamer;
+  streamer.stream(ArrayStreamer::Path{"data", "items"}, collector.sink());
+
+  auto document = streamer.parse(R"_({"items": [0], "data": {"other": [1], "items": [2, 3], "after": true}})_");
+
+  BOOST_CHECK((std::vector<std::string>{"2", "3"} == collector.elements));
+  BOOST_CHECK_EQUAL(R"_({"data":{"after":true,"items":[],"other":[1]},"items":[0]})_", document.dump());
+}
+
+BOOST_AUTO_TEST_CASE(streamer_does_not_stream_arrays_at_the_same_key_but_different_depth) {
+  Collector collector;
+  ArrayStreamer streamer;
+  streamer.stream(ArrayStreamer::Path{"items"}, collector.sink());
+
+  auto document = streamer.parse(R"_({"nested": {"items": [0]}, "items": [{"items": [1]}, 2]})_");
+
+  BOOST_CHECK((std::vector<std::string>{R"_({"items":[1]})_", "2"} == collector.elements));
+  BOOST_CHECK_EQUAL(R"_({"items":[],"nested":{"items":[0]}})_", document.dump());
+}
+
+BOOST_AUTO_TEST_CASE(streamer_tracks_paths_across_sibling_objects) {
+  Collector first;
+  Collector second;
+  ArrayStreamer streamer;
+  streamer.stream(ArrayStreamer::Path{"a", "list"}, first.sink());
+  streamer.stream(ArrayStreamer::Path{"b", "list"}, second.sink());
+
+  streamer.parse(R"_({"a": {"x": {"y": 1}, "list": [1]}, "b": {"list": [2, 3]}})_");
+
+  BOOST_CHECK((std::vector<std::string>{"1"} == first.elements));
+  BOOST_CHECK((std::vector<std::string>{"2", "3"} == second.elements));
+}
+
+BOOST_AUTO_TEST_CASE(streamer_can_parse_repeatedly) {
+  Collector collector;
+  ArrayStreamer streamer;
+  streamer.stream(ArrayStreamer::Path{"data"}, collector.sink());
+
+  BOOST_CHECK_THROW(streamer.parse(R"_({"data": [1, )_"), std::exception);
+  collector.elements.clear();
+  streamer.parse(R"_({"data": [2]})_");
+
+  BOOST_CHECK((std::vector<std::string>{"2"} == collector.elements));
+}
+
+BOOST_AUTO_TEST_CASE(jsend_decodes_values_without_streaming) {
+  auto result = airmap::jsend::parse_to_outcome<std::vector<int>>(R"_({"status": "success", "data": [1, 2, 3]})_");
+
+  BOOST_REQUIRE(result);
+  BOOST_CHECK((std::vector<int>{1, 2, 3} == result.value()));
+}
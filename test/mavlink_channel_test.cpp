@@ -0,0 +1,221 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE mavlink_channel
+
+#include <airmap/mavlink/channel.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+class ReplayChannel : public airmap::mavlink::Channel {
+ public:
+  using Channel::create_parser_pool;
+  using Channel::ParserPool;
+  using Channel::process_mavlink_data;
+
+ protected:
+  void start_impl() override {
+  }
+  void stop_impl() override {
+  }
+};
+
+std::string frame(std::uint8_t system_id, std::uint32_t time_boot_ms) {
+  mavlink_message_t msg;
+  mavlink_msg_global_position_int_pack(system_id, 1, &msg, time_boot_ms, 35 * 1E7, -78 * 1E7, 106 * 1E3, 220 * 1E3,
+                                       3 * 1E2, 4 * 1E2, 5 * 1E2, 180 * 1E2);
+
+  std::string buffer(MAVLINK_MAX_PACKET_LEN, 0);
+  buffer.resize(mavlink_msg_to_send_buffer(reinterpret_cast<std::uint8_t*>(&buffer[0]), &msg));
+  return buffer;
+}
+
+// A .tlog is a sequence of records, each one a big-endian 64-bit timestamp [us]
+// followed by a single MAVLink frame.
+std::string synthesize_tlog(std::size_t frames) {
+  std::string tlog;
+  for (std::size_t i = 0; i < frames; i++) {
+    std::uint64_t timestamp = i * 20000;
+    for (int shift = 56; shift >= 0; shift -= 8)
+      tlog.push_back(static_cast<char>((timestamp >> shift) & 0xff));
+    tlog += frame(1, static_cast<std::uint32_t>(i * 20));
+  }
+  return tlog;
+}
+
+// strip_timestamps extracts the raw MAVLink stream from 'tlog', counting the frames in 'frames'.
+std::string strip_timestamps(const std::string& tlog, std::size_t& frames) {
+  static constexpr std::size_t timestamp_size = 8;
+
+  std::string stream;
+  frames = 0;
+
+  for (std::size_t i = 0; i + timestamp_size + 2 <= tlog.size();) {
+    auto magic       = static_cast<std::uint8_t>(tlog[i + timestamp_size]);
+    auto payload_len = static_cast<std::uint8_t>(tlog[i + timestamp_size + 1]);
+    std::size_t size = 0;
+
+    if (magic == 0xfd) {
+      auto incompat_flags = static_cast<std::uint8_t>(tlog[i + timestamp_size + 2]);
+      size                = payload_len + 12 + ((incompat_flags & 0x01) ? 13 : 0);
+    } else if (magic == 0xfe) {
+      size = payload_len + 8;
+    } else {
+      break;
+    }
+
+    stream.append(tlog, i + timestamp_size, size);
+    frames++;
+    i += timestamp_size + size;
+  }
+
+  return stream;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(process_mavlink_data_dispatches_frames_split_across_reads) {
+  ReplayChannel channel;
+
+  std::vector<std::uint32_t> received;
+  channel.subscribe([&received](const mavlink_message_t& msg) {
+    received.push_back(mavlink_msg_global_position_int_get_time_boot_ms(&msg));
+  });
+
+  auto data = frame(1, 42) + frame(1, 43);
+  auto half = data.size() / 2 - 3;
+
+  BOOST_CHECK_EQUAL(0u, channel.process_mavlink_data(data.data(), data.data() + half));
+  BOOST_CHECK(received.empty());
+  BOOST_CHECK_EQUAL(2u, channel.process_mavlink_data(data.data() + half, data.data() + data.size()));
+  BOOST_REQUIRE_EQUAL(2u, received.size());
+  BOOST_CHECK_EQUAL(42u, received[0]);
+  BOOST_CHECK_EQUAL(43u, received[1]);
+  BOOST_CHECK_EQUAL(2u, channel.counters().good);
+}
+
+BOOST_AUTO_TEST_CASE(unsubscribed_subscribers_are_not_invoked) {
+  ReplayChannel channel;
+
+  std::size_t first = 0, second = 0;
+  auto subscription = channel.subscribe([&first](const mavlink_message_t&) { first++; });
+  channel.subscribe([&second](const mavlink_message_t&) { second++; });
+
+  auto data = frame(1, 1);
+  channel.process_mavlink_data(data.data(), data.data() + data.size());
+  channel.unsubscribe(std::move(subscription));
+  channel.process_mavlink_data(data.data(), data.data() + data.size());
+
+  BOOST_CHECK_EQUAL(1u, first);
+  BOOST_CHECK_EQUAL(2u, second);
+}
+
+BOOST_AUTO_TEST_CASE(interleaved_sources_are_framed_independently) {
+  ReplayChannel channel;
+  auto& pool = channel.create_parser_pool();
+
+  std::size_t dispatched = 0;
+  channel.subscribe([&dispatched](const mavlink_message_t&) { dispatched++; });
+
+  auto a = frame(1, 1);
+  auto b = frame(2, 2);
+
+  airmap::mavlink::Channel::Source sa{{1}, 0};
+  airmap::mavlink::Channel::Source sb{{2}, 0};
+  auto describe_a = []() { return std::string{"a"}; };
+  auto describe_b = []() { return std::string{"b"}; };
+
+  channel.process_mavlink_data(pool, sa, describe_a, a.data(), a.data() + 5);
+  channel.process_mavlink_data(pool, sb, describe_b, b.data(), b.data() + 7);
+  channel.process_mavlink_data(pool, sa, describe_a, a.data() + 5, a.data() + a.size());
+  channel.process_mavlink_data(pool, sb, describe_b, b.data() + 7, b.data() + b.size());
+
+  BOOST_CHECK_EQUAL(2u, dispatched);
+  BOOST_CHECK_EQUAL(0u, channel.counters().bad);
+
+  auto statistics = channel.source_statistics();
+  BOOST_REQUIRE_EQUAL(2u, statistics.size());
+  for (const auto& s : statistics) {
+    BOOST_CHECK_EQUAL(1u, s.good);
+    BOOST_CHECK_EQUAL(0u, s.bad);
+    BOOST_REQUIRE(s.system_id);
+    BOOST_CHECK_EQUAL(s.name == "a" ? 1 : 2, s.system_id.get());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sources_are_keyed_by_full_origin_and_channel) {
+  ReplayChannel channel;
+  auto& pool = channel.create_parser_pool();
+  auto describe = []() { return std::string{"source"}; };
+
+  // Origins only differing in their last byte, e.g., the port of two IPv6 senders.
+  airmap::mavlink::Channel::Source a;
+  a.origin.fill(0xab);
+  auto b         = a;
+  b.origin.back() ^= 1;
+  auto c         = a;
+  c.channel      = 1;
+
+  auto ia = pool.acquire(a, describe);
+  BOOST_CHECK_NE(ia, pool.acquire(b, describe));
+  BOOST_CHECK_NE(ia, pool.acquire(c, describe));
+  BOOST_CHECK_EQUAL(ia, pool.acquire(a, describe));
+  BOOST_CHECK_EQUAL(3u, channel.source_statistics().size());
+}
+
+// Replays the .tlog referenced by AIRMAP_MAVLINK_TLOG (or a synthetic one) through
+// a channel as fast as possible and reports the achieved message rate.
+BOOST_AUTO_TEST_CASE(replaying_a_tlog_dispatches_every_frame) {
+  std::string tlog;
+  if (auto path = std::getenv("AIRMAP_MAVLINK_TLOG")) {
+    std::ifstream in{path, std::ios::binary};
+    tlog.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+  } else {
+    tlog = synthesize_tlog(10000);
+  }
+
+  std::size_t frames = 0;
+  auto stream        = strip_timestamps(tlog, frames);
+
+  ReplayChannel channel;
+  std::size_t dispatched = 0;
+  channel.subscribe([&dispatched](const mavlink_message_t&) { dispatched++; });
+
+  static constexpr std::size_t read_size = 1024;
+  static constexpr std::size_t rounds    = 10;
+
+  auto before = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < rounds; round++) {
+    for (std::size_t offset = 0; offset < stream.size(); offset += read_size) {
+      auto end = std::min(stream.size(), offset + read_size);
+      channel.process_mavlink_data(stream.data() + offset, stream.data() + end);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before);
+
+  BOOST_CHECK_EQUAL(rounds * frames, dispatched);
+  BOOST_CHECK_EQUAL(0u, channel.counters().bad);
+  BOOST_TEST_MESSAGE("replayed " << dispatched << " messages in " << elapsed.count() << " [us]: "
+                                 << (elapsed.count() ? dispatched * 1000000 / elapsed.count() : 0)
+                                 << " [msgs/s]");
+}
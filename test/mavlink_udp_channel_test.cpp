@@ -0,0 +1,211 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE mavlink_udp_channel
+
+#include <airmap/mavlink/boost/udp_channel.h>
+
+#include <boost/asio.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ip = boost::asio::ip;
+
+namespace {
+
+using UdpChannel = airmap::mavlink::boost::UdpChannel;
+
+std::string heartbeat(std::uint8_t system_id, std::uint32_t custom_mode) {
+  mavlink_message_t msg;
+  mavlink_msg_heartbeat_pack(system_id, 1, &msg, 0, 0, 0, custom_mode, 0);
+
+  std::string buffer(MAVLINK_MAX_PACKET_LEN, 0);
+  buffer.resize(mavlink_msg_to_send_buffer(reinterpret_cast<std::uint8_t*>(&buffer[0]), &msg));
+  return buffer;
+}
+
+// Fixture runs an io_service on a background thread and hands out a free local UDP port.
+struct Fixture {
+  Fixture() : io_service{std::make_shared<boost::asio::io_service>()}, work{*io_service} {
+    ip::udp::socket probe{*io_service, ip::udp::endpoint{ip::address_v4::loopback(), 0}};
+    port = probe.local_endpoint().port();
+    worker = std::thread{[this]() { io_service->run(); }};
+  }
+
+  ~Fixture() {
+    io_service->stop();
+    worker.join();
+  }
+
+  std::shared_ptr<UdpChannel> make_channel(std::size_t shards) {
+    UdpChannel::Configuration configuration;
+    configuration.shards = shards;
+    return std::make_shared<UdpChannel>(airmap::create_null_logger(), io_service, port, configuration);
+  }
+
+  void send(ip::udp::socket& socket, const std::string& data) {
+    socket.send_to(boost::asio::buffer(data), ip::udp::endpoint{ip::address_v4::loopback(), port});
+  }
+
+  bool wait_for(std::size_t count, std::chrono::milliseconds timeout = std::chrono::seconds{5}) {
+    std::unique_lock<std::mutex> ul{guard};
+    return cv.wait_for(ul, timeout, [this, count]() { return received.size() >= count; });
+  }
+
+  std::shared_ptr<boost::asio::io_service> io_service;
+  boost::asio::io_service::work work;
+  std::uint16_t port{0};
+  std::thread worker;
+
+  std::mutex guard;
+  std::condition_variable cv;
+  std::multiset<std::uint32_t> received;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(datagrams_are_dispatched_to_subscribers, Fixture) {
+  auto channel = make_channel(1);
+  channel->subscribe([this](const mavlink_message_t& msg) {
+    std::lock_guard<std::mutex> lg{guard};
+    received.insert(mavlink_msg_heartbeat_get_custom_mode(&msg));
+    cv.notify_all();
+  });
+  channel->start();
+
+  ip::udp::socket sender{*io_service, ip::udp::v4()};
+  send(sender, heartbeat(1, 1) + heartbeat(1, 2));
+  send(sender, heartbeat(1, 3));
+
+  BOOST_REQUIRE(wait_for(3));
+  BOOST_CHECK((std::multiset<std::uint32_t>{1, 2, 3}) == received);
+
+  channel->stop();
+}
+
+// With a single datagram per batch and a single batch per wakeup, a burst is only
+// drained completely if the channel keeps re-arming its wait.
+BOOST_FIXTURE_TEST_CASE(bursts_are_drained_across_wakeups, Fixture) {
+  static constexpr std::size_t datagrams = 16;
+
+  UdpChannel::Configuration configuration;
+  configuration.batch_size  = 1;
+  configuration.max_batches = 1;
+  auto channel = std::make_shared<UdpChannel>(airmap::create_null_logger(), io_service, port, configuration);
+  channel->subscribe([this](const mavlink_message_t& msg) {
+    std::lock_guard<std::mutex> lg{guard};
+    received.insert(mavlink_msg_heartbeat_get_custom_mode(&msg));
+    cv.notify_all();
+  });
+  channel->start();
+
+  ip::udp::socket sender{*io_service, ip::udp::v4()};
+  for (std::size_t i = 0; i < datagrams; i++)
+    send(sender, heartbeat(1, static_cast<std::uint32_t>(i)));
+
+  BOOST_REQUIRE(wait_for(datagrams));
+  BOOST_CHECK_EQUAL(datagrams, received.size());
+
+  channel->stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(sharded_channel_dispatches_datagrams_from_all_senders, Fixture) {
+  static constexpr std::size_t senders = 16;
+
+  auto channel = make_channel(4);
+  channel->subscribe([this](const mavlink_message_t& msg) {
+    std::lock_guard<std::mutex> lg{guard};
+    received.insert(mavlink_msg_heartbeat_get_custom_mode(&msg));
+    cv.notify_all();
+  });
+  channel->start();
+
+  std::vector<std::unique_ptr<ip::udp::socket>> sockets;
+  for (std::size_t i = 0; i < senders; i++) {
+    sockets.emplace_back(new ip::udp::socket{*io_service, ip::udp::v4()});
+    send(*sockets.back(), heartbeat(static_cast<std::uint8_t>(i + 1), static_cast<std::uint32_t>(i)));
+  }
+
+  BOOST_REQUIRE(wait_for(senders));
+
+  auto statistics = channel->source_statistics();
+  BOOST_CHECK_EQUAL(senders, statistics.size());
+  for (const auto& s : statistics)
+    BOOST_CHECK_EQUAL(0u, s.source.channel);
+
+  channel->stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(stopped_channel_does_not_dispatch, Fixture) {
+  auto channel = make_channel(2);
+  channel->subscribe([this](const mavlink_message_t& msg) {
+    std::lock_guard<std::mutex> lg{guard};
+    received.insert(mavlink_msg_heartbeat_get_custom_mode(&msg));
+    cv.notify_all();
+  });
+  channel->start();
+  channel->stop();
+
+  ip::udp::socket sender{*io_service, ip::udp::v4()};
+  send(sender, heartbeat(1, 1));
+
+  BOOST_CHECK(!wait_for(1, std::chrono::milliseconds{200}));
+}
+
+// A subscriber running on a worker releases the last reference to the channel. The
+// channel must neither join the worker from itself nor leave it running.
+BOOST_FIXTURE_TEST_CASE(releasing_the_last_reference_on_a_worker_shuts_it_down, Fixture) {
+  auto channel = make_channel(2);
+  auto io_thread = worker.get_id();
+
+  std::mutex released_guard;
+  std::condition_variable released_cv;
+  bool released = false;
+  std::thread::id released_on;
+
+  channel->subscribe([&, io_thread](const mavlink_message_t&) {
+    std::shared_ptr<UdpChannel> last;
+    {
+      std::lock_guard<std::mutex> lg{released_guard};
+      if (std::this_thread::get_id() == io_thread || !channel)
+        return;
+      last = std::move(channel);
+    }
+    last->stop();
+    std::lock_guard<std::mutex> lg{released_guard};
+    released_on = std::this_thread::get_id();
+    released    = true;
+    released_cv.notify_all();
+  });
+  channel->start();
+
+  // The kernel distributes senders across shards, some of them end up on the worker.
+  std::vector<std::unique_ptr<ip::udp::socket>> sockets;
+  for (std::size_t i = 0; i < 64; i++) {
+    sockets.emplace_back(new ip::udp::socket{*io_service, ip::udp::v4()});
+    send(*sockets.back(), heartbeat(1, 1));
+  }
+
+  std::unique_lock<std::mutex> ul{released_guard};
+  BOOST_REQUIRE(released_cv.wait_for(ul, std::chrono::seconds{5}, [&released]() { return released; }));
+  BOOST_CHECK(released_on != io_thread);
+  BOOST_CHECK(!channel);
+}
@@ -0,0 +1,38 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef MOCK_HTTP_REQUESTER_H_
+#define MOCK_HTTP_REQUESTER_H_
+
+#include <airmap/net/http/requester.h>
+
+#include <trompeloeil/trompeloeil.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace mock {
+
+using trompeloeil::_;
+
+struct HttpRequester : public airmap::net::http::Requester {
+  using StringMap = std::unordered_map<std::string, std::string>;
+
+  MAKE_MOCK4(delete_, void(const std::string&, StringMap&&, StringMap&&, Callback), override);
+  MAKE_MOCK4(get, void(const std::string&, StringMap&&, StringMap&&, Callback), override);
+  MAKE_MOCK4(patch, void(const std::string&, StringMap&&, const std::string&, Callback), override);
+  MAKE_MOCK4(post, void(const std::string&, StringMap&&, const std::string&, Callback), override);
+};
+
+}  // namespace mock
+
+#endif  // MOCK_HTTP_REQUESTER_H_
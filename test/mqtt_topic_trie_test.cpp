@@ -0,0 +1,110 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE mqtt_topic_trie
+
+#include <airmap/net/mqtt/topic_trie.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+using TopicTrie = airmap::net::mqtt::TopicTrie<std::string>;
+
+std::vector<std::string> match(const TopicTrie& trie, const std::string& topic) {
+  std::vector<std::string> result;
+  trie.match(topic, [&result](const std::string& value) { result.push_back(value); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(topic_trie_matches_exact_filters) {
+  TopicTrie trie;
+  trie.insert("uav/traffic/sa/flight|1", 0, "sa");
+  trie.insert("uav/traffic/alert/flight|1", 1, "alert");
+
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1") == std::vector<std::string>{"sa"});
+  BOOST_CHECK(match(trie, "uav/traffic/alert/flight|1") == std::vector<std::string>{"alert"});
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|2").empty());
+  BOOST_CHECK(match(trie, "uav/traffic/sa").empty());
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_matches_single_level_wildcards) {
+  TopicTrie trie;
+  trie.insert("uav/traffic/+/+", 0, "fleet");
+
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1") == std::vector<std::string>{"fleet"});
+  BOOST_CHECK(match(trie, "uav/traffic/alert/flight|2") == std::vector<std::string>{"fleet"});
+  BOOST_CHECK(match(trie, "uav/traffic/sa").empty());
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1/more").empty());
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_matches_multi_level_wildcards_including_parent) {
+  TopicTrie trie;
+  trie.insert("uav/#", 0, "uav");
+  trie.insert("#", 1, "all");
+
+  BOOST_CHECK(match(trie, "uav") == (std::vector<std::string>{"all", "uav"}));
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1") == (std::vector<std::string>{"all", "uav"}));
+  BOOST_CHECK(match(trie, "mav/telemetry") == std::vector<std::string>{"all"});
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_wildcards_do_not_match_system_topics) {
+  TopicTrie trie;
+  trie.insert("#", 0, "all");
+  trie.insert("+/broker", 1, "plus");
+  trie.insert("$SYS/#", 2, "sys");
+
+  BOOST_CHECK(match(trie, "$SYS/broker") == std::vector<std::string>{"sys"});
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_dispatches_to_all_values_of_a_filter) {
+  TopicTrie trie;
+  trie.insert("uav/traffic/sa/flight|1", 0, "a");
+  trie.insert("uav/traffic/sa/flight|1", 1, "b");
+  trie.insert("uav/traffic/+/flight|1", 2, "c");
+
+  BOOST_CHECK_EQUAL(trie.count("uav/traffic/sa/flight|1"), 2);
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1") == (std::vector<std::string>{"a", "b", "c"}));
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_erase_prunes_empty_nodes) {
+  TopicTrie trie;
+  trie.insert("uav/traffic/sa/flight|1", 0, "a");
+  trie.insert("uav/traffic/+/+", 1, "b");
+
+  BOOST_CHECK(trie.erase("uav/traffic/sa/flight|1", 0));
+  BOOST_CHECK(!trie.erase("uav/traffic/sa/flight|1", 0));
+  BOOST_CHECK_EQUAL(trie.count("uav/traffic/sa/flight|1"), 0);
+  BOOST_CHECK(match(trie, "uav/traffic/sa/flight|1") == std::vector<std::string>{"b"});
+
+  BOOST_CHECK(trie.erase("uav/traffic/+/+", 1));
+  BOOST_CHECK(trie.empty());
+}
+
+BOOST_AUTO_TEST_CASE(topic_trie_validates_filters) {
+  BOOST_CHECK(TopicTrie::is_valid_filter("uav/traffic/sa/flight|1"));
+  BOOST_CHECK(TopicTrie::is_valid_filter("uav/traffic/+/+"));
+  BOOST_CHECK(TopicTrie::is_valid_filter("uav/#"));
+  BOOST_CHECK(TopicTrie::is_valid_filter("#"));
+
+  BOOST_CHECK(!TopicTrie::is_valid_filter(""));
+  BOOST_CHECK(!TopicTrie::is_valid_filter("uav/#/sa"));
+  BOOST_CHECK(!TopicTrie::is_valid_filter("uav/traffic+"));
+  BOOST_CHECK(!TopicTrie::is_valid_filter("uav/tr#"));
+}
@@ -0,0 +1,133 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE query
+
+#include <airmap/net/http/query.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+using Query = std::unordered_map<std::string, std::string>;
+
+// The encoder append_query replaced, kept verbatim as the reference append_query has to match.
+namespace reference {
+
+template <typename CharT>
+inline CharT hex_to_letter(CharT in) {
+  if ((in >= 0) && (in < 10)) {
+    return in + '0';
+  }
+
+  if ((in >= 10) && (in < 16)) {
+    return in - 10 + 'A';
+  }
+
+  return in;
+}
+
+template <class charT, class OutputIterator>
+void encode_char(charT in, OutputIterator& out, const char* ignore = "") {
+  if (((in >= 'a') && (in <= 'z')) || ((in >= 'A') && (in <= 'Z')) || ((in >= '0') && (in <= '9')) || (in == '-') ||
+      (in == '.') || (in == '_') || (in == '~')) {
+    out++ = in;
+  } else {
+    auto first = ignore, last = ignore + std::strlen(ignore);
+    if (std::find(first, last, in) != last) {
+      out++ = in;
+    } else {
+      out++ = '%';
+      out++ = hex_to_letter((in >> 4) & 0x0f);
+      out++ = hex_to_letter(in & 0x0f);
+    }
+  }
+}
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator encode_query(InputIterator first, InputIterator last, OutputIterator out) {
+  auto it = first;
+  while (it != last) {
+    encode_char(*it, out, "/.@&%;=");
+    ++it;
+  }
+  return out;
+}
+
+std::string encode_query(const Query& q) {
+  std::stringstream ss;
+
+  for (auto it = q.begin(); it != q.end(); ++it) {
+    if (it != q.begin())
+      ss << "&";
+
+    auto p = it->first + "=" + it->second;
+    encode_query(p.begin(), p.end(), std::ostream_iterator<char>(ss));
+  }
+
+  return ss.str();
+}
+
+}  // namespace reference
+
+std::string encode(const Query& query, const std::string& prefix = std::string{}) {
+  auto out = prefix;
+  airmap::net::http::append_query(query, out);
+  return out;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(empty_queries_append_nothing) {
+  BOOST_CHECK_EQUAL("/status?", encode(Query{}, "/status?"));
+}
+
+BOOST_AUTO_TEST_CASE(unreserved_and_api_characters_are_sent_as_is) {
+  BOOST_CHECK_EQUAL("/status?geometry=POINT%281%202%29", encode(Query{{"geometry", "POINT(1 2)"}}, "/status?"));
+  BOOST_CHECK_EQUAL("a-._~/@&%;=b=c", encode(Query{{"a-._~/@&%;=b", "c"}}));
+  BOOST_CHECK_EQUAL("key=%20%2B%3F%23%2C%C3%A4", encode(Query{{"key", " +?#,\xc3\xa4"}}));
+}
+
+BOOST_AUTO_TEST_CASE(every_byte_is_encoded_like_the_reference_encoder) {
+  for (int c = 0; c < 256; c++) {
+    Query query{{std::string(1, static_cast<char>(c)), std::string(2, static_cast<char>(c))}};
+    BOOST_CHECK_EQUAL(reference::encode_query(query), encode(query));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_queries_are_encoded_like_the_reference_encoder) {
+  std::mt19937 random{42};
+  std::uniform_int_distribution<int> byte{0, 255};
+  std::uniform_int_distribution<std::size_t> length{0, 16};
+
+  auto make_string = [&]() {
+    std::string s(length(random), '\0');
+    std::generate(s.begin(), s.end(), [&]() { return static_cast<char>(byte(random)); });
+    return s;
+  };
+
+  for (int i = 0; i < 1000; i++) {
+    Query query;
+    for (std::size_t n = length(random) / 4; n > 0; n--)
+      query.emplace(make_string(), make_string());
+
+    BOOST_CHECK_EQUAL(reference::encode_query(query), encode(query));
+  }
+}
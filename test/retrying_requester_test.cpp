@@ -0,0 +1,258 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE retrying_requester
+
+#include <airmap/net/http/retrying_requester.h>
+
+#include <mock/http_requester.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using airmap::net::http::Requester;
+using airmap::net::http::Response;
+using airmap::net::http::RetryingRequester;
+using StringMap = mock::HttpRequester::StringMap;
+
+Response make_response(unsigned int status, const StringMap& headers = StringMap{}) {
+  return Response{11, status, headers, std::string{}, 0, 0};
+}
+
+airmap::Error make_error(bool sent) {
+  return airmap::Error{"failed"}.value(airmap::Error::Value{std::string{airmap::net::http::request_sent_key}},
+                                       airmap::Error::Value{sent});
+}
+
+// ManualContext records scheduled tasks and their delays, running them on request only.
+struct ManualContext : public airmap::Context {
+  void create_client_with_configuration(const airmap::Client::Configuration&, const ClientCreateCallback&) override {
+  }
+
+  void create_monitor_client_with_configuration(const airmap::monitor::Client::Configuration&,
+                                                const MonitorClientCreateCallback&) override {
+  }
+
+  ReturnCode exec(const SignalSet&, const SignalHandler&) override {
+    return ReturnCode::success;
+  }
+
+  ReturnCode run() override {
+    return ReturnCode::success;
+  }
+
+  void stop(ReturnCode) override {
+  }
+
+  void schedule_in(const std::function<void()>& functor, const airmap::Microseconds& wait_for) override {
+    tasks.emplace_back(functor, wait_for);
+  }
+
+  void schedule_out(const std::function<void()>& task) override {
+    task();
+  }
+
+  // run_next runs the oldest scheduled task.
+  void run_next() {
+    BOOST_REQUIRE(!tasks.empty());
+    auto task = tasks.front().first;
+    tasks.pop_front();
+    task();
+  }
+
+  std::deque<std::pair<std::function<void()>, airmap::Microseconds>> tasks;
+};
+
+// Fixture wires up a RetryingRequester with a mocked requester, recording the callbacks of pending requests.
+struct Fixture {
+  std::shared_ptr<RetryingRequester> make_requester() {
+    return RetryingRequester::create(configuration, context, next);
+  }
+
+  // get issues a get request and records its results in 'results'.
+  void get() {
+    requester->get("/status", StringMap{}, StringMap{},
+                   [this](const Requester::Result& result) { results.push_back(result); });
+  }
+
+  // post issues a post request and records its results in 'results'.
+  void post() {
+    requester->post("/flights", StringMap{}, "{}",
+                    [this](const Requester::Result& result) { results.push_back(result); });
+  }
+
+  // complete completes the pending request at 'index' with 'result'.
+  void complete(const Requester::Result& result, std::size_t index = 0) {
+    BOOST_REQUIRE(index < pending.size());
+    auto cb = pending[index];
+    pending.erase(pending.begin() + index);
+    cb(result);
+  }
+
+  RetryingRequester::Configuration configuration;
+  std::shared_ptr<ManualContext> context{std::make_shared<ManualContext>()};
+  std::shared_ptr<mock::HttpRequester> next{std::make_shared<mock::HttpRequester>()};
+  std::vector<Requester::Callback> pending;
+  std::vector<Requester::Result> results;
+  std::unique_ptr<trompeloeil::expectation> gets{
+      NAMED_ALLOW_CALL(*next, get(mock::_, mock::_, mock::_, mock::_)).LR_SIDE_EFFECT(pending.push_back(_4))};
+  std::unique_ptr<trompeloeil::expectation> posts{
+      NAMED_ALLOW_CALL(*next, post(mock::_, mock::_, mock::_, mock::_)).LR_SIDE_EFFECT(pending.push_back(_4))};
+  std::shared_ptr<RetryingRequester> requester{make_requester()};
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(failed_requests_are_retried_with_growing_backoff, Fixture) {
+  get();
+  complete(Requester::Result{make_error(true)});
+
+  BOOST_CHECK(results.empty());
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  BOOST_CHECK(context->tasks.front().second.total_microseconds() <= 200000);
+  context->run_next();
+
+  complete(Requester::Result{make_response(503)});
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  BOOST_CHECK(context->tasks.front().second.total_microseconds() <= 400000);
+  context->run_next();
+
+  complete(Requester::Result{make_response(200)});
+  BOOST_REQUIRE_EQUAL(1u, results.size());
+  BOOST_REQUIRE(results.front());
+  BOOST_CHECK_EQUAL(200u, results.front().value().status);
+}
+
+BOOST_FIXTURE_TEST_CASE(retry_after_raises_the_backoff_up_to_its_limit, Fixture) {
+  get();
+  complete(Requester::Result{make_response(429, StringMap{{"retry-after", "0"}})});
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  BOOST_CHECK(context->tasks.front().second.total_microseconds() <= 200000);
+  context->run_next();
+
+  complete(Requester::Result{make_response(429, StringMap{{"retry-after", "60"}})});
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  BOOST_CHECK_EQUAL(10000000, context->tasks.front().second.total_microseconds());
+}
+
+BOOST_FIXTURE_TEST_CASE(the_last_failure_is_reported_after_max_attempts, Fixture) {
+  get();
+  for (std::uint32_t i = 1; i < configuration.max_attempts; i++) {
+    complete(Requester::Result{make_response(502)});
+    context->run_next();
+  }
+
+  complete(Requester::Result{make_response(504)});
+  BOOST_CHECK(context->tasks.empty());
+  BOOST_REQUIRE_EQUAL(1u, results.size());
+  BOOST_REQUIRE(results.front());
+  BOOST_CHECK_EQUAL(504u, results.front().value().status);
+}
+
+BOOST_FIXTURE_TEST_CASE(non_idempotent_requests_are_only_retried_if_never_sent, Fixture) {
+  post();
+  complete(Requester::Result{make_error(false)});
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  context->run_next();
+
+  complete(Requester::Result{make_error(true)});
+  BOOST_CHECK(context->tasks.empty());
+  BOOST_REQUIRE_EQUAL(1u, results.size());
+  BOOST_CHECK(!results.front());
+
+  post();
+  complete(Requester::Result{make_response(503)});
+  BOOST_CHECK(context->tasks.empty());
+  BOOST_CHECK_EQUAL(2u, results.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(retries_stop_once_the_budget_is_exhausted, Fixture) {
+  configuration.budget_ratio    = 0.5;
+  configuration.budget_capacity = 1.;
+  requester                     = make_requester();
+
+  // The budget starts out full, the first retry drains it.
+  get();
+  complete(Requester::Result{make_response(503)});
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  context->run_next();
+  complete(Requester::Result{make_response(200)});
+
+  // A single request only earns half a retry.
+  get();
+  complete(Requester::Result{make_response(503)});
+  BOOST_CHECK(context->tasks.empty());
+  BOOST_REQUIRE_EQUAL(2u, results.size());
+  BOOST_CHECK_EQUAL(503u, results.back().value().status);
+
+  // Another request tops up the budget to a full retry.
+  get();
+  complete(Requester::Result{make_response(503)});
+  BOOST_CHECK_EQUAL(1u, context->tasks.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(slow_get_requests_are_hedged_and_the_first_success_wins, Fixture) {
+  configuration.hedge             = true;
+  configuration.hedge_min_samples = 1;
+  requester                       = make_requester();
+
+  // No latencies observed yet, no hedge.
+  get();
+  BOOST_CHECK(context->tasks.empty());
+  std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  complete(Requester::Result{make_response(200)});
+
+  get();
+  BOOST_REQUIRE_EQUAL(1u, context->tasks.size());
+  BOOST_CHECK(context->tasks.front().second.total_microseconds() > 0);
+  context->run_next();
+  BOOST_REQUIRE_EQUAL(2u, pending.size());
+
+  complete(Requester::Result{make_response(200)}, 1);
+  BOOST_REQUIRE_EQUAL(2u, results.size());
+
+  complete(Requester::Result{make_response(503)});
+  BOOST_CHECK_EQUAL(2u, results.size());
+  BOOST_CHECK(context->tasks.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(failures_wait_for_a_hedge_in_flight, Fixture) {
+  configuration.hedge             = true;
+  configuration.hedge_min_samples = 1;
+  requester                       = make_requester();
+
+  get();
+  std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  complete(Requester::Result{make_response(200)});
+
+  get();
+  context->run_next();
+  BOOST_REQUIRE_EQUAL(2u, pending.size());
+
+  complete(Requester::Result{make_response(500)});
+  BOOST_CHECK_EQUAL(1u, results.size());
+
+  complete(Requester::Result{make_response(200)});
+  BOOST_REQUIRE_EQUAL(2u, results.size());
+  BOOST_REQUIRE(results.back());
+  BOOST_CHECK_EQUAL(200u, results.back().value().status);
+}
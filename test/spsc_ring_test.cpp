@@ -0,0 +1,98 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE spsc_ring
+
+#include <airmap/util/spsc_ring.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using Ring = airmap::util::SpscRing<std::uint64_t>;
+
+BOOST_AUTO_TEST_CASE(capacity_is_rounded_up_to_a_power_of_two) {
+  Ring ring{5};
+
+  for (std::uint64_t i = 0; i < 8; i++)
+    BOOST_CHECK(ring.try_push(i));
+  BOOST_CHECK(!ring.try_push(8));
+}
+
+BOOST_AUTO_TEST_CASE(elements_are_consumed_in_fifo_order_and_in_batches) {
+  Ring ring{8};
+  BOOST_CHECK(ring.empty());
+
+  for (std::uint64_t i = 0; i < 5; i++)
+    ring.try_push(i);
+  BOOST_CHECK(!ring.empty());
+
+  std::vector<std::uint64_t> consumed;
+  auto append = [&consumed](std::uint64_t value) { consumed.push_back(value); };
+
+  BOOST_CHECK_EQUAL(3u, ring.consume(append, 3));
+  BOOST_CHECK_EQUAL(2u, ring.consume(append, 3));
+  BOOST_CHECK_EQUAL(0u, ring.consume(append, 3));
+  BOOST_CHECK(ring.empty());
+  BOOST_CHECK((std::vector<std::uint64_t>{0, 1, 2, 3, 4}) == consumed);
+}
+
+BOOST_AUTO_TEST_CASE(consuming_frees_room_for_wrapping_pushes) {
+  Ring ring{4};
+  std::vector<std::uint64_t> consumed;
+  auto append = [&consumed](std::uint64_t value) { consumed.push_back(value); };
+
+  for (std::uint64_t i = 0; i < 4; i++)
+    ring.try_push(i);
+  BOOST_CHECK(!ring.try_push(4));
+
+  ring.consume(append, 2);
+  BOOST_CHECK(ring.try_push(4));
+  BOOST_CHECK(ring.try_push(5));
+  BOOST_CHECK(!ring.try_push(6));
+
+  ring.consume(append, 8);
+  BOOST_CHECK((std::vector<std::uint64_t>{0, 1, 2, 3, 4, 5}) == consumed);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_producer_and_consumer_transfer_every_element_in_order) {
+  static constexpr std::uint64_t count = 100000;
+
+  Ring ring{64};
+  std::thread producer{[&ring]() {
+    for (std::uint64_t i = 0; i < count;) {
+      if (ring.try_push(i))
+        i++;
+      else
+        std::this_thread::yield();
+    }
+  }};
+
+  std::uint64_t expected = 0;
+  bool in_order          = true;
+  while (expected < count) {
+    auto consumed = ring.consume(
+        [&](std::uint64_t value) {
+          in_order = in_order && value == expected;
+          expected++;
+        },
+        16);
+    if (consumed == 0)
+      std::this_thread::yield();
+  }
+
+  producer.join();
+  BOOST_CHECK(in_order);
+  BOOST_CHECK(ring.empty());
+}
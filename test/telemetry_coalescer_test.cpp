@@ -0,0 +1,166 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE telemetry_coalescer
+
+#include <airmap/monitor/telemetry_coalescer.h>
+#include <airmap/rest/telemetry.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ManualContext collects scheduled tasks, leaving it to the test to run them.
+class ManualContext : public airmap::Context {
+ public:
+  void create_client_with_configuration(const airmap::Client::Configuration&, const ClientCreateCallback&) override {
+  }
+
+  void create_monitor_client_with_configuration(const airmap::monitor::Client::Configuration&,
+                                                const MonitorClientCreateCallback&) override {
+  }
+
+  ReturnCode exec(const SignalSet&, const SignalHandler&) override {
+    return ReturnCode::success;
+  }
+
+  ReturnCode run() override {
+    return ReturnCode::success;
+  }
+
+  void stop(ReturnCode) override {
+  }
+
+  void schedule_in(const std::function<void()>& functor, const airmap::Microseconds&) override {
+    tasks.push_back(functor);
+  }
+
+  void schedule_out(const std::function<void()>& task) override {
+    task();
+  }
+
+  void run_tasks() {
+    auto pending = std::move(tasks);
+    tasks.clear();
+    for (const auto& task : pending)
+      task();
+  }
+
+  std::vector<std::function<void()>> tasks;
+};
+
+using Coalescer = airmap::monitor::TelemetryCoalescer;
+using Update    = airmap::Telemetry::Update;
+
+Update make_position(std::uint64_t timestamp) {
+  return Update{airmap::Telemetry::Position{timestamp, 47.1, 8.2, 400., 100., 2.}};
+}
+
+std::size_t payload_size(const std::vector<Update>& batch) {
+  return std::accumulate(batch.begin(), batch.end(), std::size_t{0}, [](std::size_t size, const Update& update) {
+    return size + airmap::rest::detail::PacketBuilder::encoded_size(update);
+  });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(encoded_size_matches_the_packet_builder) {
+  airmap::rest::detail::PacketBuilder builder{"flight|1234"};
+  const Update updates[] = {make_position(42), Update{airmap::Telemetry::Speed{42, 1.f, 2.f, 3.f}},
+                            Update{airmap::Telemetry::Attitude{42, 1.f, 2.f, 3.f}},
+                            Update{airmap::Telemetry::Barometer{42, 101325.f}}};
+
+  std::size_t size{0};
+  for (const auto& update : updates) {
+    builder.add(update);
+    size += airmap::rest::detail::PacketBuilder::encoded_size(update);
+    BOOST_CHECK_EQUAL(builder.payload().size(), size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(coalescer_flushes_before_a_batch_exceeds_the_payload_size) {
+  auto context = std::make_shared<ManualContext>();
+  std::vector<std::vector<Update>> batches;
+
+  Coalescer::Configuration configuration;
+  configuration.max_payload_size = 3 * airmap::rest::detail::PacketBuilder::encoded_size(make_position(42));
+
+  auto coalescer =
+      Coalescer::create(configuration, context, [&batches](const std::vector<Update>& batch) { batches.push_back(batch); });
+
+  for (std::uint64_t i = 0; i < 7; i++)
+    coalescer->add(make_position(42 + i));
+
+  BOOST_REQUIRE_EQUAL(batches.size(), 2u);
+  BOOST_CHECK_EQUAL(batches[0].size(), 3u);
+  BOOST_CHECK_EQUAL(batches[1].size(), 3u);
+  BOOST_CHECK_EQUAL(batches[1].front().position().timestamp, 45u);
+
+  coalescer->flush();
+  BOOST_REQUIRE_EQUAL(batches.size(), 3u);
+  BOOST_CHECK_EQUAL(batches[2].size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(coalescer_keeps_default_packets_within_the_minimum_ipv6_mtu) {
+  // The minimum IPv6 MTU minus IPv6 and UDP headers.
+  constexpr std::size_t max_datagram_size{1280 - 40 - 8};
+  const std::string flight_id(150, 'f');
+
+  auto context = std::make_shared<ManualContext>();
+  std::vector<std::vector<Update>> batches;
+  auto coalescer = Coalescer::create(Coalescer::Configuration{}, context,
+                                     [&batches](const std::vector<Update>& batch) { batches.push_back(batch); });
+
+  for (std::uint64_t i = 0; i < 500; i++) {
+    coalescer->add(make_position(i));
+    coalescer->add(Update{airmap::Telemetry::Speed{i, 1.f, 2.f, 3.f}});
+    coalescer->add(Update{airmap::Telemetry::Barometer{i, 101325.f}});
+  }
+
+  BOOST_REQUIRE(!batches.empty());
+  for (const auto& batch : batches) {
+    BOOST_CHECK(payload_size(batch) <= Coalescer::Configuration{}.max_payload_size);
+    BOOST_CHECK(airmap::rest::detail::PacketBuilder::packet_size(flight_id.size(), payload_size(batch)) <=
+                max_datagram_size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(coalescer_flushes_after_the_flush_interval) {
+  auto context = std::make_shared<ManualContext>();
+  std::vector<std::vector<Update>> batches;
+  auto coalescer = Coalescer::create(Coalescer::Configuration{}, context,
+                                     [&batches](const std::vector<Update>& batch) { batches.push_back(batch); });
+
+  coalescer->add(make_position(1));
+  coalescer->add(make_position(2));
+  BOOST_REQUIRE_EQUAL(context->tasks.size(), 1u);
+
+  context->run_tasks();
+  BOOST_REQUIRE_EQUAL(batches.size(), 1u);
+  BOOST_CHECK_EQUAL(batches[0].size(), 2u);
+
+  // A timer armed for a batch that was flushed explicitly does not flush the next one.
+  coalescer->add(make_position(3));
+  coalescer->flush();
+  coalescer->add(make_position(4));
+  BOOST_REQUIRE_EQUAL(context->tasks.size(), 2u);
+
+  auto stale = context->tasks.front();
+  stale();
+  BOOST_CHECK_EQUAL(batches.size(), 2u);
+}
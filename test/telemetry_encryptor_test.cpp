@@ -0,0 +1,147 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE telemetry_encryptor
+
+#include <airmap/flight.h>
+#include <airmap/rest/telemetry.h>
+
+#include <boost/beast/core/detail/base64.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <openssl/evp.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace base64 = boost::beast::detail::base64;
+
+namespace {
+
+std::string make_key(char c, std::size_t size = airmap::rest::detail::AES256Encryptor::key_size_in_bytes) {
+  const std::string raw(size, c);
+  std::string key(base64::encoded_size(raw.size()), '\0');
+  key.resize(base64::encode(&key[0], raw.data(), raw.size()));
+  return key;
+}
+
+std::string decrypt(const std::string& cipher, char key, const std::string& iv) {
+  const std::string raw_key(airmap::rest::detail::AES256Encryptor::key_size_in_bytes, key);
+  std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)> ctx{EVP_CIPHER_CTX_new(), ::EVP_CIPHER_CTX_free};
+
+  std::string message(cipher.size(), '\0');
+  int size{0}, final_size{0};
+
+  BOOST_REQUIRE(EVP_DecryptInit_ex(ctx.get(), EVP_aes_256_cbc(), nullptr,
+                                   reinterpret_cast<const unsigned char*>(raw_key.data()),
+                                   reinterpret_cast<const unsigned char*>(iv.data())) == 1);
+  BOOST_REQUIRE(EVP_DecryptUpdate(ctx.get(), reinterpret_cast<unsigned char*>(&message[0]), &size,
+                                  reinterpret_cast<const unsigned char*>(cipher.data()),
+                                  static_cast<int>(cipher.size())) == 1);
+  BOOST_REQUIRE(EVP_DecryptFinal_ex(ctx.get(), reinterpret_cast<unsigned char*>(&message[size]), &final_size) == 1);
+
+  message.resize(size + final_size);
+  return message;
+}
+
+// CountingEncryptor counts the sessions created by the OpenSSL encryptor it wraps.
+class CountingEncryptor : public airmap::rest::detail::OpenSSLAES256Encryptor {
+ public:
+  std::unique_ptr<Session> create_session(const std::string& key) override {
+    keys.push_back(key);
+    return OpenSSLAES256Encryptor::create_session(key);
+  }
+
+  std::vector<std::string> keys;
+};
+
+class RecordingSender : public airmap::net::udp::Sender {
+ public:
+  void send(const std::string& message, const Callback&) override {
+    packets.push_back(message);
+  }
+
+  std::vector<std::string> packets;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(session_encrypts_like_one_shot_encrypt) {
+  airmap::rest::detail::OpenSSLAES256Encryptor encryptor;
+  auto session = encryptor.create_session(make_key('k'));
+
+  std::string cipher;
+  for (const auto& message : {std::string{"telemetry"}, std::string(100, 'x'), std::string{}}) {
+    const auto iv = encryptor.create_shared_secret();
+    session->encrypt(message, iv, cipher);
+
+    BOOST_CHECK_EQUAL(cipher, encryptor.encrypt(message, make_key('k'), iv));
+    BOOST_CHECK_EQUAL(decrypt(cipher, 'k', iv), message);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(session_rejects_short_and_malformed_keys) {
+  airmap::rest::detail::OpenSSLAES256Encryptor encryptor;
+
+  BOOST_CHECK_THROW(encryptor.create_session(make_key('k', 16)), std::runtime_error);
+  BOOST_CHECK_THROW(encryptor.create_session("not base64!"), std::runtime_error);
+  BOOST_CHECK_THROW(encryptor.encrypt("telemetry", make_key('k', 31), encryptor.create_shared_secret()),
+                    std::runtime_error);
+  BOOST_CHECK_NO_THROW(encryptor.create_session(make_key('k', 48)));
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_sets_up_a_new_session_only_when_the_key_changes) {
+  auto encryptor = std::make_shared<CountingEncryptor>();
+  auto sender    = std::make_shared<RecordingSender>();
+  airmap::rest::Telemetry telemetry{encryptor, sender};
+
+  airmap::Flight flight;
+  flight.id = "flight|1234";
+
+  const airmap::Telemetry::Update update{airmap::Telemetry::Barometer{42, 101325.f}};
+
+  telemetry.submit_updates(flight, make_key('a'), {update});
+  telemetry.submit_updates(flight, make_key('a'), {update});
+  BOOST_CHECK_EQUAL(encryptor->keys.size(), 1u);
+
+  // Restarting flight communications hands out a new key.
+  telemetry.submit_updates(flight, make_key('b'), {update});
+  telemetry.submit_updates(flight, make_key('b'), {update});
+  BOOST_CHECK_EQUAL(encryptor->keys.size(), 2u);
+  BOOST_CHECK_EQUAL(encryptor->keys.back(), make_key('b'));
+
+  // Every packet carries the iv and cipher after a header of
+  // counter, flight id size, flight id and encryption type.
+  const auto header_size = 4 + 1 + flight.id.size() + 1;
+  const auto block_size  = airmap::rest::detail::AES256Encryptor::block_size_in_bytes;
+
+  BOOST_REQUIRE_EQUAL(sender->packets.size(), 4u);
+  const auto& first = sender->packets.front();
+  const auto& last  = sender->packets.back();
+  BOOST_CHECK_EQUAL(decrypt(first.substr(header_size + block_size), 'a', first.substr(header_size, block_size)),
+                    decrypt(last.substr(header_size + block_size), 'b', last.substr(header_size, block_size)));
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_rejects_short_keys) {
+  auto sender = std::make_shared<RecordingSender>();
+  airmap::rest::Telemetry telemetry{std::make_shared<CountingEncryptor>(), sender};
+
+  airmap::Flight flight;
+  flight.id = "flight|1234";
+
+  BOOST_CHECK_THROW(telemetry.submit_updates(flight, make_key('a', 8), {airmap::Telemetry::Update{
+                                                                          airmap::Telemetry::Barometer{42, 101325.f}}}),
+                    std::runtime_error);
+  BOOST_CHECK(sender->packets.empty());
+}
@@ -0,0 +1,208 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE telemetry_packet_builder
+
+#include <airmap/flight.h>
+#include <airmap/rest/telemetry.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <arpa/inet.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr const char* flight_id{"flight|1234"};
+
+std::uint16_t read_uint16(const std::string& buffer, std::size_t offset) {
+  std::uint16_t value;
+  std::memcpy(&value, buffer.data() + offset, sizeof(value));
+  return ntohs(value);
+}
+
+std::uint32_t read_uint32(const std::string& buffer, std::size_t offset) {
+  std::uint32_t value;
+  std::memcpy(&value, buffer.data() + offset, sizeof(value));
+  return ntohl(value);
+}
+
+class NullEncryptor : public airmap::rest::detail::AES256Encryptor {
+ public:
+  class Session : public AES256Encryptor::Session {
+   public:
+    void encrypt(const std::string& message, const std::string&, std::string& cipher) override {
+      cipher = message;
+    }
+  };
+
+  std::unique_ptr<AES256Encryptor::Session> create_session(const std::string&) override {
+    sessions++;
+    return std::make_unique<Session>();
+  }
+
+  void create_shared_secret(std::string& iv) override {
+    iv.assign(block_size_in_bytes, 'i');
+  }
+
+  std::string create_shared_secret() override {
+    return std::string(block_size_in_bytes, 'i');
+  }
+
+  std::string encrypt(const std::string& message, const std::string&, const std::string&) override {
+    return message;
+  }
+
+  std::size_t sessions{0};
+};
+
+class RecordingSender : public airmap::net::udp::Sender {
+ public:
+  void send(const std::string& message, const Callback&) override {
+    packets.push_back(message);
+  }
+
+  std::vector<std::string> packets;
+};
+
+// SingleUpdateTelemetry only implements the mandatory part of airmap::Telemetry.
+class SingleUpdateTelemetry : public airmap::Telemetry {
+ public:
+  using airmap::Telemetry::submit_updates;
+
+  void submit_updates(const airmap::Flight&, const std::string&,
+                      const std::initializer_list<Update>& updates) override {
+    calls.push_back(updates.size());
+  }
+
+  std::vector<std::size_t> calls;
+};
+
+airmap::Flight make_flight(const std::string& id) {
+  airmap::Flight flight;
+  flight.id = id;
+  return flight;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(packet_builder_tags_every_update_with_type_and_size) {
+  airmap::rest::detail::PacketBuilder builder{flight_id};
+  builder.add(airmap::Telemetry::Update{airmap::Telemetry::Position{42, 47.1, 8.2, 400., 100., 2.}})
+      .add(airmap::Telemetry::Update{airmap::Telemetry::Barometer{42, 101325.f}});
+
+  const auto& payload = builder.payload();
+
+  BOOST_REQUIRE(payload.size() > 4);
+  BOOST_CHECK_EQUAL(read_uint16(payload, 0), static_cast<std::uint16_t>(airmap::Telemetry::Update::Type::position));
+
+  const std::size_t offset = 4 + read_uint16(payload, 2);
+  BOOST_REQUIRE(payload.size() > offset + 4);
+  BOOST_CHECK_EQUAL(read_uint16(payload, offset),
+                    static_cast<std::uint16_t>(airmap::Telemetry::Update::Type::barometer));
+  BOOST_CHECK_EQUAL(payload.size(), offset + 4 + read_uint16(payload, offset + 2));
+}
+
+BOOST_AUTO_TEST_CASE(packet_builder_reset_clears_payload) {
+  airmap::rest::detail::PacketBuilder builder{flight_id};
+  builder.add(airmap::Telemetry::Update{airmap::Telemetry::Speed{42, 1.f, 2.f, 3.f}});
+  BOOST_CHECK(!builder.payload().empty());
+  BOOST_CHECK(builder.reset().payload().empty());
+}
+
+BOOST_AUTO_TEST_CASE(packet_builder_finalize_reuses_flight_header) {
+  airmap::rest::detail::PacketBuilder builder{flight_id};
+
+  const std::string iv(airmap::rest::detail::AES256Encryptor::block_size_in_bytes, 'i');
+  const std::string header_size_and_id = std::string(1, static_cast<char>(std::strlen(flight_id))) + flight_id;
+
+  for (std::uint32_t counter = 1; counter < 3; counter++) {
+    const auto& packet = builder.finalize(counter, iv, "cipher");
+    BOOST_CHECK_EQUAL(read_uint32(packet, 0), counter);
+    BOOST_CHECK_EQUAL(packet.substr(4, header_size_and_id.size()), header_size_and_id);
+    BOOST_CHECK_EQUAL(packet[4 + header_size_and_id.size()], 1);
+    BOOST_CHECK_EQUAL(packet.substr(5 + header_size_and_id.size()), iv + "cipher");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_submits_batches_one_by_one_by_default) {
+  SingleUpdateTelemetry telemetry;
+  telemetry.submit_updates(make_flight(flight_id), "key",
+                           std::vector<airmap::Telemetry::Update>{
+                               airmap::Telemetry::Update{airmap::Telemetry::Speed{42, 1.f, 2.f, 3.f}},
+                               airmap::Telemetry::Update{airmap::Telemetry::Barometer{42, 101325.f}}});
+
+  BOOST_CHECK((telemetry.calls == std::vector<std::size_t>{1, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_packs_batches_into_a_single_packet) {
+  auto encryptor = std::make_shared<NullEncryptor>();
+  auto sender    = std::make_shared<RecordingSender>();
+  airmap::rest::Telemetry telemetry{encryptor, sender};
+
+  telemetry.submit_updates(make_flight(flight_id), "key",
+                           std::vector<airmap::Telemetry::Update>{
+                               airmap::Telemetry::Update{airmap::Telemetry::Speed{42, 1.f, 2.f, 3.f}},
+                               airmap::Telemetry::Update{airmap::Telemetry::Barometer{42, 101325.f}}});
+
+  BOOST_CHECK_EQUAL(sender->packets.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_releases_least_recently_used_sessions) {
+  auto encryptor = std::make_shared<NullEncryptor>();
+  auto sender    = std::make_shared<RecordingSender>();
+  airmap::rest::Telemetry telemetry{encryptor, sender, 2};
+
+  const airmap::Telemetry::Update update{airmap::Telemetry::Barometer{42, 101325.f}};
+
+  telemetry.submit_updates(make_flight("a"), "key", {update});
+  telemetry.submit_updates(make_flight("b"), "key", {update});
+  telemetry.submit_updates(make_flight("a"), "key", {update});
+  BOOST_CHECK_EQUAL(telemetry.sessions(), 2u);
+  BOOST_CHECK_EQUAL(encryptor->sessions, 2u);
+
+  // "b" submitted least recently and is released.
+  telemetry.submit_updates(make_flight("c"), "key", {update});
+  BOOST_CHECK_EQUAL(telemetry.sessions(), 2u);
+  BOOST_CHECK_EQUAL(encryptor->sessions, 3u);
+
+  telemetry.submit_updates(make_flight("a"), "key", {update});
+  BOOST_CHECK_EQUAL(encryptor->sessions, 3u);
+
+  telemetry.submit_updates(make_flight("b"), "key", {update});
+  BOOST_CHECK_EQUAL(encryptor->sessions, 4u);
+  BOOST_CHECK_EQUAL(sender->packets.size(), 6u);
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_releases_ended_sessions) {
+  auto encryptor = std::make_shared<NullEncryptor>();
+  auto sender    = std::make_shared<RecordingSender>();
+  airmap::rest::Telemetry telemetry{encryptor, sender};
+
+  const airmap::Telemetry::Update update{airmap::Telemetry::Barometer{42, 101325.f}};
+
+  telemetry.submit_updates(make_flight("a"), "key", {update});
+  telemetry.submit_updates(make_flight("b"), "key", {update});
+  BOOST_CHECK_EQUAL(telemetry.sessions(), 2u);
+
+  telemetry.end_session(make_flight("a"));
+  telemetry.end_session(make_flight("unknown"));
+  BOOST_CHECK_EQUAL(telemetry.sessions(), 1u);
+
+  // Submitting for an ended flight sets up a new session.
+  telemetry.submit_updates(make_flight("a"), "key", {update});
+  BOOST_CHECK_EQUAL(telemetry.sessions(), 2u);
+  BOOST_CHECK_EQUAL(encryptor->sessions, 3u);
+}
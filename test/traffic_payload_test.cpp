@@ -0,0 +1,114 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE traffic_payload
+
+#include <airmap/codec.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// track returns an element of the traffic array, formatted as published on uav/traffic/sa/<flight id>.
+std::string track(int i) {
+  auto n = std::to_string(i);
+  return R"({"id":"sa|)" + n + R"(","direction":)" + std::to_string(i % 360) +
+         R"(.5,"latitude":"47.)" + n + R"(1234","longitude":"8.)" + n +
+         R"(5678","altitude":"3500","ground_speed_kts":"240.5","true_heading":")" + std::to_string(i % 360) +
+         R"(","recorded_time":"1525190400","timestamp":1525190400123,"properties":{"aircraft_id":"N)" + n +
+         R"(","aircraft_type":"B738"}})";
+}
+
+// payload returns a situational awareness payload carrying 'count' tracks.
+std::string payload(int count) {
+  std::string result{R"({"traffic":[)"};
+  for (int i = 0; i < count; i++)
+    result += (i > 0 ? "," : "") + track(i);
+  return result + "]}";
+}
+
+// decode_dom decodes 'payload' through the nlohmann DOM, the way Traffic::Monitor used to.
+std::vector<airmap::Traffic::Update> decode_dom(const std::string& payload) {
+  std::vector<airmap::Traffic::Update> result = nlohmann::json::parse(payload)["traffic"];
+  return result;
+}
+
+void check_equal(const airmap::Traffic::Update& lhs, const airmap::Traffic::Update& rhs) {
+  BOOST_CHECK_EQUAL(lhs.id, rhs.id);
+  BOOST_CHECK_EQUAL(lhs.aircraft_id, rhs.aircraft_id);
+  BOOST_CHECK_EQUAL(lhs.latitude, rhs.latitude);
+  BOOST_CHECK_EQUAL(lhs.longitude, rhs.longitude);
+  BOOST_CHECK_EQUAL(lhs.altitude, rhs.altitude);
+  BOOST_CHECK_EQUAL(lhs.ground_speed, rhs.ground_speed);
+  BOOST_CHECK_EQUAL(lhs.heading, rhs.heading);
+  BOOST_CHECK_EQUAL(lhs.direction, rhs.direction);
+  BOOST_CHECK(lhs.recorded == rhs.recorded);
+  BOOST_CHECK(lhs.timestamp == rhs.timestamp);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(traffic_payload_decodes_like_the_dom) {
+  auto p = payload(16);
+
+  std::vector<airmap::Traffic::Update> updates;
+  airmap::codec::json::decode_traffic_payload(p, updates);
+  auto expected = decode_dom(p);
+
+  BOOST_REQUIRE_EQUAL(updates.size(), expected.size());
+  for (std::size_t i = 0; i < updates.size(); i++)
+    check_equal(updates[i], expected[i]);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_payload_reuses_and_resizes_updates) {
+  std::vector<airmap::Traffic::Update> updates;
+
+  airmap::codec::json::decode_traffic_payload(payload(8), updates);
+  BOOST_CHECK_EQUAL(updates.size(), 8);
+
+  airmap::codec::json::decode_traffic_payload(payload(3), updates);
+  BOOST_REQUIRE_EQUAL(updates.size(), 3);
+  check_equal(updates[2], decode_dom(payload(3))[2]);
+
+  airmap::codec::json::decode_traffic_payload(R"({"traffic":[]})", updates);
+  BOOST_CHECK(updates.empty());
+}
+
+BOOST_AUTO_TEST_CASE(traffic_payload_unescapes_strings_and_skips_unknown_members) {
+  std::vector<airmap::Traffic::Update> updates;
+  airmap::codec::json::decode_traffic_payload(
+      R"({"meta":{"seq":[1,2,{"a":null}],"ok":true},"traffic":[{"id":"sa|\"1\"é","latitude":"47.5",)"
+      R"("longitude":"8.5","recorded_time":"1","altitude":null,"extra":[false],"properties":{"aircraft_id":"N\/1"}}]})",
+      updates);
+
+  BOOST_REQUIRE_EQUAL(updates.size(), 1);
+  BOOST_CHECK_EQUAL(updates[0].id, "sa|\"1\"\xc3\xa9");
+  BOOST_CHECK_EQUAL(updates[0].aircraft_id, "N/1");
+  BOOST_CHECK_EQUAL(updates[0].latitude, 47.5);
+  BOOST_CHECK_EQUAL(updates[0].altitude, 0.);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_payload_rejects_malformed_payloads) {
+  std::vector<airmap::Traffic::Update> updates;
+
+  BOOST_CHECK_THROW(airmap::codec::json::decode_traffic_payload(R"({"traffic":[)", updates), std::runtime_error);
+  BOOST_CHECK_THROW(airmap::codec::json::decode_traffic_payload(R"({"other":[]})", updates), std::runtime_error);
+  BOOST_CHECK_THROW(airmap::codec::json::decode_traffic_payload(
+                        R"({"traffic":[{"latitude":"north","longitude":"8.5","recorded_time":"1"}]})", updates),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(airmap::codec::json::decode_traffic_payload(R"({"traffic":[]} trailing)", updates),
+                    std::runtime_error);
+}
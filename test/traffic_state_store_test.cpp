@@ -0,0 +1,99 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE traffic_state_store
+
+#include <airmap/monitor/traffic_state_store.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+namespace {
+
+using Store = airmap::monitor::TrafficStateStore;
+using Type  = airmap::Traffic::Update::Type;
+
+airmap::Traffic::Update make_update(const std::string& id, double latitude, std::int64_t recorded) {
+  airmap::Traffic::Update update{};
+  update.id        = id;
+  update.latitude  = latitude;
+  update.longitude = 8.5;
+  update.altitude  = 1000.;
+  update.recorded  = airmap::from_seconds_since_epoch(airmap::seconds(recorded));
+  return update;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(traffic_state_store_reports_new_tracks_as_added) {
+  Store store{Store::Configuration{}};
+  auto now = std::chrono::steady_clock::now();
+
+  auto delta = store.apply(Type::situational_awareness, {make_update("a", 47., 1), make_update("b", 47., 1)}, now);
+  BOOST_CHECK_EQUAL(delta.added.size(), 2);
+  BOOST_CHECK(delta.changed.empty());
+  BOOST_CHECK_EQUAL(store.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_state_store_drops_unchanged_tracks) {
+  Store store{Store::Configuration{}};
+  auto now = std::chrono::steady_clock::now();
+
+  store.apply(Type::situational_awareness, {make_update("a", 47., 1)}, now);
+
+  // Same datum repeated, and a new datum within the position threshold.
+  BOOST_CHECK(store.apply(Type::situational_awareness, {make_update("a", 47., 1)}, now).empty());
+  BOOST_CHECK(store.apply(Type::situational_awareness, {make_update("a", 47.00001, 2)}, now).empty());
+  BOOST_CHECK_EQUAL(store.dropped(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_state_store_forwards_material_changes_and_refreshes) {
+  Store::Configuration configuration;
+  configuration.refresh_interval = std::chrono::seconds{5};
+  Store store{configuration};
+  auto now = std::chrono::steady_clock::now();
+
+  store.apply(Type::situational_awareness, {make_update("a", 47., 1)}, now);
+
+  // ~110m north of the previous position.
+  auto delta = store.apply(Type::situational_awareness, {make_update("a", 47.001, 2)}, now);
+  BOOST_CHECK_EQUAL(delta.changed.size(), 1);
+
+  // Unchanged position, but the refresh interval elapsed.
+  delta = store.apply(Type::situational_awareness, {make_update("a", 47.001, 3)}, now + std::chrono::seconds{5});
+  BOOST_CHECK_EQUAL(delta.changed.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_state_store_never_drops_alerts) {
+  Store store{Store::Configuration{}};
+  auto now = std::chrono::steady_clock::now();
+
+  store.apply(Type::situational_awareness, {make_update("a", 47., 1)}, now);
+  BOOST_CHECK_EQUAL(store.apply(Type::alert, {make_update("a", 47., 1)}, now).changed.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_state_store_expires_silent_tracks) {
+  Store::Configuration configuration;
+  configuration.track_timeout = std::chrono::seconds{30};
+  Store store{configuration};
+  auto now = std::chrono::steady_clock::now();
+
+  store.apply(Type::situational_awareness, {make_update("a", 47., 1), make_update("b", 47., 1)}, now);
+  // Dropped as unchanged, but still keeps 'b' alive.
+  store.apply(Type::situational_awareness, {make_update("b", 47., 1)}, now + std::chrono::seconds{20});
+
+  BOOST_CHECK(store.expire(now + std::chrono::seconds{29}).empty());
+
+  auto delta = store.expire(now + std::chrono::seconds{30});
+  BOOST_REQUIRE_EQUAL(delta.expired.size(), 1);
+  BOOST_CHECK_EQUAL(delta.expired.front(), "a");
+  BOOST_CHECK_EQUAL(store.size(), 1);
+}
@@ -0,0 +1,169 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE udp_sender
+
+#include <airmap/net/dns/resolver_cache.h>
+#include <airmap/net/udp/boost/sender.h>
+
+#include <boost/asio.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ip = boost::asio::ip;
+
+namespace {
+
+using Sender = airmap::net::udp::boost::Sender;
+
+// Fixture runs an io_service on a background thread and receives datagrams on a loopback socket.
+struct Fixture {
+  Fixture()
+      : io_service{std::make_shared<boost::asio::io_service>()},
+        work{*io_service},
+        resolver_cache{airmap::net::dns::ResolverCache::create(airmap::net::dns::ResolverCache::Configuration{},
+                                                               io_service)},
+        receiver{*io_service, ip::udp::endpoint{ip::address_v4::loopback(), 0}},
+        worker{[this]() { io_service->run(); }} {
+  }
+
+  ~Fixture() {
+    io_service->stop();
+    worker.join();
+  }
+
+  std::shared_ptr<Sender> make_sender(const Sender::Configuration& configuration) {
+    return Sender::create("127.0.0.1", receiver.local_endpoint().port(), io_service, resolver_cache, configuration);
+  }
+
+  Sender::Callback make_callback() {
+    return [this](const Sender::Result& result) {
+      std::lock_guard<std::mutex> lg{guard};
+      (result ? succeeded : failed)++;
+      cv.notify_all();
+    };
+  }
+
+  bool wait_for(std::size_t count) {
+    std::unique_lock<std::mutex> ul{guard};
+    return cv.wait_for(ul, std::chrono::seconds{5}, [this, count]() { return succeeded + failed >= count; });
+  }
+
+  std::string receive() {
+    std::string buffer(1024, '\0');
+    buffer.resize(receiver.receive(boost::asio::buffer(&buffer[0], buffer.size())));
+    return buffer;
+  }
+
+  std::shared_ptr<boost::asio::io_service> io_service;
+  boost::asio::io_service::work work;
+  std::shared_ptr<airmap::net::dns::ResolverCache> resolver_cache;
+  ip::udp::socket receiver;
+  std::thread worker;
+
+  std::mutex guard;
+  std::condition_variable cv;
+  std::size_t succeeded{0};
+  std::size_t failed{0};
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_CASE(sender_delivers_datagrams_queued_before_resolution, Fixture) {
+  auto sender = make_sender(Sender::Configuration{});
+
+  for (auto message : {"a", "b", "c"})
+    sender->send(message, make_callback());
+
+  BOOST_REQUIRE(wait_for(3));
+  BOOST_CHECK_EQUAL(succeeded, 3u);
+  BOOST_CHECK_EQUAL(receive(), "a");
+  BOOST_CHECK_EQUAL(receive(), "b");
+  BOOST_CHECK_EQUAL(receive(), "c");
+
+  // Once connected, datagrams are handed to the kernel right away.
+  sender->send("d", make_callback());
+  BOOST_REQUIRE(wait_for(4));
+  BOOST_CHECK_EQUAL(succeeded, 4u);
+  BOOST_CHECK_EQUAL(receive(), "d");
+}
+
+BOOST_FIXTURE_TEST_CASE(sender_batches_datagrams_in_order, Fixture) {
+  Sender::Configuration configuration;
+  configuration.batch_size = 4;
+  auto sender              = make_sender(configuration);
+
+  const std::vector<std::string> messages{"1", "2", "3", "4", "5", "6"};
+  for (const auto& message : messages)
+    sender->send(message, make_callback());
+
+  BOOST_REQUIRE(wait_for(messages.size()));
+  BOOST_CHECK_EQUAL(succeeded, messages.size());
+
+  for (const auto& message : messages)
+    BOOST_CHECK_EQUAL(receive(), message);
+}
+
+BOOST_FIXTURE_TEST_CASE(sender_fails_datagrams_beyond_max_pending, Fixture) {
+  Sender::Configuration configuration;
+  configuration.max_pending = 2;
+  auto sender               = make_sender(configuration);
+
+  // We hold up the io_service such that all datagrams are sent before the endpoint is resolved.
+  std::promise<void> sent;
+  io_service->post([f = sent.get_future().share()]() { f.wait(); });
+
+  for (auto message : {"a", "b", "c"})
+    sender->send(message, make_callback());
+
+  sent.set_value();
+
+  BOOST_REQUIRE(wait_for(3));
+  BOOST_CHECK_EQUAL(succeeded, 2u);
+  BOOST_CHECK_EQUAL(failed, 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(sender_handles_sends_racing_with_refreshes, Fixture) {
+  // A zero ttl refreshes the endpoint on every send, reconnecting the socket
+  // while other threads send and the io_service flushes.
+  Sender::Configuration configuration;
+  configuration.resolve_ttl = std::chrono::seconds{0};
+  configuration.batch_size  = 2;
+  configuration.max_pending = 1024;
+  auto sender               = make_sender(configuration);
+
+  constexpr std::size_t threads{4};
+  constexpr std::size_t sends_per_thread{100};
+
+  std::vector<std::thread> senders;
+  for (std::size_t i = 0; i < threads; i++) {
+    senders.emplace_back([this, sender]() {
+      for (std::size_t j = 0; j < sends_per_thread; j++)
+        sender->send("telemetry", make_callback());
+    });
+  }
+
+  for (auto& t : senders)
+    t.join();
+
+  BOOST_REQUIRE(wait_for(threads * sends_per_thread));
+  BOOST_CHECK_EQUAL(succeeded + failed, threads * sends_per_thread);
+}
@@ -0,0 +1,191 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE update_queue
+
+#include <airmap/monitor/grpc/update_queue.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Queue  = airmap::monitor::grpc::UpdateQueue;
+using Policy = Queue::OverflowPolicy;
+using Update = Queue::Update;
+
+::grpc::airmap::Traffic_Update make_traffic(const std::string& id, double latitude) {
+  ::grpc::airmap::Traffic_Update result;
+  result.mutable_track()->set_as_string(id);
+  result.mutable_position()->mutable_latitude()->set_value(latitude);
+  return result;
+}
+
+// make_update returns a full mode update of all tracks in 'ids', positioned at 'latitude'.
+Update make_update(const std::vector<std::string>& ids, double latitude) {
+  Update result;
+  for (const auto& id : ids)
+    *result.add_traffic() = make_traffic(id, latitude);
+  return result;
+}
+
+// make_delta returns a delta mode update.
+Update make_delta(const std::vector<std::string>& added, const std::vector<std::string>& changed,
+                  const std::vector<std::string>& expired, double latitude) {
+  Update result;
+  for (const auto& id : added)
+    *result.add_added() = make_traffic(id, latitude);
+  for (const auto& id : changed)
+    *result.add_changed() = make_traffic(id, latitude);
+  for (const auto& id : expired)
+    result.add_expired()->set_as_string(id);
+  return result;
+}
+
+// tracks returns the ids and latitudes of all tracks in 'updates', in order.
+std::vector<std::string> tracks(const google::protobuf::RepeatedPtrField<::grpc::airmap::Traffic_Update>& updates) {
+  std::vector<std::string> result;
+  for (const auto& u : updates)
+    result.push_back(u.track().as_string() + "@" + std::to_string(static_cast<int>(u.position().latitude().value())));
+  return result;
+}
+
+std::vector<std::string> ids(const google::protobuf::RepeatedPtrField<::grpc::airmap::TrackID>& ids) {
+  std::vector<std::string> result;
+  for (const auto& id : ids)
+    result.push_back(id.as_string());
+  return result;
+}
+
+// pop_all pops all queued updates, returning the latitude of their first track.
+std::vector<int> pop_all(Queue& queue) {
+  std::vector<int> result;
+  Update update;
+  while (queue.pop(update))
+    result.push_back(static_cast<int>(update.traffic(0).position().latitude().value()));
+  return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(updates_are_popped_in_order) {
+  Queue queue{4, Policy::drop_oldest};
+  queue.push(make_update({"a"}, 1));
+  queue.push(make_update({"a"}, 2));
+  BOOST_CHECK_EQUAL(2u, queue.size());
+
+  std::vector<int> expected{1, 2};
+  auto popped = pop_all(queue);
+  BOOST_CHECK_EQUAL_COLLECTIONS(popped.begin(), popped.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(0u, queue.size());
+}
+
+BOOST_AUTO_TEST_CASE(drop_oldest_makes_room_by_dropping_the_oldest_update) {
+  Queue queue{2, Policy::drop_oldest};
+  for (int i = 1; i <= 5; i++)
+    BOOST_CHECK(queue.push(make_update({"a"}, i)));
+
+  BOOST_CHECK_EQUAL(2u, queue.size());
+  BOOST_CHECK_EQUAL(3u, queue.dropped());
+  BOOST_CHECK_EQUAL(0u, queue.coalesced());
+
+  std::vector<int> expected{4, 5};
+  auto popped = pop_all(queue);
+  BOOST_CHECK_EQUAL_COLLECTIONS(popped.begin(), popped.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(coalesce_latest_makes_room_by_merging_all_queued_updates) {
+  Queue queue{2, Policy::coalesce_latest};
+  queue.push(make_update({"a", "b"}, 1));
+  queue.push(make_update({"a"}, 2));
+  queue.push(make_update({"c"}, 3));
+
+  BOOST_CHECK_EQUAL(1u, queue.size());
+  BOOST_CHECK_EQUAL(2u, queue.coalesced());
+  BOOST_CHECK_EQUAL(0u, queue.dropped());
+
+  Update update;
+  BOOST_REQUIRE(queue.pop(update));
+  std::vector<std::string> expected{"a@2", "b@1", "c@3"};
+  auto merged = tracks(update.traffic());
+  BOOST_CHECK_EQUAL_COLLECTIONS(merged.begin(), merged.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(disconnect_refuses_updates_once_full) {
+  Queue queue{1, Policy::disconnect};
+  BOOST_CHECK(queue.push(make_update({"a"}, 1)));
+  BOOST_CHECK(!queue.push(make_update({"a"}, 2)));
+
+  std::vector<int> expected{1};
+  auto popped = pop_all(queue);
+  BOOST_CHECK_EQUAL_COLLECTIONS(popped.begin(), popped.end(), expected.begin(), expected.end());
+  BOOST_CHECK(queue.push(make_update({"a"}, 3)));
+}
+
+BOOST_AUTO_TEST_CASE(queues_hold_at_least_one_update) {
+  Queue queue{0, Policy::disconnect};
+  BOOST_CHECK(queue.push(make_update({"a"}, 1)));
+  BOOST_CHECK(!queue.push(make_update({"a"}, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(clear_drops_queued_updates_without_accounting_for_them) {
+  Queue queue{4, Policy::drop_oldest};
+  queue.push(make_update({"a"}, 1));
+  queue.clear();
+
+  BOOST_CHECK_EQUAL(0u, queue.size());
+  BOOST_CHECK_EQUAL(0u, queue.dropped());
+}
+
+BOOST_AUTO_TEST_CASE(coalesce_keeps_the_latest_state_of_every_track_in_full_mode) {
+  std::deque<Update> queued{make_update({"a", "b"}, 1), make_update({"b"}, 2)};
+  auto result = airmap::monitor::grpc::coalesce(queued, make_update({"c", "a"}, 3));
+
+  std::vector<std::string> expected{"a@3", "b@2", "c@3"};
+  auto merged = tracks(result.traffic());
+  BOOST_CHECK_EQUAL_COLLECTIONS(merged.begin(), merged.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(0, result.added_size());
+  BOOST_CHECK_EQUAL(0, result.changed_size());
+  BOOST_CHECK_EQUAL(0, result.expired_size());
+}
+
+BOOST_AUTO_TEST_CASE(coalesce_reports_the_net_change_across_deltas) {
+  std::deque<Update> queued{
+      // a and c are new, b is known and changes.
+      make_delta({"a", "c"}, {"b"}, {}, 1),
+      // a changes, b and c expire, d is known and changes.
+      make_delta({}, {"a", "d"}, {"b", "c"}, 2),
+  };
+  // e is known and expires, only to come back.
+  queued.push_back(make_delta({}, {}, {"e"}, 3));
+  auto result = airmap::monitor::grpc::coalesce(queued, make_delta({"e"}, {"d"}, {}, 4));
+
+  // a was never reported to the client, and still is new.
+  std::vector<std::string> added{"a@2"};
+  auto merged = tracks(result.added());
+  BOOST_CHECK_EQUAL_COLLECTIONS(merged.begin(), merged.end(), added.begin(), added.end());
+
+  // e came back, the client knew about it all along.
+  std::vector<std::string> changed{"d@4", "e@4"};
+  merged = tracks(result.changed());
+  BOOST_CHECK_EQUAL_COLLECTIONS(merged.begin(), merged.end(), changed.begin(), changed.end());
+
+  // c came and went, the client never has to know.
+  std::vector<std::string> expired{"b"};
+  auto gone = ids(result.expired());
+  BOOST_CHECK_EQUAL_COLLECTIONS(gone.begin(), gone.end(), expired.begin(), expired.end());
+
+  BOOST_CHECK_EQUAL(0, result.traffic_size());
+}
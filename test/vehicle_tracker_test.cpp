@@ -0,0 +1,245 @@
+// AirMap Platform SDK
+// Copyright © 2018 AirMap, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the License);
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an AS IS BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#define BOOST_TEST_MODULE vehicle_tracker
+
+#include <airmap/mavlink/vehicle_tracker.h>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// position returns a GLOBAL_POSITION_INT message, tagging the latitude with 'system_id'.
+mavlink_message_t position(std::uint8_t system_id, std::uint32_t time_boot_ms) {
+  mavlink_message_t msg;
+  mavlink_msg_global_position_int_pack(system_id, 1, &msg, time_boot_ms, system_id, 0, 0, 0, 0, 0, 0, 0);
+  return msg;
+}
+
+// Recorder collects the positions reported by all vehicles, together with the reporting threads.
+struct Recorder {
+  void record(std::uint8_t system_id, std::uint32_t time_boot_ms) {
+    std::unique_lock<std::mutex> ul{guard};
+    positions[system_id].push_back(time_boot_ms);
+    threads.insert(std::this_thread::get_id());
+    count++;
+    cv.notify_all();
+
+    if (blocked) {
+      blocking = true;
+      cv.notify_all();
+      cv.wait(ul, [this]() { return !blocked; });
+      blocking = false;
+    }
+  }
+
+  bool wait_for(std::size_t n) {
+    std::unique_lock<std::mutex> ul{guard};
+    return cv.wait_for(ul, std::chrono::seconds{5}, [this, n]() { return count >= n; });
+  }
+
+  bool wait_until_blocking() {
+    std::unique_lock<std::mutex> ul{guard};
+    return cv.wait_for(ul, std::chrono::seconds{5}, [this]() { return blocking; });
+  }
+
+  void unblock() {
+    std::lock_guard<std::mutex> lg{guard};
+    blocked = false;
+    cv.notify_all();
+  }
+
+  std::mutex guard;
+  std::condition_variable cv;
+  std::map<std::uint8_t, std::vector<std::uint32_t>> positions;
+  std::set<std::thread::id> threads;
+  std::size_t count{0};
+  bool blocked{false};
+  bool blocking{false};
+};
+
+class RecordingVehicleMonitor : public airmap::mavlink::Vehicle::Monitor {
+ public:
+  explicit RecordingVehicleMonitor(Recorder& recorder) : recorder_{recorder} {
+  }
+
+  void on_system_status_changed(const airmap::Optional<airmap::mavlink::State>&, airmap::mavlink::State) override {
+  }
+  void on_position_changed(const airmap::Optional<airmap::mavlink::GlobalPositionInt>&,
+                           const airmap::mavlink::GlobalPositionInt& position) override {
+    recorder_.record(static_cast<std::uint8_t>(position.lat), position.time_boot_ms);
+  }
+  void on_attitude_changed(const airmap::Optional<airmap::mavlink::Attitude>&,
+                           const airmap::mavlink::Attitude&) override {
+  }
+  void on_vfr_hud_changed(const airmap::Optional<airmap::mavlink::VfrHud>&, const airmap::mavlink::VfrHud&) override {
+  }
+  void on_pressure_changed(const airmap::Optional<airmap::mavlink::ScaledPressure>&,
+                           const airmap::mavlink::ScaledPressure&) override {
+  }
+  void on_mission_received(const airmap::Geometry&) override {
+  }
+
+ private:
+  Recorder& recorder_;
+};
+
+class RecordingTrackerMonitor : public airmap::mavlink::VehicleTracker::Monitor {
+ public:
+  explicit RecordingTrackerMonitor(Recorder& recorder) : recorder_{recorder} {
+  }
+
+  void on_vehicle_added(const std::shared_ptr<airmap::mavlink::Vehicle>& vehicle) override {
+    vehicle->register_monitor(std::make_shared<RecordingVehicleMonitor>(recorder_));
+    added++;
+  }
+
+  void on_vehicle_removed(const std::shared_ptr<airmap::mavlink::Vehicle>&) override {
+    removed++;
+  }
+
+  std::size_t added{0};
+  std::size_t removed{0};
+
+ private:
+  Recorder& recorder_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(synchronous_tracker_dispatches_on_the_updating_thread) {
+  Recorder recorder;
+  airmap::mavlink::VehicleTracker tracker;
+  auto monitor = std::make_shared<RecordingTrackerMonitor>(recorder);
+  tracker.register_monitor(monitor);
+
+  tracker.update(position(1, 1));
+  tracker.update(position(2, 2));
+  tracker.update(position(1, 3));
+
+  BOOST_CHECK_EQUAL(2u, monitor->added);
+  BOOST_CHECK_EQUAL(2u, tracker.active());
+  BOOST_CHECK_EQUAL(3u, recorder.count);
+  BOOST_CHECK(recorder.threads == std::set<std::thread::id>{std::this_thread::get_id()});
+  BOOST_CHECK((std::vector<std::uint32_t>{1, 3}) == recorder.positions[1]);
+}
+
+BOOST_AUTO_TEST_CASE(fleet_mode_dispatches_on_workers_in_per_vehicle_order) {
+  static constexpr std::size_t vehicles  = 8;
+  static constexpr std::size_t positions = 200;
+
+  Recorder recorder;
+  airmap::mavlink::VehicleTracker::Configuration configuration;
+  configuration.workers        = 3;
+  configuration.queue_capacity = positions;
+  airmap::mavlink::VehicleTracker tracker{configuration};
+  auto monitor = std::make_shared<RecordingTrackerMonitor>(recorder);
+  tracker.register_monitor(monitor);
+
+  for (std::uint32_t i = 0; i < positions; i++)
+    for (std::uint8_t sysid = 1; sysid <= vehicles; sysid++)
+      tracker.update(position(sysid, i));
+
+  BOOST_REQUIRE(recorder.wait_for(vehicles * positions));
+
+  std::lock_guard<std::mutex> lg{recorder.guard};
+  BOOST_CHECK_EQUAL(0u, tracker.dropped());
+  BOOST_CHECK_EQUAL(vehicles, recorder.positions.size());
+  for (const auto& pair : recorder.positions) {
+    BOOST_REQUIRE_EQUAL(positions, pair.second.size());
+    for (std::uint32_t i = 0; i < positions; i++)
+      BOOST_CHECK_EQUAL(i, pair.second[i]);
+  }
+  BOOST_CHECK_EQUAL(0u, recorder.threads.count(std::this_thread::get_id()));
+  BOOST_CHECK_LE(recorder.threads.size(), configuration.workers);
+}
+
+BOOST_AUTO_TEST_CASE(fleet_mode_drops_messages_once_a_vehicle_queue_is_full) {
+  Recorder recorder;
+  recorder.blocked = true;
+
+  airmap::mavlink::VehicleTracker::Configuration configuration;
+  configuration.workers        = 1;
+  configuration.queue_capacity = 4;
+  airmap::mavlink::VehicleTracker tracker{configuration};
+  tracker.register_monitor(std::make_shared<RecordingTrackerMonitor>(recorder));
+
+  // The worker holds on to the first message while it is handed to the vehicle.
+  tracker.update(position(1, 0));
+  BOOST_REQUIRE(recorder.wait_until_blocking());
+
+  for (std::uint32_t i = 1; i <= 10; i++)
+    tracker.update(position(1, i));
+  BOOST_CHECK_EQUAL(7u, tracker.dropped());
+
+  recorder.unblock();
+  BOOST_REQUIRE(recorder.wait_for(4));
+
+  std::lock_guard<std::mutex> lg{recorder.guard};
+  BOOST_CHECK((std::vector<std::uint32_t>{0, 1, 2, 3}) == recorder.positions[1]);
+}
+
+BOOST_AUTO_TEST_CASE(vehicles_without_heartbeat_are_evicted_as_of_now) {
+  Recorder recorder;
+  airmap::mavlink::VehicleTracker::Configuration configuration;
+  configuration.heartbeat_timeout = std::chrono::seconds{30};
+  airmap::mavlink::VehicleTracker tracker{configuration};
+  auto monitor = std::make_shared<RecordingTrackerMonitor>(recorder);
+  tracker.register_monitor(monitor);
+
+  auto now = std::chrono::steady_clock::now();
+  tracker.update(position(1, 0));
+  tracker.update(position(2, 0));
+
+  BOOST_CHECK_EQUAL(0u, tracker.evict_stale_vehicles(now + std::chrono::seconds{29}));
+  BOOST_CHECK_EQUAL(2u, tracker.active());
+
+  BOOST_CHECK_EQUAL(2u, tracker.evict_stale_vehicles(now + std::chrono::seconds{60}));
+  BOOST_CHECK_EQUAL(2u, monitor->removed);
+  BOOST_CHECK_EQUAL(0u, tracker.active());
+  BOOST_CHECK_EQUAL(2u, tracker.evicted());
+
+  // An evicted vehicle that shows up again is tracked from scratch.
+  tracker.update(position(1, 1));
+  BOOST_CHECK_EQUAL(3u, monitor->added);
+  BOOST_CHECK_EQUAL(1u, tracker.active());
+}
+
+BOOST_AUTO_TEST_CASE(fleet_mode_evicts_vehicles_while_workers_are_running) {
+  Recorder recorder;
+  airmap::mavlink::VehicleTracker::Configuration configuration;
+  configuration.workers = 2;
+  airmap::mavlink::VehicleTracker tracker{configuration};
+  auto monitor = std::make_shared<RecordingTrackerMonitor>(recorder);
+  tracker.register_monitor(monitor);
+
+  for (std::uint8_t sysid = 1; sysid <= 4; sysid++)
+    tracker.update(position(sysid, 0));
+  BOOST_REQUIRE(recorder.wait_for(4));
+
+  BOOST_CHECK_EQUAL(4u, tracker.evict_stale_vehicles(std::chrono::steady_clock::now() + std::chrono::hours{1}));
+  BOOST_CHECK_EQUAL(4u, monitor->removed);
+
+  tracker.update(position(1, 1));
+  BOOST_REQUIRE(recorder.wait_for(5));
+  BOOST_CHECK_EQUAL(5u, monitor->added);
+}